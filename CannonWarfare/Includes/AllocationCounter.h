@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstdint>
+
+// Counts the calls to the global operator new of the whole program, which it replaces, to check that frames don't allocate.
+// Allocations made with malloc (by raylib, ImGui or the C library) aren't counted.
+namespace AllocationCounter
+{
+	uint64_t GetCount(); // Number of allocations since the program started, on every thread.
+	uint64_t GetBytes(); // Number of bytes allocated since the program started.
+}
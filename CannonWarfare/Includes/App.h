@@ -1,10 +1,13 @@
 #pragma once
-#include "Cannon.h"
-#include "Star.h"
-#include "ParticleManager.h"
+#include "Scene.h"
+#include "RaylibCanvas.h"
+#include "Replay.h"
+#include "FrameTimeRecorder.h"
+#include "Physics/FixedTimestep.h"
+#include "Physics/JobSystem.h"
 #include <chrono>
+#include <string>
 
-constexpr size_t STAR_COUNT = 100;
 class Graphics;
 
 class App
@@ -12,33 +15,60 @@ class App
 private:
 	static inline std::chrono::system_clock::time_point startTime;
 	
-	Maths::Vector2  screenSize;
-	int             targetFPS;
-	float           targetDeltaTime;
-	Graphics*       graphics;
-	ParticleManager particleManager;
+	Maths::Vector2   screenSize;
+	int              targetFPS;
+	float            targetDeltaTime;
+	uint64_t         replaySeed; // Seeds all the random numbers of the run, so that it can be replayed.
+	Graphics*        graphics;
+	Scene            scene;
+	RaylibCanvas     canvas;
 
-	std::vector<Star> stars;
-	Cannon cannon;
-	float  groundHeight;
+	// The simulation runs at a fixed rate, independently from the rendering.
+	Physics::FixedTimestep                timestep = { 120, 8 };
+	std::chrono::steady_clock::time_point lastFrameTime;
+	int                                   lastFrameSteps = 0;
 
+	// Updates are split in jobs run by worker threads.
+	// When the simulation overlaps drawing, stars and particles are drawn from the lists built at the end of the last frame while it runs.
+	Physics::JobSystem jobs;
+	bool               overlapSimulation = true;
+
+	// Every command given to the scene is recorded with the step it was given at, with checkpoints of the scene's state.
+	ReplayRecorder recorder;
+	uint64_t       nextCheckpointStep = 0;
+
+	// Time taken by each part of the last frames. The parts of a frame are recorded at the start of the next one, with the real time between them.
+	FrameTimeRecorder frameTimes;
+	FrameTimeSample   frameSample;
+	bool              frameSampled = false;
+
+	// Heap allocations made by the last frame, which should be none once the pools and arenas have grown.
+	uint64_t frameAllocationStart = 0;
+	uint64_t lastFrameAllocations = 0;
+
+	void BuildDrawLists(const float& alpha);
+	void Draw(const float& alpha, Physics::JobCounter& simulation); // Waits for the simulation after drawing the stars and particles.
 	void DrawUi();
+	void DrawProfiler(); // Timeline of the zones of the last frame on every thread, and their totals.
+	void DrawFrameTimes(); // Percentiles of each part of the last frames, their history and their distribution.
+	void Execute(const SceneCommand& command); // Records the command if a replay is being recorded and gives it to the scene.
 
 public:
 
-	App(const Maths::Vector2& _screenSize, const int& _targetFPS);
+	App(const Maths::Vector2& _screenSize, const int& _targetFPS, const uint64_t& _replaySeed, const std::string& recordPath = ""); // Records a replay if the path isn't empty.
 	~App();
 
+	void Frame(); // Runs the simulation steps for the time elapsed since the last frame and draws.
 	void Update(const float& deltaTime);
-	void Draw();
 
 	int            GetScreenWidth    () const { return (int)screenSize.x; }
 	int            GetScreenHeight   () const { return (int)screenSize.x; }
 	Maths::Vector2 GetScreenSize     () const { return screenSize;        }
 	int            GetTargetFPS      () const { return targetFPS;         }
 	float          GetTargetDeltaTime() const { return targetDeltaTime;   }
+	uint64_t       GetReplaySeed     () const { return replaySeed;        }
 	
 	static float GetTimeSinceStart();
 	
-	ParticleManager& GetParticleManager() { return particleManager; } 
+	ParticleManager& GetParticleManager() { return scene.particleManager; } 
 };
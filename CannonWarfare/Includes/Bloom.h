@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+enum class BloomModes {
+	BLUR_PASSES, // Blurs the full resolution image several times, re-stamping the lit pixels before each pass.
+	MIP_CHAIN,   // Downsamples into a chain of half resolution levels, then upsamples them back additively.
+};
+constexpr int BLOOM_MAX_BLUR_PASSES = 16;
+constexpr int BLOOM_MAX_MIP_LEVELS  = 8;
+
+struct BloomSettings
+{
+	BloomModes mode         = BloomModes::MIP_CHAIN;
+	int        blurPasses   = 5; // Used by BLUR_PASSES.
+	int        mipLevels    = 5; // Used by MIP_CHAIN.
+	float      mipIntensity = 2; // Used by MIP_CHAIN, brightness of the glow (the average of the levels is as bright as the source).
+};
+
+// Default settings for the given screen width, so that the glow has about the same size in pixels at every resolution.
+BloomSettings GetDefaultBloomSettings(const int& screenWidth);
+
+// Number of levels the mip chain really uses: each level is half the size of the previous one and can't be smaller than 1 pixel.
+int GetBloomMipLevelCount(const BloomSettings& settings, const int& width, const int& height);
+int GetBloomMipWidth (const int& width,  const int& level); // Level 0 is half the screen size.
+int GetBloomMipHeight(const int& height, const int& level);
+
+// Fill cost of a bloom mode, counted the same way for the GPU shaders and the CPU reference.
+struct BloomCost
+{
+	int    passes        = 0; // Number of render passes.
+	size_t pixelsWritten = 0;
+	size_t texelFetches  = 0; // Texture samples done by the shaders (a bilinear sample counts as one).
+};
+BloomCost GetBloomCost(const BloomSettings& settings, const int& width, const int& height);
+
+// Opacity with which the given mip level is blended over the one above it, so that the chain ends up with the average of all levels.
+float GetBloomUpsampleOpacity(const int& levelCount, const int& level);
+
+// Floating point RGB image, stored row by row.
+struct BloomImage
+{
+	int width  = 0;
+	int height = 0;
+	std::vector<float> pixels; // 3 floats per pixel.
+
+	void Resize(const int& _width, const int& _height);
+
+	float*       GetPixel(const int& x, const int& y)       { return &pixels[((size_t)y * width + x) * 3]; }
+	const float* GetPixel(const int& x, const int& y) const { return &pixels[((size_t)y * width + x) * 3]; }
+};
+
+// Texel read by a resampling pass of the CPU reference along one axis.
+struct BloomSample
+{
+	int   index;
+	float weight;
+};
+
+// CPU reference of the bloom shaders (see Graphics.cpp and Resources/Shaders), to compare the output and cost of both modes without a GPU.
+// It does the same passes and samples as the shaders with clamped texture coordinates, in floats instead of 8 bits per channel.
+class BloomReference
+{
+private:
+	BloomImage blurImages[2];
+	BloomImage mipImages[BLOOM_MAX_MIP_LEVELS];
+	BloomImage rowsImage; // Source rows filtered to the destination width while resampling.
+	std::vector<BloomSample> columnSamples, rowSamples;
+
+	void Resample  (const BloomImage& source, BloomImage& destination, const float* taps, const float* weights, const int& tapCount, const float& scale, const float& opacity);
+	void Downsample(const BloomImage& source, BloomImage& destination);
+	void Upsample  (const BloomImage& source, BloomImage& destination, const float& intensity, const float& opacity);
+
+	void ApplyBlurPasses(const BloomImage& source, const int& passCount);
+	void ApplyMipChain  (const BloomImage& source, const int& levelCount, const float& intensity);
+
+public:
+	// Returns the glow of the source, as drawn in the blur texture before the chromatic aberration.
+	const BloomImage& Apply(const BloomImage& source, const BloomSettings& settings);
+};
+
+// Draws the lit pixels of the source over its glow, as Graphics::EndDrawing does (without the chromatic aberration).
+void ComposeBloom(const BloomImage& source, const BloomImage& bloom, BloomImage& result);
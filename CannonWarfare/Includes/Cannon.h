@@ -1,22 +1,43 @@
 #pragma once
-#include "CannonBall.h"
-#include "Physics/PhysicsConstants.h"
-#include "raylib.h"
+#include "Physics/Ballistics.h"
+#include "Physics/ProjectilePool.h"
+#include "Physics/SpatialGrid.h"
+#include "Physics/TrajectoryPredictor.h"
+#include "Physics/InverseBallistics.h"
+#include "Physics/JobSystem.h"
+#include "Maths/Transform2D.h"
+#include "Canvas.h"
+#include "FrameArena.h"
+#include "NumberLabel.h"
 #include <vector>
 
-constexpr int MAX_PROJECTILES = 500;
+constexpr int    MAX_PROJECTILES    = 100000;
+constexpr size_t PROJECTILE_RESERVE  = 1024; // Cannonballs that fit before the pool has to grow.
 
 class ParticleManager;
 
+// Values derived from the cannon's transform and properties, recomputed when they are next needed after a change.
+struct CannonDirtyFlags
+{
+	enum : uint8_t
+	{
+		DRAW_POINTS = 1 << 0, // Barrel, wick and shooting point: depend on the position, rotation, projectile radius and barrel length.
+		TRAJECTORY  = 1 << 1, // Predicted trajectory: depends on the shooting point, rotation, properties, drag and prediction mode.
+		FIRING_ANGLES = 1 << 2, // Solved firing angles: depend on the position, properties, drag and prediction mode, but not the rotation.
+	};
+};
+
 struct CannonDrawParams
 {
 	// Cannon colors.
-	Color cannonColor          = { 0, 255, 255, 255 };
-	Color trajectoryColor      = { 0, 255, 255, 255 };
-	Color landingDistanceColor = GREEN;
-	Color maxHeightColor       = RED;
+	CanvasColor cannonColor          = { 0, 255, 255, 255 };
+	CanvasColor trajectoryColor      = { 0, 255, 255, 255 };
+	CanvasColor landingDistanceColor = CANVAS_GREEN;
+	CanvasColor maxHeightColor       = CANVAS_RED;
+	CanvasColor projectileColor      = CANVAS_MAGENTA;
 	float trajectoryAlpha      = 1.f;
 	float measurementsAlpha    = 1.f;
+	float projectileTrajectoryAlpha = 1.f;
 
 	// Cannon points.
 	Maths::Vector2 centerUp;
@@ -33,41 +54,48 @@ struct CannonDrawParams
 	Maths::Vector2 wick3;
 };
 
-struct CannonProperties
-{
-	Maths::Vector2 anchorPos;
-	float mass = 2500;                           // kg
-	float barrelLength = 3.08f * PIXEL_SCALE;    // m -> px
-	float powderCharge = 3.6f;                   // kg
-	float chargeVelocity = 685.8f * PIXEL_SCALE; // m/s -> px/s
-	float projectileRadius = 30;                 // px
-	float projectileMass = 3.92f;                // kg
-};
-
 class Cannon
 {
 private:
 	ParticleManager& particleManager;
-	std::vector<CannonBall*> projectiles;
 	const float& groundHeight;
 
+	// Cannonballs and what happened to them during the last update.
+	Physics::ProjectilePool               projectiles;
+	std::vector<Physics::ProjectileEvent> projectileEvents;
+	Physics::SpatialGrid                  collisionGrid;
+
 	// Cannon properties.
 	Maths::Transform2D transform;
 	Maths::Vector2 shootingPoint;
-	CannonProperties properties;
+	Physics::CannonProperties properties;
 
 	// Predicted values for cannonballs.
-	Maths::Vector2 landingVelocity, landingPosition, controlPoint, highestPoint;
-	float airTime = 0, maxHeight = 0, landingDistance = 0;
-	std::vector<::Vector2> posPredicted; // Used to draw trajectory with drag.
+	Physics::TrajectoryPredictor  trajectoryPredictor; // Used for trajectories with drag.
+	Physics::TrajectoryPrediction prediction;
+	std::vector<Maths::Vector2>   posPredicted;        // Used to draw trajectory with drag.
+	uint8_t dirtyFlags        = CannonDirtyFlags::DRAW_POINTS | CannonDirtyFlags::TRAJECTORY | CannonDirtyFlags::FIRING_ANGLES;
+	bool    predictedWithDrag = false; // Value of applyDrag when the trajectory was last predicted.
+	size_t  predictionCount   = 0;
+
+	// Angles solved for the last target distance. The solver has its own predictor so that it keeps the cache cell of the drawn trajectory.
+	Physics::TrajectoryPredictor firingPredictor;
+	Physics::FiringAngles        firingAngles;
+	float firingTargetDistance = -1;
+	float firingGroundHeight   = 0;
+	bool  solvedWithDrag       = false;
 	
 	CannonDrawParams drawParams;
+	std::vector<NumberLabel> projectileLabels; // Air time of each cannonball, by index.
+	NumberLabel airTimeLabel, landingDistanceLabel, maxHeightLabel;
+	float simulationTime = 0; // Simulated seconds since the cannon was created, drives the automatic rotation.
 
 public:
 	bool automaticRotation = true;
 	bool applyRecoil       = false;
 	bool applyDrag         = false;
 	bool applyCollisions   = false;
+	bool useSpatialGrid    = true; // Use the broad phase for collisions instead of testing every pair.
 	bool showTrajectory    = true;
 	bool showMeasurements  = true;
 	bool showProjectileTrajectories = true;
@@ -75,29 +103,41 @@ public:
 private:
 	void  UpdateDrawPoints();
 	void  UpdateTrajectory();
-	void  UpdateCollisions(CannonBall* cannonBall) const;
+	void  RefreshDrawPoints(); // Updates the draw points if they are dirty.
+	void  RefreshTrajectory(); // Updates the draw points, then the trajectory if it is dirty.
+	Maths::Vector2 GetShootingPoint(const float& rotation) const; // Position of the barrel's tip at the given rotation.
 	void  ApplyRecoil();
-	float ComputeMuzzleVelocity();
+	void  PlayProjectileParticles();
+
+	void  DrawProjectiles(Canvas& canvas, FrameArena& arena, const float& alpha);
+	void  DrawProjectileTrajectories(Canvas& canvas) const;
+	CanvasColor GetProjectileColor(const size_t& i) const;
 
 public:
 	Cannon(ParticleManager& _particleManager, const float& _groundHeight);
-	~Cannon();
 
-	void Update(const float& deltaTime);
-	void Draw() const;
-	void DrawTrajectories();
-	void DrawMeasurements() const;
+	void Update(const float& deltaTime, Physics::JobSystem& jobs); // The jobs step the projectiles in parallel.
+	// Alpha interpolates the cannonballs between their positions before and after the last update. Label texts are formatted in the arena.
+	void Draw(Canvas& canvas, FrameArena& arena, const float& alpha = 1);
+	void DrawTrajectories(Canvas& canvas);
+	void DrawMeasurements(Canvas& canvas, FrameArena& arena);
 
 	void Shoot();
-	void ClearProjectiles() const;
-
-	void SetAnchorPos(const Maths::Vector2&  pos) { properties.anchorPos          = pos;  UpdateTrajectory(); UpdateDrawPoints(); }
-	void SetPosition (const Maths::Vector2&  pos) { transform.position            = pos;  UpdateTrajectory(); UpdateDrawPoints(); }
-	void SetRotation (const float&           rot) { transform.rotation            = rot;  UpdateTrajectory(); UpdateDrawPoints(); }
-	void SetProjectileRadius  (const float& rad ) { properties.projectileRadius   = rad;  UpdateTrajectory(); UpdateDrawPoints(); }
-	void SetProjectileMass    (const float& mass) { properties.projectileMass     = mass; UpdateTrajectory(); }
-	void SetBarrelLength      (const float& len ) { properties.barrelLength       = len;  UpdateTrajectory(); UpdateDrawPoints(); }
-	void SetPowderCharge      (const float& mass) { properties.powderCharge       = mass; UpdateTrajectory(); }
+	void ClearProjectiles();
+
+	// Finds the low and high rotations that make cannonballs land at the given horizontal distance from the cannon (with drag if it is applied).
+	// The angles are only solved again when the distance or what they depend on changed.
+	const Physics::FiringAngles& GetFiringAngles(const float& targetDistance);
+
+	// Setters only mark the values that depend on what they change, so that many changes in a frame cost one update.
+	void SetAnchorPos(const Maths::Vector2&  pos) { properties.anchorPos          = pos;  } // Only used to pull the cannon back after recoil.
+	void SetPosition (const Maths::Vector2&  pos) { transform.position            = pos;  dirtyFlags |= CannonDirtyFlags::DRAW_POINTS | CannonDirtyFlags::TRAJECTORY | CannonDirtyFlags::FIRING_ANGLES; }
+	void SetRotation (const float&           rot) { transform.rotation            = rot;  dirtyFlags |= CannonDirtyFlags::DRAW_POINTS | CannonDirtyFlags::TRAJECTORY; }
+	void SetProjectileRadius  (const float& rad ) { properties.projectileRadius   = rad;  dirtyFlags |= CannonDirtyFlags::DRAW_POINTS | CannonDirtyFlags::TRAJECTORY | CannonDirtyFlags::FIRING_ANGLES; }
+	void SetProjectileMass    (const float& mass) { properties.projectileMass     = mass; dirtyFlags |= CannonDirtyFlags::TRAJECTORY | CannonDirtyFlags::FIRING_ANGLES; }
+	void SetBarrelLength      (const float& len ) { properties.barrelLength       = len;  dirtyFlags |= CannonDirtyFlags::DRAW_POINTS | CannonDirtyFlags::TRAJECTORY | CannonDirtyFlags::FIRING_ANGLES; }
+	void SetPowderCharge      (const float& mass) { properties.powderCharge       = mass; dirtyFlags |= CannonDirtyFlags::TRAJECTORY | CannonDirtyFlags::FIRING_ANGLES; }
+	void SetDragPredictionMode(const Physics::DragPredictionMode& mode) { trajectoryPredictor.mode = firingPredictor.mode = mode; dirtyFlags |= CannonDirtyFlags::TRAJECTORY | CannonDirtyFlags::FIRING_ANGLES; }
 	
 	Maths::Vector2 GetAnchorPos()          const { return properties.anchorPos;          }
 	Maths::Vector2 GetPosition()           const { return transform.position;            }
@@ -107,7 +147,14 @@ public:
 	float          GetBarrelLength()       const { return properties.barrelLength;       }
 	float          GetPowderCharge()       const { return properties.powderCharge;       }
 
-	float GetAirTime()         const { return airTime;         }
-	float GetMaxHeight()       const { return maxHeight;       }
-	float GetLandingDistance() const { return landingDistance; }
+	const Physics::TrajectoryPredictor& GetTrajectoryPredictor() const { return trajectoryPredictor; }
+
+	const Physics::ProjectilePool& GetProjectiles() const { return projectiles; }
+
+	// The trajectory is predicted first if it is dirty.
+	float GetAirTime()         { RefreshTrajectory(); return prediction.airTime;         }
+	float GetMaxHeight()       { RefreshTrajectory(); return prediction.maxHeight;       }
+	float GetLandingDistance() { RefreshTrajectory(); return prediction.landingDistance; }
+
+	size_t GetPredictionCount() const { return predictionCount; } // Number of trajectories predicted since the cannon was created.
 };
\ No newline at end of file
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Vector2.h"
+#include <cstddef>
+#include <cstdint>
+
+class ParticleGeometry;
+
+// Color with 8 bits per channel, laid out like raylib's Color.
+struct CanvasColor
+{
+	uint8_t r, g, b, a;
+};
+
+// Same values as raylib's colors of the same name.
+constexpr CanvasColor CANVAS_BLACK   = {   0,   0,   0, 255 };
+constexpr CanvasColor CANVAS_WHITE   = { 255, 255, 255, 255 };
+constexpr CanvasColor CANVAS_ORANGE  = { 255, 161,   0, 255 };
+constexpr CanvasColor CANVAS_GREEN   = {   0, 228,  48, 255 };
+constexpr CanvasColor CANVAS_RED     = { 230,  41,  55, 255 };
+constexpr CanvasColor CANVAS_MAGENTA = { 255,   0, 255, 255 };
+
+// Longest label text, terminating null included.
+constexpr size_t LABEL_CAPACITY = 24;
+
+// Text drawn with others in one batch. The text must stay valid until the batch is drawn.
+struct CanvasLabel
+{
+	const char*    text;
+	Maths::Vector2 position;
+	int            fontSize;
+	CanvasColor    color;
+};
+
+// Something the scene can be drawn on, with the same shapes as raylib's.
+// Angles are in degrees, and circle sectors start from the bottom and go counter-clockwise like in raylib 4.2.
+// Everything is alpha blended over what was drawn before.
+class Canvas
+{
+public:
+	virtual ~Canvas() = default;
+
+	virtual void DrawLine             (const Maths::Vector2& start, const Maths::Vector2& end, const float& thickness, const CanvasColor& color) = 0;
+	virtual void DrawLineStrip        (const Maths::Vector2* points, const size_t& count, const float& thickness, const CanvasColor& color) { for (size_t i = 1; i < count; i++) DrawLine(points[i-1], points[i], thickness, color); }
+	virtual void DrawBezierQuad       (const Maths::Vector2& start, const Maths::Vector2& end, const Maths::Vector2& control, const float& thickness, const CanvasColor& color) = 0;
+	virtual void DrawBezierCubic      (const Maths::Vector2& start, const Maths::Vector2& end, const Maths::Vector2& startControl, const Maths::Vector2& endControl, const float& thickness, const CanvasColor& color) = 0;
+	virtual void DrawTriangle         (const Maths::Vector2& a, const Maths::Vector2& b, const Maths::Vector2& c, const CanvasColor& color) = 0;
+	virtual void DrawRectangle        (const Maths::Vector2& position, const Maths::Vector2& size, const CanvasColor& color) = 0;
+	virtual void DrawCircle           (const Maths::Vector2& center, const float& radius, const CanvasColor& color) = 0;
+	virtual void DrawCircleLines      (const Maths::Vector2& center, const float& radius, const CanvasColor& color) = 0;
+	virtual void DrawCircleSector     (const Maths::Vector2& center, const float& radius, const float& startAngle, const float& endAngle, const int& segments, const CanvasColor& color) = 0;
+	virtual void DrawCircleSectorLines(const Maths::Vector2& center, const float& radius, const float& startAngle, const float& endAngle, const int& segments, const CanvasColor& color) = 0;
+	virtual void DrawPoly             (const Maths::Vector2& center, const int& sides, const float& radius, const float& rotation, const CanvasColor& color) = 0;
+	virtual void DrawText             (const char* text, const Maths::Vector2& position, const int& fontSize, const CanvasColor& color) = 0;
+	virtual int  MeasureText          (const char* text, const int& fontSize) const = 0; // Width of the text in pixels.
+	virtual void DrawLabels           (const CanvasLabel* labels, const size_t& count) { for (size_t i = 0; i < count; i++) DrawText(labels[i].text, labels[i].position, labels[i].fontSize, labels[i].color); }
+	virtual void DrawParticles        (const ParticleGeometry& geometry) = 0;
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+// Linear allocator for data that only lives until the end of a frame (label texts, scratch arrays).
+// Allocating moves a cursor forward in a buffer, and Reset() frees everything at once when the next frame starts.
+// When the buffer is full, allocations go to overflow blocks, and the next Reset() grows the buffer to fit them, so that steady frames don't allocate.
+class FrameArena
+{
+private:
+	std::unique_ptr<std::max_align_t[]> buffer;
+	size_t capacity = 0; // In bytes.
+	size_t used     = 0;
+	size_t highWater = 0; // Most bytes used in a frame since the arena was created.
+
+	std::vector<std::unique_ptr<std::max_align_t[]>> overflow;
+	size_t overflowSize = 0;
+
+public:
+	FrameArena(const size_t& _capacity = 64 * 1024);
+	FrameArena(const FrameArena&) = delete;
+	FrameArena& operator=(const FrameArena&) = delete;
+
+	// Alignment must be a power of two, at most alignof(std::max_align_t).
+	void* Allocate(const size_t& size, const size_t& alignment = alignof(std::max_align_t));
+
+	// Uninitialized array. Nothing is destroyed on reset, so only trivially destructible types are allowed.
+	template<typename T>
+	T* Allocate(const size_t& count)
+	{
+		static_assert(std::is_trivially_destructible_v<T>, "Frame arena objects aren't destroyed");
+		return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+	}
+
+	// Formats a string like printf into the arena.
+	const char* Format(const char* format, ...);
+
+	// Frees everything allocated since the last reset.
+	void Reset();
+
+	size_t GetUsed     () const { return used + overflowSize; }
+	size_t GetCapacity () const { return capacity;  }
+	size_t GetHighWater() const { return highWater; }
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <array>
+#include <string>
+#include <vector>
+
+// Parts of a frame that are timed. The total is the real time between two frames, so it also contains the wait for the target frame rate.
+enum class FrameParts {
+	TOTAL,
+	UPDATE,       // Simulation steps.
+	DRAW,         // Draw lists, stars, ground, cannon, cannonballs and particles.
+	POST_PROCESS, // Glow and screen composition. On the GPU, only the time to submit the passes.
+	UI,
+	COUNT,
+};
+constexpr size_t FRAME_PART_COUNT = (size_t)FrameParts::COUNT;
+
+const char* GetFramePartName(const FrameParts& part);
+
+// Duration of each part of a frame, in milliseconds.
+struct FrameTimeSample
+{
+	float times[FRAME_PART_COUNT] = {};
+
+	float&       operator[](const FrameParts& part)       { return times[(size_t)part]; }
+	const float& operator[](const FrameParts& part) const { return times[(size_t)part]; }
+};
+
+struct FrameTimePercentiles
+{
+	float p50 = 0, p95 = 0, p99 = 0, max = 0;
+};
+
+// Number of frames kept by default: 10 seconds at 60 fps.
+constexpr size_t FRAME_TIME_HISTORY = 600;
+
+// Keeps the times of the last frames to find the spikes that an average frame rate hides.
+class FrameTimeRecorder
+{
+private:
+	std::vector<FrameTimeSample> samples; // Ring buffer, the next sample goes to frameCount % capacity.
+	size_t capacity;
+	size_t frameCount = 0;
+	mutable std::vector<float> sorted;
+
+public:
+	FrameTimeRecorder(const size_t& _capacity = FRAME_TIME_HISTORY);
+
+	void Record(const FrameTimeSample& sample);
+	void Clear() { frameCount = 0; }
+
+	size_t GetSize      () const { return frameCount < capacity ? frameCount : capacity; } // Number of frames kept.
+	size_t GetCapacity  () const { return capacity;   }
+	size_t GetFrameCount() const { return frameCount; } // Number of frames ever recorded.
+
+	const FrameTimeSample& GetSample(const size_t& index) const; // From the oldest frame kept (0) to the last one (GetSize() - 1).
+	const FrameTimeSample& GetLast() const { return GetSample(GetSize() - 1); } // Only when a frame was recorded.
+
+	// Nearest-rank percentiles of a part over the frames kept.
+	FrameTimePercentiles GetPercentiles(const FrameParts& part) const;
+
+	// Times of a part from the oldest frame kept to the last one.
+	void GetHistory(const FrameParts& part, std::vector<float>& times) const;
+
+	// Number of frames in each of the bins of width maxTime / bins.size() from 0 to maxTime. Longer frames go to the last bin.
+	void GetHistogram(const FrameParts& part, const float& maxTime, std::vector<float>& bins) const;
+
+	// One line per frame kept with the time of each part. Returns false if the file can't be written.
+	bool WriteCsv(const std::string& path) const;
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "PostProcess.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+
+enum class FrameFormats {
+	RAW, // RGBA bytes of every frame one after the other, without header.
+	PNG, // One numbered image per frame.
+	Y4M, // YUV4MPEG2 stream with 4:2:0 chroma, that video encoders can read from a pipe.
+};
+
+const char*  GetFrameFormatName(const FrameFormats& format);
+FrameFormats GetFrameFormat    (const std::string& path); // Guessed from the extension: ".png", ".y4m" or "-" (stdout), anything else is raw.
+
+// Writes frames to disk on a background thread, so that the next frame is drawn while the last one is encoded.
+// There are two frames: the one that is drawn and the one that is written. Submit swaps them once the last write is done.
+class FrameWriter
+{
+private:
+	FrameFormats format = FrameFormats::RAW;
+	std::string  path;   // For PNG sequences, contains a %d conversion for the frame numbers, optionally zero padded (e.g. "frames/%05d.png").
+	std::string  framePrefix, frameSuffix; // Parts of a PNG sequence's path around the frame number, with "%%" unescaped.
+	int          frameDigits  = 0;         // Minimum number of digits of the frame numbers.
+	bool         frameZeroPad = false;     // Pad the frame numbers with zeros instead of spaces.
+	FILE*        stream = nullptr;
+	int          fps    = 60;
+
+	FrameImage frames[2];
+	int        drawnFrame = 0;
+	std::vector<uint8_t> encodeBuffer; // Opaque copy of the frame being written, or its Y4M planes.
+
+	std::thread             thread;
+	std::mutex              mutex;
+	std::condition_variable condition;
+	bool writing  = false; // The frame that isn't drawn is being written.
+	bool stopping = false;
+	bool failed   = false;
+	std::atomic<size_t> writtenCount = 0;
+
+	void Run();
+	bool Write(const FrameImage& frame, const size_t& index);
+
+public:
+	FrameWriter() = default;
+	FrameWriter(const FrameWriter&) = delete;
+	FrameWriter& operator=(const FrameWriter&) = delete;
+	~FrameWriter() { Close(); }
+
+	// Opens the output and starts the writer thread. Returns false if the output can't be opened.
+	bool Open(const std::string& _path, const FrameFormats& _format, const int& width, const int& height, const int& _fps);
+
+	// Frame to draw next.
+	FrameImage& GetFrame() { return frames[drawnFrame]; }
+
+	// Hands the drawn frame to the writer thread, after waiting for the last one to be written.
+	// Returns false if a write failed, in which case the following frames are dropped.
+	bool Submit();
+
+	// Waits for the last frame to be written and closes the output. Returns false if a write failed.
+	bool Close();
+
+	size_t GetWrittenCount() const { return writtenCount; }
+};
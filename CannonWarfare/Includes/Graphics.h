@@ -1,5 +1,6 @@
 ﻿#pragma once
 #include "Vector2.h"
+#include "Bloom.h"
 #include "raylib.h"
 
 class Graphics
@@ -14,22 +15,33 @@ private:
     Shader gaussianBlurShader = {};
     Shader nonBlackMaskShader = {};
     Shader chromaticAberrationShader = {};
-    int blurDirLocation = 0;
-    int bloomIntensity  = 5;
+    Shader bloomDownsampleShader = {};
+    Shader bloomUpsampleShader   = {};
+    int blurDirLocation            = 0;
+    int downsampleTexelSizeLocation = 0;
+    int upsampleTexelSizeLocation   = 0;
+    int upsampleIntensityLocation   = 0;
 
     // Render textures.
     RenderTexture2D renderTexture = {};
     RenderTexture2D blurTextures[2] = {{},{}};
+    RenderTexture2D mipTextures[BLOOM_MAX_MIP_LEVELS] = {}; // Each one is half the size of the previous one, starting at half the screen size.
+    int mipTextureCount = 0;
 
 public:
     bool mouseCursorHidden = false;
+    BloomSettings bloom;
 
 private:
-    void ApplyBlur() const;
+    void ApplyBlur() const; // Draws the glow of the render texture on the first blurring texture.
+    void ApplyBlurPasses() const;
+    void ApplyMipChain() const;
 
 public:
     Graphics(const Maths::Vector2& _screenSize);
+    ~Graphics();
 
     void BeginDrawing() const;
-    void EndDrawing() const;
+    void PostProcess() const; // Draws the render texture and its glow on the screen.
+    void EndDrawing() const;  // Shows the frame, after waiting for the target frame rate.
 };
\ No newline at end of file
@@ -1,58 +1,92 @@
 #pragma once
+#include "MathConstants.h"
+#include <cassert>
+#include <cmath>
 
+// Everything is defined inline so that the physics loops don't go through function calls, and constexpr when the standard library allows it.
 namespace Maths
 {
     // Rounds the given value to the nearest int.
-    int roundInt(const float& val);
+    [[nodiscard]] inline int roundInt(const float& val) { return (int)std::round(val); }
 
     // Rounds down the given value.
-    int floorInt(const float& val);
+    [[nodiscard]] inline int floorInt(const float& val) { return (int)std::floor(val); }
 
     // Rounds up the given value.
-    int ceilInt(const float& val);
+    [[nodiscard]] inline int ceilInt(const float& val) { return (int)std::ceil(val); }
 
     // Returns the sqare power of the given value.
-    float sqpow(const float& val);
+    [[nodiscard]] constexpr float sqpow(const float& val) { return val * val; }
 
     // Returns 1 if the given value is positive or null, and -1 if it is negative.
-    int signof(const float& val);
+    [[nodiscard]] constexpr int signof(const float& val) { return val < 0 ? -1 : 1; }
 
     // Converts the given angle from degrees to radians.
-    float degToRad(const float& deg);
+    [[nodiscard]] constexpr float degToRad(const float& deg) { return deg * (PI / 180.0f); }
 
     // Converts the given angle from radians to degrees.
-    float radToDeg(const float& rad);
+    [[nodiscard]] constexpr float radToDeg(const float& rad) { return rad * (180.0f / PI); }
 
     // Clamps the given value to be superior or equal to the minimum value and inferior or equal to the maximum value.
-    float clamp(float val, const float& min, const float& max);
+    [[nodiscard]] constexpr float clamp(float val, const float& min, const float& max)
+    {
+        assert(min <= max/*, "Unable to clamp: max < min."*/);
+        if (val < min) val = min;
+        if (val > max) val = max;
+        return val;
+    }
 
     // Clamps the given value to be inferior or equal to the maximum value.
-    float clampUnder(float val, const float& max);
+    [[nodiscard]] constexpr float clampUnder(float val, const float& max) { if (val > max) val = max; return val; }
 
     // Clamps the given value to be superior or equal to the minimum value.
-    float clampAbove(float val, const float& min);
+    [[nodiscard]] constexpr float clampAbove(float val, const float& min) { if (val < min) val = min; return val; }
 
     // Returns the minimum value between the two parameters.
-    float min(const float& val1, const float & val2);
+    [[nodiscard]] constexpr float min(const float& val1, const float& val2) { return (val1 <= val2 ? val1 : val2); }
 
     // Returns the maximum value between the two parameters.
-    float max(const float& val1, const float & val2);
+    [[nodiscard]] constexpr float max(const float& val1, const float& val2) { return (val1 >= val2 ? val1 : val2); }
 
     // Compute linear interpolation between start and dest for the parameter val (if 0 <= val <= 1: start <= return <= end).
-    float lerp(const float& start, const float& dest, const float& val);
+    [[nodiscard]] constexpr float lerp(const float& start, const float& dest, const float& val)
+    {
+        return start + val * (dest - start);
+    }
 
     // Compute the linear interpolation factor that returns val when lerping between start and end.
-    float getLerp(const float& start, const float& dest, const float& val);
+    [[nodiscard]] constexpr float getLerp(const float& start, const float& dest, const float& val)
+    {
+        if (dest - start != 0)
+            return (val - start) / (dest - start);
+        return 0;
+    }
 
     // Remaps the given value from one range to another.
-    float remap(const float& val, const float& inputStart, const float& inputEnd, const float& outputStart, const float& outputEnd);
+    [[nodiscard]] constexpr float remap(const float& val, const float& inputStart, const float& inputEnd, const float& outputStart, const float& outputEnd)
+    {
+        return outputStart + (val - inputStart) * (outputEnd - outputStart) / (inputEnd - inputStart);
+    }
 
     // Returns true if the given number is a power of 2.
-    bool isPowerOf2(const int& val);
+    [[nodiscard]] constexpr bool isPowerOf2(const int& val)
+    {
+        return val > 0 && (val & (val - 1)) == 0;
+    }
 
     // Returns the closest power of 2 that is inferior or equal to val.
-    int getPowerOf2Under(const int& val);
+    [[nodiscard]] constexpr int getPowerOf2Under(const int& val)
+    {
+        int power = 1;
+        while (power <= val / 2)
+            power *= 2;
+        return power;
+    }
 
     // Returns the closest power of 2 that is superior or equal to val.
-    int getPowerOf2Above(const int& val);
-}
\ No newline at end of file
+    [[nodiscard]] constexpr int getPowerOf2Above(const int& val)
+    {
+        const int power = getPowerOf2Under(val);
+        return power < val ? power * 2 : power;
+    }
+}
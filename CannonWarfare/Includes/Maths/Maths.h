@@ -9,5 +9,6 @@
 #include "AngleAxis.h"
 #include "Quaternion.h"
 #include "Matrix.h"
+#include "Random.h"
 #include "Transform.h"
 #include "Vertex.h"
@@ -145,6 +145,29 @@ namespace Maths
         Quaternion  ToQuaternion() const;                     // Conversion to quaternion (matrix must be 3x3 or 4x4 rotation only).
         std::string ToString(const int& precision = 2) const; // Returns matrix contents as string.
     };
+
+    // Scalar kernels of the generic template, that the member functions call.
+    // The Mat2, Mat3 and Mat4 specialisations below don't use them, they are kept to check the specialisations.
+    namespace MatrixGeneric
+    {
+        template<int R, int C, int R2, int C2>
+        Matrix<(R > R2 ? R : R2), (C > C2 ? C : C2)> Multiply(const Matrix<R, C>& a, const Matrix<R2, C2>& b);
+
+        template<int R, int C> Matrix<C, R> Transpose(const Matrix<R, C>& matrix);
+        template<int R, int C> Mat2         Inv2     (const Matrix<R, C>& matrix);
+        template<int R, int C> Mat3         Inv3     (const Matrix<R, C>& matrix);
+        template<int R, int C> Mat4         Inv4     (const Matrix<R, C>& matrix);
+    }
+
+    // SIMD kernels for the square matrix operations that gain from them, defined inline at the end of Matrix.inl.
+    // Mat3 products and the smaller transpositions are left to the generic template, which is as fast once compiled.
+    // Products and transpositions give the same results as the generic template, inverses use other formulas and differ by rounding.
+    template<> template<> inline Mat2 Mat2::operator*<2, 2>(const Mat2& matrix) const;
+    template<> template<> inline Mat4 Mat4::operator*<4, 4>(const Mat4& matrix) const;
+    template<> inline Mat4 Mat4::GetTransposed() const;
+    template<> inline Mat2 Mat2::Inv2() const;
+    template<> inline Mat3 Mat3::Inv3() const;
+    template<> inline Mat4 Mat4::Inv4() const;
 }
 
 #include "Matrix.inl"
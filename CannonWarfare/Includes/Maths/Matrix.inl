@@ -1,4 +1,5 @@
 #include <cassert>
+#include <cmath>
 #include <sstream>
 #include <iostream>
 
@@ -264,19 +265,7 @@ Maths::Matrix<R, C> Maths::Matrix<R, C>::operator*(const float& val) const
 template<int R, int C> template<int R2, int C2>
 Maths::Matrix<(R > R2 ? R : R2), (C > C2 ? C : C2)> Maths::Matrix<R, C>::operator*(const Matrix<R2, C2>& matrix) const
 {
-    assert(C == R2/*, "Given matrices cannot be multiplied."*/);
-
-    Matrix<(R > R2 ? R : R2), (C > C2 ? C : C2)> result;
-    for (int i = 0; i < R; i++)
-    {
-        for (int j = 0; j < C2; j++)
-        {
-            result[i][j] = 0;
-            for (int k = 0; k < R2; k++)
-                result[i][j] += m[i][k] * matrix[k][j];
-        }
-    }
-    return result;
+    return MatrixGeneric::Multiply(*this, matrix);
 }
 
 // Matrix division by a scalar.
@@ -419,46 +408,9 @@ float Maths::Matrix<R, C>::Det4() const
 }
 
 // Inverses.
-template<int R, int C>
-Maths::Mat2 Maths::Matrix<R, C>::Inv2() const
-{
-    Mat2 val(m[1][1], -m[0][1], -m[1][0], m[0][0]);
-    return val / val.Det2();
-}
-
-template<int R, int C>
-Maths::Mat3 Maths::Matrix<R, C>::Inv3() const
-{
-    Mat4 val(m[0][0], m[0][1], m[0][2], 0,
-             m[1][0], m[1][1], m[1][2], 0,
-             m[2][0], m[2][1], m[2][2], 0,
-             0, 0, 0, 1);
-    
-    val = val.Inv4();
-    
-    Mat3 result(val.m[0][0], val.m[0][1], val.m[0][2],
-                val.m[1][0], val.m[1][1], val.m[1][2],
-                val.m[2][0], val.m[2][1], val.m[2][2]);
-    
-    return result;
-}
-
-template<int R, int C>
-Maths::Mat4 Maths::Matrix<R, C>::Inv4() const
-{
-    const Mat2 a(m[0][0], m[0][1], m[1][0], m[1][1]);
-    const Mat2 b(m[0][2], m[0][3], m[1][2], m[1][3]);
-    const Mat2 c(m[2][0], m[2][1], m[3][0], m[3][1]);
-    const Mat2 d(m[2][2], m[2][3], m[3][2], m[3][3]);
-
-    Mat4 result =
-    {
-        (a - b * d.Inv2() * c).Inv2(), -(a - b * d.Inv2() * c).Inv2() * b * d.Inv2(),
-        -(d - c * a.Inv2() * b).Inv2() * c * a.Inv2(), (d - c * a.Inv2() * b).Inv2()
-    };
-
-    return result;
-}
+template<int R, int C> Maths::Mat2 Maths::Matrix<R, C>::Inv2() const { return MatrixGeneric::Inv2(*this); }
+template<int R, int C> Maths::Mat3 Maths::Matrix<R, C>::Inv3() const { return MatrixGeneric::Inv3(*this); }
+template<int R, int C> Maths::Mat4 Maths::Matrix<R, C>::Inv4() const { return MatrixGeneric::Inv4(*this); }
 
 // Transposition.
 template <int R, int C>
@@ -470,11 +422,7 @@ void Maths::Matrix<R, C>::Transpose()
 template<int R, int C>
 Maths::Matrix<R, C> Maths::Matrix<R, C>::GetTransposed() const
 {
-    Matrix<C, R> result;
-    for (int i = 0; i < R; i++)
-        for (int j = 0; j < C; j++)
-            result[j][i] = m[i][j];
-    return result;
+    return MatrixGeneric::Transpose(*this);
 }
 
 
@@ -521,3 +469,283 @@ std::string Maths::Matrix<R, C>::ToString(const int& precision) const
     }
     return output.str();
 }
+
+
+// ---------- GENERIC KERNELS ---------- //
+
+template<int R, int C, int R2, int C2>
+Maths::Matrix<(R > R2 ? R : R2), (C > C2 ? C : C2)> Maths::MatrixGeneric::Multiply(const Matrix<R, C>& a, const Matrix<R2, C2>& b)
+{
+    assert(C == R2/*, "Given matrices cannot be multiplied."*/);
+
+    Matrix<(R > R2 ? R : R2), (C > C2 ? C : C2)> result;
+    for (int i = 0; i < R; i++)
+    {
+        for (int j = 0; j < C2; j++)
+        {
+            result[i][j] = 0;
+            for (int k = 0; k < R2; k++)
+                result[i][j] += a[i][k] * b[k][j];
+        }
+    }
+    return result;
+}
+
+template<int R, int C>
+Maths::Matrix<C, R> Maths::MatrixGeneric::Transpose(const Matrix<R, C>& matrix)
+{
+    Matrix<C, R> result;
+    for (int i = 0; i < R; i++)
+        for (int j = 0; j < C; j++)
+            result[j][i] = matrix[i][j];
+    return result;
+}
+
+template<int R, int C>
+Maths::Mat2 Maths::MatrixGeneric::Inv2(const Matrix<R, C>& matrix)
+{
+    Mat2 val(matrix[1][1], -matrix[0][1], -matrix[1][0], matrix[0][0]);
+    return val / val.Det2();
+}
+
+template<int R, int C>
+Maths::Mat3 Maths::MatrixGeneric::Inv3(const Matrix<R, C>& matrix)
+{
+    Mat4 val(matrix[0][0], matrix[0][1], matrix[0][2], 0,
+             matrix[1][0], matrix[1][1], matrix[1][2], 0,
+             matrix[2][0], matrix[2][1], matrix[2][2], 0,
+             0, 0, 0, 1);
+    
+    val = Inv4(val);
+    
+    Mat3 result(val.m[0][0], val.m[0][1], val.m[0][2],
+                val.m[1][0], val.m[1][1], val.m[1][2],
+                val.m[2][0], val.m[2][1], val.m[2][2]);
+    
+    return result;
+}
+
+// Block inversion, with the generic 2x2 products and inverses.
+template<int R, int C>
+Maths::Mat4 Maths::MatrixGeneric::Inv4(const Matrix<R, C>& matrix)
+{
+    const Mat2 a(matrix[0][0], matrix[0][1], matrix[1][0], matrix[1][1]);
+    const Mat2 b(matrix[0][2], matrix[0][3], matrix[1][2], matrix[1][3]);
+    const Mat2 c(matrix[2][0], matrix[2][1], matrix[3][0], matrix[3][1]);
+    const Mat2 d(matrix[2][2], matrix[2][3], matrix[3][2], matrix[3][3]);
+    const Mat2 aInv = Inv2(a), dInv = Inv2(d);
+
+    const Mat2 x = Inv2(a - Multiply(Multiply(b, dInv), c));
+    const Mat2 w = Inv2(d - Multiply(Multiply(c, aInv), b));
+    Mat4 result =
+    {
+        x, Multiply(Multiply(-x, b), dInv),
+        Multiply(Multiply(-w, c), aInv), w
+    };
+
+    return result;
+}
+
+
+// ---------------------------------------- SIMD SPECIALISATIONS ----------------------------------------
+
+// The square matrices keep the same operation order as the generic kernels so that products and transpositions are bit-exact.
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <xmmintrin.h>
+
+namespace Maths::MatrixSSE
+{
+    // Mat3 rows have 3 floats: they are loaded with a null 4th lane, and only their first 3 lanes are stored.
+    inline __m128 LoadRow3(const float* row)
+    {
+        return _mm_movelh_ps(_mm_loadl_pi(_mm_setzero_ps(), (const __m64*)row), _mm_load_ss(row + 2));
+    }
+
+    inline void StoreRow3(float* row, const __m128& value)
+    {
+        _mm_storel_pi((__m64*)row, value);
+        _mm_store_ss(row + 2, _mm_movehl_ps(value, value));
+    }
+
+    // Broadcasts the given lane of a vector to all 4 lanes.
+    template<int lane>
+    inline __m128 Splat(const __m128& vec)
+    {
+        return _mm_shuffle_ps(vec, vec, _MM_SHUFFLE(lane, lane, lane, lane));
+    }
+
+    // 2x2 matrices held in a register as (a00 a01 a10 a11). The adjugate of A is written A#.
+    inline __m128 Mat2Mul(const __m128& a, const __m128& b) // A * B.
+    {
+        return _mm_add_ps(_mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 3, 0))),
+                          _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+    }
+
+    inline __m128 Mat2AdjMul(const __m128& a, const __m128& b) // A# * B.
+    {
+        return _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 3, 3)), b),
+                          _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 1, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 0, 3, 2))));
+    }
+
+    inline __m128 Mat2MulAdj(const __m128& a, const __m128& b) // A * B#.
+    {
+        return _mm_sub_ps(_mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 3, 0, 3))),
+                          _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+    }
+}
+
+
+// ---------- PRODUCTS ---------- //
+
+// Each row of the product is the sum of the other matrix's rows, weighted by the row of this one.
+// The rows are added in the same order as the generic template so that the results are the same.
+
+template<> template<>
+inline Maths::Mat2 Maths::Mat2::operator*<2, 2>(const Mat2& matrix) const
+{
+    // Both 2x2 matrices fit in a register: (a00 a01 a10 a11).
+    const __m128 a = _mm_loadu_ps(&m[0][0]);
+    const __m128 b = _mm_loadu_ps(&matrix.m[0][0]);
+    const __m128 result = _mm_add_ps(_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 0, 0)), _mm_movelh_ps(b, b)),
+                                     _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 1, 1)), _mm_movehl_ps(b, b)));
+    Mat2 product(false);
+    _mm_storeu_ps(&product.m[0][0], result);
+    return product;
+}
+
+template<> template<>
+inline Maths::Mat4 Maths::Mat4::operator*<4, 4>(const Mat4& matrix) const
+{
+    const __m128 b0 = _mm_loadu_ps(matrix.m[0]);
+    const __m128 b1 = _mm_loadu_ps(matrix.m[1]);
+    const __m128 b2 = _mm_loadu_ps(matrix.m[2]);
+    const __m128 b3 = _mm_loadu_ps(matrix.m[3]);
+
+    Mat4 product(false);
+    for (int i = 0; i < 4; i++)
+    {
+        const __m128 a = _mm_loadu_ps(m[i]);
+        __m128 row = _mm_mul_ps(MatrixSSE::Splat<0>(a), b0);
+        row = _mm_add_ps(row, _mm_mul_ps(MatrixSSE::Splat<1>(a), b1));
+        row = _mm_add_ps(row, _mm_mul_ps(MatrixSSE::Splat<2>(a), b2));
+        row = _mm_add_ps(row, _mm_mul_ps(MatrixSSE::Splat<3>(a), b3));
+        _mm_storeu_ps(product.m[i], row);
+    }
+    return product;
+}
+
+
+// ---------- TRANSPOSITIONS ---------- //
+
+template<>
+inline Maths::Mat4 Maths::Mat4::GetTransposed() const
+{
+    __m128 r0 = _mm_loadu_ps(m[0]), r1 = _mm_loadu_ps(m[1]), r2 = _mm_loadu_ps(m[2]), r3 = _mm_loadu_ps(m[3]);
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    Mat4 result(false);
+    _mm_storeu_ps(result.m[0], r0);
+    _mm_storeu_ps(result.m[1], r1);
+    _mm_storeu_ps(result.m[2], r2);
+    _mm_storeu_ps(result.m[3], r3);
+    return result;
+}
+
+
+// ---------- INVERSES ---------- //
+
+template<>
+inline Maths::Mat2 Maths::Mat2::Inv2() const
+{
+    // (a11 -a01 -a10 a00) / det, like the generic template.
+    const __m128 a      = _mm_loadu_ps(&m[0][0]);
+    const __m128 negate = _mm_setr_ps(0.f, -0.f, -0.f, 0.f);
+    const __m128 adj    = _mm_xor_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 2, 1, 3)), negate);
+    const __m128 det    = _mm_set1_ps(m[1][1] * m[0][0] - m[0][1] * m[1][0]);
+    Mat2 result(false);
+    _mm_storeu_ps(&result.m[0][0], _mm_div_ps(adj, det));
+    return result;
+}
+
+template<>
+inline Maths::Mat3 Maths::Mat3::Inv3() const
+{
+    // The columns of the inverse are the cross products of the rows (r1 x r2, r2 x r0, r0 x r1), divided by the determinant.
+    const __m128 r0 = MatrixSSE::LoadRow3(m[0]), r1 = MatrixSSE::LoadRow3(m[1]), r2 = MatrixSSE::LoadRow3(m[2]);
+    const auto cross = [](const __m128& a, const __m128& b)
+    {
+        const __m128 aYZX = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1)), bYZX = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+        const __m128 c    = _mm_sub_ps(_mm_mul_ps(a, bYZX), _mm_mul_ps(aYZX, b));
+        return _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1));
+    };
+    __m128 c0 = cross(r1, r2), c1 = cross(r2, r0), c2 = cross(r0, r1), c3 = _mm_setzero_ps();
+
+    // Determinant as r0 . (r1 x r2), in every lane.
+    const __m128 products = _mm_mul_ps(r0, c0);
+    __m128 det = _mm_add_ps(products, _mm_shuffle_ps(products, products, _MM_SHUFFLE(3, 0, 2, 1)));
+    det = _mm_add_ps(det, _mm_shuffle_ps(products, products, _MM_SHUFFLE(3, 1, 0, 2)));
+    det = MatrixSSE::Splat<0>(det);
+
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+    Mat3 result(false);
+    MatrixSSE::StoreRow3(result.m[0], _mm_div_ps(c0, det));
+    MatrixSSE::StoreRow3(result.m[1], _mm_div_ps(c1, det));
+    MatrixSSE::StoreRow3(result.m[2], _mm_div_ps(c2, det));
+    return result;
+}
+
+template<>
+inline Maths::Mat4 Maths::Mat4::Inv4() const
+{
+    // Block inversion of M = | A B |, with 2x2 blocks and the adjugates of their products instead of their inverses:
+    //                        | C D |
+    // M^-1 = 1/|M| * | X# Y# |
+    //                | Z# W# |
+    const __m128 r0 = _mm_loadu_ps(m[0]), r1 = _mm_loadu_ps(m[1]), r2 = _mm_loadu_ps(m[2]), r3 = _mm_loadu_ps(m[3]);
+    const __m128 a = _mm_movelh_ps(r0, r1), b = _mm_movehl_ps(r1, r0);
+    const __m128 c = _mm_movelh_ps(r2, r3), d = _mm_movehl_ps(r3, r2);
+
+    // Determinants of the blocks as (|A| |B| |C| |D|).
+    const __m128 detBlocks = _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(r0, r2, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(r1, r3, _MM_SHUFFLE(3, 1, 3, 1))),
+                                        _mm_mul_ps(_mm_shuffle_ps(r0, r2, _MM_SHUFFLE(3, 1, 3, 1)), _mm_shuffle_ps(r1, r3, _MM_SHUFFLE(2, 0, 2, 0))));
+    const __m128 detA = MatrixSSE::Splat<0>(detBlocks), detB = MatrixSSE::Splat<1>(detBlocks);
+    const __m128 detC = MatrixSSE::Splat<2>(detBlocks), detD = MatrixSSE::Splat<3>(detBlocks);
+
+    const __m128 dc = MatrixSSE::Mat2AdjMul(d, c); // D# * C.
+    const __m128 ab = MatrixSSE::Mat2AdjMul(a, b); // A# * B.
+    __m128 x = _mm_sub_ps(_mm_mul_ps(detD, a), MatrixSSE::Mat2Mul   (b, dc)); // X# = |D| A - B (D# C).
+    __m128 w = _mm_sub_ps(_mm_mul_ps(detA, d), MatrixSSE::Mat2Mul   (c, ab)); // W# = |A| D - C (A# B).
+    __m128 y = _mm_sub_ps(_mm_mul_ps(detB, c), MatrixSSE::Mat2MulAdj(d, ab)); // Y# = |B| C - D (A# B)#.
+    __m128 z = _mm_sub_ps(_mm_mul_ps(detC, b), MatrixSSE::Mat2MulAdj(a, dc)); // Z# = |C| B - A (D# C)#.
+
+    // |M| = |A| |D| + |B| |C| - tr((A# B) (D# C)).
+    __m128 trace = _mm_mul_ps(ab, _mm_shuffle_ps(dc, dc, _MM_SHUFFLE(3, 1, 2, 0)));
+    trace = _mm_add_ps(trace, _mm_movehl_ps(trace, trace));
+    trace = _mm_add_ps(trace, _mm_shuffle_ps(trace, trace, _MM_SHUFFLE(1, 1, 1, 1)));
+    const __m128 detM = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), MatrixSSE::Splat<0>(trace));
+
+    // The adjugates' signs and the division by |M|, then the adjugates' swaps while storing.
+    const __m128 scale = _mm_div_ps(_mm_setr_ps(1.f, -1.f, -1.f, 1.f), detM);
+    x = _mm_mul_ps(x, scale);
+    y = _mm_mul_ps(y, scale);
+    z = _mm_mul_ps(z, scale);
+    w = _mm_mul_ps(w, scale);
+
+    Mat4 result(false);
+    _mm_storeu_ps(result.m[0], _mm_shuffle_ps(x, y, _MM_SHUFFLE(1, 3, 1, 3)));
+    _mm_storeu_ps(result.m[1], _mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 2, 0, 2)));
+    _mm_storeu_ps(result.m[2], _mm_shuffle_ps(z, w, _MM_SHUFFLE(1, 3, 1, 3)));
+    _mm_storeu_ps(result.m[3], _mm_shuffle_ps(z, w, _MM_SHUFFLE(0, 2, 0, 2)));
+    return result;
+}
+
+#else
+
+// Other architectures use the generic template.
+template<> template<> inline Maths::Mat2 Maths::Mat2::operator*<2, 2>(const Mat2& matrix) const { return MatrixGeneric::Multiply(*this, matrix); }
+template<> template<> inline Maths::Mat4 Maths::Mat4::operator*<4, 4>(const Mat4& matrix) const { return MatrixGeneric::Multiply(*this, matrix); }
+template<> inline Maths::Mat4 Maths::Mat4::GetTransposed() const { return MatrixGeneric::Transpose(*this); }
+template<> inline Maths::Mat2 Maths::Mat2::Inv2() const { return MatrixGeneric::Inv2(*this); }
+template<> inline Maths::Mat3 Maths::Mat3::Inv3() const { return MatrixGeneric::Inv3(*this); }
+template<> inline Maths::Mat4 Maths::Mat4::Inv4() const { return MatrixGeneric::Inv4(*this); }
+
+#endif
@@ -0,0 +1,21 @@
+#pragma once
+#include "Vector3.h"
+#include "Vector4.h"
+#include "Matrix.h"
+#include "Transform2DBatch.h"
+#include <cstddef>
+
+// Multiplications of arrays of vectors and matrices by the same matrix, to transform many instances at once.
+// They use the same instruction sets as the transform integrator, unsupported backends fall back to the best supported one.
+// Every backend gives the same results as multiplying the elements one by one, and results can be written over the inputs.
+namespace Maths
+{
+    // results[i] = vectors[i] * matrix, like Vector4::operator*.
+    void TransformVectors(const Mat4& matrix, const Vector4* vectors, Vector4* results, const size_t& count, IntegratorBackend backend = GetBestIntegratorBackend());
+
+    // results[i] = points[i] * matrix, like Vector3::operator*: the points have a w of 1 and the results are homogenized.
+    void TransformPoints(const Mat4& matrix, const Vector3* points, Vector3* results, const size_t& count, IntegratorBackend backend = GetBestIntegratorBackend());
+
+    // results[i] = matrices[i] * matrix, e.g. to move the world matrices of many instances to view space.
+    void MultiplyMatrices(const Mat4* matrices, const Mat4& matrix, Mat4* results, const size_t& count, IntegratorBackend backend = GetBestIntegratorBackend());
+}
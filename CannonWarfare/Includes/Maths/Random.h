@@ -0,0 +1,33 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace Maths
+{
+    // Fast seedable random number generator (xoshiro128+), with a second set of 4 generators to fill arrays of floats 4 at a time.
+    // The same seed and stream always give the same numbers, on every platform and whether SIMD is used or not.
+    class Random
+    {
+    private:
+        uint32_t state[4];
+        alignas(16) uint32_t lanes[4][4]; // The 4 state words of each of the 4 bulk generators, stored word by word.
+
+    public:
+        // Generators with the same seed and different streams give unrelated numbers.
+        Random(const uint64_t& seed = 0, const uint64_t& stream = 0);
+        void Seed(const uint64_t& seed, const uint64_t& stream = 0);
+
+        uint32_t NextU32();
+        float    NextFloat();                                 // Uniform in [0, 1).
+        float    Range   (const float& min, const float& max); // Uniform in [min, max).
+        int      RangeInt(const int&   min, const int&   max); // Uniform in [min, max).
+
+        // Fills the array with floats uniform in [min, max), using SSE2 when available.
+        // Generates numbers 4 by 4 and drops the extra ones, so the following numbers don't depend on how the array is split.
+        void FillFloats      (float* out, const size_t& count, const float& min, const float& max);
+        void FillFloatsScalar(float* out, const size_t& count, const float& min, const float& max); // Same as above without SIMD.
+    };
+
+    // Returns a seed made from the current time and the address of a local variable, to record and replay runs.
+    uint64_t MakeRandomSeed();
+}
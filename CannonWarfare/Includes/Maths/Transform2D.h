@@ -12,6 +12,15 @@ namespace Maths
         float   angularVelocity = 0;
         bool    rotateForwards  = false;
 
-        void Update(const float& deltaTime);
+        inline void Update(const float& deltaTime)
+        {
+            if (rotateForwards)
+                rotation = velocity.GetAngle();
+            else
+                rotation += angularVelocity * deltaTime;
+
+            velocity += acceleration * deltaTime;
+            position += velocity     * deltaTime;
+        }
     };
 }
@@ -0,0 +1,58 @@
+#pragma once
+#include "Transform2D.h"
+#include <cstdint>
+#include <vector>
+
+namespace Maths
+{
+    // Instruction sets the batch integrator can use.
+    enum class IntegratorBackend
+    {
+        SCALAR,
+        SSE,
+        AVX2,
+    };
+
+    const char*       GetIntegratorBackendName (const IntegratorBackend& backend);
+    bool              IsIntegratorBackendSupported(const IntegratorBackend& backend); // Checks the CPU at runtime.
+    IntegratorBackend GetBestIntegratorBackend ();
+
+    // Structure-of-arrays storage for many Transform2D, integrated together.
+    // The rotation of transforms that rotate forwards isn't updated while stepping: it is computed from the velocity when asked for.
+    class Transform2DBatch
+    {
+    public:
+        std::vector<float>   posX, posY;
+        std::vector<float>   velX, velY;
+        std::vector<float>   accX, accY;
+        std::vector<float>   rotation, angularVelocity;
+        std::vector<uint8_t> rotateForwards;
+
+    private:
+        void UpdateScalar(const float& deltaTime, const size_t& begin, const size_t& end);
+        void UpdateSSE   (const float& deltaTime, const size_t& begin, const size_t& end);
+        void UpdateAVX2  (const float& deltaTime, const size_t& begin, const size_t& end);
+
+    public:
+        // Adds a transform at the end of the batch and returns its index.
+        size_t Add(const Transform2D& transform);
+        void   Clear();
+        void   Reserve(const size_t& capacity);
+
+        // Replaces the transform at the given index with the last one, then removes the last one.
+        void   RemoveSwap(const size_t& i);
+
+        // Applies acceleration to velocity, velocity to position and angular velocity to rotation.
+        // Unsupported backends fall back to the best supported one.
+        void   Update(const float& deltaTime, IntegratorBackend backend = GetBestIntegratorBackend());
+
+        // Same as above for the transforms from begin to end only, so that ranges can be integrated on different threads.
+        void   Update(const float& deltaTime, IntegratorBackend backend, const size_t& begin, const size_t& end);
+
+        size_t      Size       ()                const { return posX.size(); }
+        Vector2     GetPosition(const size_t& i) const { return { posX[i], posY[i] }; }
+        Vector2     GetVelocity(const size_t& i) const { return { velX[i], velY[i] }; }
+        float       GetRotation(const size_t& i) const; // Only calls atan2 for transforms that rotate forwards.
+        Transform2D Get        (const size_t& i) const; // Returns a copy of the transform with its rotation resolved.
+    };
+}
@@ -1,86 +1,100 @@
 #include "Vector2.h"
+#include "Arithmetic.h"
+#include <cmath>
+
+// ---------- VECTOR2 CONSTRUCTORS ---------- //
+
+constexpr Maths::Vector2::Vector2() : x(0), y(0) {}                                                       // Null vector.
+constexpr Maths::Vector2::Vector2(const float& _x, const float& _y) : x(_x), y(_y) {}                     // Vector with 2 coordinates.
+constexpr Maths::Vector2::Vector2(const Vector2& p1, const Vector2& p2) : x(p2.x - p1.x), y(p2.y - p1.y) {} // Vector from 2 points.
+
+// Vector from angle (useless bool). The cosine and sine are computed in double precision, recorded replays depend on it.
+inline Maths::Vector2::Vector2(const float& rad, const float& length, const bool&)
+    : x((float)(std::cos((double)rad) * length)), y((float)(std::sin((double)rad) * length)) {}
+
+// ---------- VECTOR2 OPERATORS ---------- //
 
 // Vector2 equality.
 template <typename T>
-bool Maths::Vector2::operator==(const T& val) const
+constexpr bool Maths::Vector2::operator==(const T& val) const
 {
     return (x == val && y == val);
 }
 template<>
-inline bool Maths::Vector2::operator==<Maths::Vector2>(const Vector2& val) const
+constexpr bool Maths::Vector2::operator==<Maths::Vector2>(const Vector2& val) const
 {
     return (x == val.x && y == val.y);
 }
 
 // Vector2 inequality.
 template <typename T>
-bool Maths::Vector2::operator!=(const T& val) const
+constexpr bool Maths::Vector2::operator!=(const T& val) const
 {
     return (x != val || y != val);
 }
 template<>
-inline bool Maths::Vector2::operator!=<Maths::Vector2>(const Vector2& val) const
+constexpr bool Maths::Vector2::operator!=<Maths::Vector2>(const Vector2& val) const
 {
     return (x != val.x || y != val.y);
 }
 
 // Vector2 addition.
 template <typename T>
-Maths::Vector2 Maths::Vector2::operator+(const T& val) const
+constexpr Maths::Vector2 Maths::Vector2::operator+(const T& val) const
 {
     return Vector2(x + val, y + val);
 }
 template<>
-inline Maths::Vector2 Maths::Vector2::operator+<Maths::Vector2>(const Vector2& val) const
+constexpr Maths::Vector2 Maths::Vector2::operator+<Maths::Vector2>(const Vector2& val) const
 {
     return Vector2(x + val.x, y + val.y);
 }
 
 // Vector2 subtraction.
 template <typename T>
-Maths::Vector2 Maths::Vector2::operator-(const T& val) const
+constexpr Maths::Vector2 Maths::Vector2::operator-(const T& val) const
 {
     return Vector2(x - val, y - val);
 }
 template <>
-inline Maths::Vector2 Maths::Vector2::operator-<Maths::Vector2>(const Vector2& val) const
+constexpr Maths::Vector2 Maths::Vector2::operator-<Maths::Vector2>(const Vector2& val) const
 {
     return Vector2(x - val.x, y - val.y);
 }
 
 // Vector2 multiplication.
 template <typename T>
-Maths::Vector2 Maths::Vector2::operator*(const T& val) const
+constexpr Maths::Vector2 Maths::Vector2::operator*(const T& val) const
 {
     return Vector2(x * val, y * val);
 }
 template <>
-inline Maths::Vector2 Maths::Vector2::operator*<Maths::Vector2>(const Vector2& val) const
+constexpr Maths::Vector2 Maths::Vector2::operator*<Maths::Vector2>(const Vector2& val) const
 {
     return Vector2(x * val.x, y * val.y);
 }
 
 // Vector2 division.
 template <typename T>
-Maths::Vector2 Maths::Vector2::operator/(const T& val) const
+constexpr Maths::Vector2 Maths::Vector2::operator/(const T& val) const
 {
     return Vector2(x / val, y / val);
 }
 template <>
-inline Maths::Vector2 Maths::Vector2::operator/<Maths::Vector2>(const Vector2& val) const
+constexpr Maths::Vector2 Maths::Vector2::operator/<Maths::Vector2>(const Vector2& val) const
 {
     return Vector2(x / val.x, y / val.y);
 }
 
 // Vector2 addition assignment.
 template <typename T>
-void Maths::Vector2::operator+=(const T& val)
+constexpr void Maths::Vector2::operator+=(const T& val)
 {
     x += val;
     y += val;
 }
 template <>
-inline void Maths::Vector2::operator+=<Maths::Vector2>(const Vector2& val)
+constexpr void Maths::Vector2::operator+=<Maths::Vector2>(const Vector2& val)
 {
     x += val.x;
     y += val.y;
@@ -88,13 +102,13 @@ inline void Maths::Vector2::operator+=<Maths::Vector2>(const Vector2& val)
 
 // Vector2 subtraction assignment.
 template <typename T>
-void Maths::Vector2::operator-=(const T& val)
+constexpr void Maths::Vector2::operator-=(const T& val)
 {
     x -= val;
     y -= val;
 }
 template <>
-inline void Maths::Vector2::operator-=<Maths::Vector2>(const Vector2& val)
+constexpr void Maths::Vector2::operator-=<Maths::Vector2>(const Vector2& val)
 {
     x -= val.x;
     y -= val.y;
@@ -102,13 +116,13 @@ inline void Maths::Vector2::operator-=<Maths::Vector2>(const Vector2& val)
 
 // Vector2 multiplication assignment.
 template <typename T>
-void Maths::Vector2::operator*=(const T& val)
+constexpr void Maths::Vector2::operator*=(const T& val)
 {
     x *= val;
     y *= val;
 }
 template <>
-inline void Maths::Vector2::operator*=<Maths::Vector2>(const Vector2& val)
+constexpr void Maths::Vector2::operator*=<Maths::Vector2>(const Vector2& val)
 {
     x *= val.x;
     y *= val.y;
@@ -116,14 +130,62 @@ inline void Maths::Vector2::operator*=<Maths::Vector2>(const Vector2& val)
 
 // Vector2 division assignment.
 template <typename T>
-void Maths::Vector2::operator/=(const T& val)
+constexpr void Maths::Vector2::operator/=(const T& val)
 {
     x /= val;
     y /= val;
 }
 template <>
-inline void Maths::Vector2::operator/=<Maths::Vector2>(const Vector2& val)
+constexpr void Maths::Vector2::operator/=<Maths::Vector2>(const Vector2& val)
 {
     x /= val.x;
     y /= val.y;
 }
+
+// Vector2 negation.
+constexpr Maths::Vector2 Maths::Vector2::operator-() const { return { -x, -y }; }
+
+// Vector2 dot product.
+constexpr float Maths::Vector2::Dot(const Vector2& v) const { return (x * v.x) + (y * v.y); }
+
+// Vector2 cross product.
+constexpr float Maths::Vector2::Cross(const Vector2& v) const { return (x * v.y) - (y * v.x); }
+
+// ------------ VECTOR2 METHODS ----------- //
+
+// Length.
+constexpr float Maths::Vector2::GetLengthSquared()       const { return sqpow(x) + sqpow(y); }
+inline    float Maths::Vector2::GetLength()              const { return std::sqrt(sqpow(x) + sqpow(y)); }
+inline    void  Maths::Vector2::SetLength(const float& length) { Normalize(); *this *= length; }
+
+// Normalization.
+inline void           Maths::Vector2::Normalize    ()       { const float length = GetLength(); x /= length; y /= length; }
+inline Maths::Vector2 Maths::Vector2::GetNormalized() const { const float length = GetLength(); return Vector2(x / length, y / length); }
+
+// Negation.
+constexpr void           Maths::Vector2::Negate    ()       { x *= -1; y *= -1; }
+constexpr Maths::Vector2 Maths::Vector2::GetNegated() const { return Vector2(-x, -y); }
+
+// Copy signs.
+inline void           Maths::Vector2::CopySign     (const Vector2& source)       { *(this) = GetCopiedSign(source); }
+inline Maths::Vector2 Maths::Vector2::GetCopiedSign(const Vector2& source) const { return Vector2(std::copysign(x, source.x), std::copysign(y, source.y)); }
+
+// Returns the normal of a given vector.
+constexpr Maths::Vector2 Maths::Vector2::GetNormal() const { return Vector2(-y, x); }
+
+// Interprets the vector as a point and returns the distance to another point.
+inline float Maths::Vector2::GetDistanceFromPoint(const Vector2& p) const { return Vector2(*this, p).GetLength(); }
+
+// Angle.
+inline float Maths::Vector2::GetAngle() const
+{
+    const Vector2 normalized = GetNormalized();
+    return std::copysign(std::acos(normalized.x), std::asin(normalized.y));
+}
+
+// Calculates linear interpolation for a value from a start point to an end point.
+constexpr Maths::Vector2 Maths::Vector2::Lerp(const Vector2& start, const Vector2& dest, const float& val)
+{
+    return Vector2(lerp(start.x, dest.x, val),
+                   lerp(start.y, dest.y, val));
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Canvas.h"
+#include <cstdint>
+
+// Number shown with a fixed number of decimals and a unit, e.g. "1.25s" or "640px".
+// The text is only formatted again when the shown digits change, and only measured again when it changes.
+class NumberLabel
+{
+private:
+	int64_t     shownValue = 0;       // Value times 10^precision, rounded.
+	int         precision  = -1;      // -1 until the label is set.
+	const char* unit       = nullptr; // Must be a string literal.
+	char        text[LABEL_CAPACITY] = "";
+	int         width         = 0;
+	int         widthFontSize = -1;   // Font size the width was measured at, -1 if it must be measured again.
+
+public:
+	// Precision is the number of decimals, from 0 to 6. Returns true if the text changed.
+	bool Set(const float& value, const int& _precision, const char* _unit);
+
+	const char* GetText() const { return text; }
+	int         GetWidth(const Canvas& canvas, const int& fontSize);
+};
@@ -1,15 +1,9 @@
 #pragma once
 
 #include "Vector2.h"
-#include <raylib.h>
-
+#include "Canvas.h"
 #include "Transform2D.h"
-
-enum class ParticleShapes {
-	LINE,
-	CIRCLE,
-	POLYGON,
-};
+#include "ParticleGeometry.h"
 
 struct Particle
 {
@@ -21,11 +15,11 @@ struct Particle
 	float friction;
 	int   sides;
 
-	Color color;
+	CanvasColor color;
 
-	Particle(const ParticleShapes& _shape, const Maths::Transform2D& _transform, const float& _size, const float& _friction, const Color& _color);
+	Particle() = default;
+	Particle(const ParticleShapes& _shape, const Maths::Transform2D& _transform, const float& _size, const float& _friction, const CanvasColor& _color);
 
-	void Draw() const;
 	void Update(const float& deltaTime);
 
 	bool IsOutdated() const { return size <= 0; }
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Vector2.h"
+#include "Physics/JobSystem.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+enum class ParticleShapes {
+	LINE,
+	CIRCLE,
+	POLYGON,
+};
+constexpr size_t PARTICLE_SHAPE_COUNT = 3;
+
+constexpr int   PARTICLE_CIRCLE_SIDES   = 36; // Same as raylib's DrawCircleLines.
+constexpr int   PARTICLE_POLYGON_SIDES  = 4;
+constexpr float PARTICLE_LINE_THICKNESS = 1;  // Thickness of the particle outlines (px).
+
+// What is needed to draw a particle.
+struct ParticleInstance
+{
+	ParticleShapes shape;
+	Maths::Vector2 position;
+	Maths::Vector2 velocity; // Lines are drawn along the velocity.
+	float          rotation; // Rad, only used by polygons.
+	float          size;     // Length of lines, radius of circles and polygons.
+	uint8_t        r, g, b, a;
+};
+
+// Vertex of the particle triangles, laid out to be sent to the GPU as is.
+struct ParticleVertex
+{
+	float   x, y;
+	uint8_t r, g, b, a;
+};
+
+// Number of vertices of the triangles drawn for a particle of the given shape (each side of the outline is a quad made of 2 triangles).
+constexpr size_t GetParticleVertexCount(const ParticleShapes& shape)
+{
+	return shape == ParticleShapes::LINE   ? 6
+	     : shape == ParticleShapes::CIRCLE ? 6 * PARTICLE_CIRCLE_SIDES
+	     :                                   6 * PARTICLE_POLYGON_SIDES;
+}
+
+// Builds the outline triangles of all the particles of a frame in a single vertex stream, so that they can be drawn at once.
+// Vertices are grouped by shape in the order of ParticleShapes. Inside each group, particles keep their order whatever the number of threads.
+class ParticleGeometry
+{
+public:
+	static constexpr size_t CHUNK_SIZE = 4096; // Number of particles built by each job.
+
+private:
+	std::vector<ParticleVertex> vertices;
+	std::array<size_t, PARTICLE_SHAPE_COUNT> groupBegin = {};
+	std::array<size_t, PARTICLE_SHAPE_COUNT> groupSize  = {};
+	std::vector<std::array<size_t, PARTICLE_SHAPE_COUNT>> chunkOffsets; // Index of the first vertex written by each chunk in each group.
+
+public:
+	void Reserve(const size_t& vertexCount) { vertices.reserve(vertexCount); }
+	void Build(const std::vector<ParticleInstance>& particles, Physics::JobSystem& jobs);
+
+	const std::vector<ParticleVertex>& GetVertices() const { return vertices; }
+
+	size_t GetVertexCount()                           const { return vertices.size();         }
+	size_t GetGroupBegin(const ParticleShapes& shape) const { return groupBegin[(int)shape]; } // Index of the first vertex of the shape's group.
+	size_t GetGroupSize (const ParticleShapes& shape) const { return groupSize [(int)shape]; } // Number of vertices in the shape's group.
+};
@@ -1,24 +1,71 @@
 #pragma once
 
 #include "ParticleSpawner.h"
+#include "ParticleGeometry.h"
+#include "Transform2DBatch.h"
+#include "Physics/JobSystem.h"
+#include "Random.h"
 #include <vector>
 
+constexpr size_t MAX_PARTICLES         = 50000;
+constexpr size_t MAX_PARTICLE_SPAWNERS = 2000;
+constexpr size_t PARTICLE_CHUNK_SIZE   = 4096; // Number of particles updated by each job.
+constexpr size_t SPAWNER_CHUNK_SIZE    = 64;   // Number of spawners updated by each job.
+
+// Fixed-capacity pools of particles and spawners, stored by value.
+// Particles are stored as parallel arrays so that their transforms are integrated together.
+// Outdated elements are removed by moving the last element into their slot, so their order isn't kept.
+// New elements are dropped when a pool is full.
+// Updates are split in chunks run in parallel. The particles spawned by each chunk of spawners are added in the spawners' order,
+// so the particles are the same whatever the number of threads.
 class ParticleManager
 {
 private:
-	std::vector<ParticleSpawner*> particleSpawners;
-	std::vector<Particle*>        particles;
+	std::vector<ParticleSpawner>       particleSpawners;
+	std::vector<std::vector<Particle>> spawnedParticles; // Particles spawned by each chunk of spawners during the last update.
+	std::vector<Particle>              spawnScratch;     // Particles created by SpawnParticles before being added.
+	Maths::Random                      rng;              // Used by SpawnParticles.
+	uint64_t                           seed          = 0;
+	uint64_t                           spawnerStream = 0; // Stream of the last spawner created, each spawner gets the next one.
+
+	// Particles.
+	Maths::Transform2DBatch     transforms;
+	std::vector<float>          prevX, prevY; // Positions before the last update, to interpolate drawing between updates.
+	std::vector<ParticleShapes> shapes;
+	std::vector<float>          sizes;
+	std::vector<float>          frictions;
+	std::vector<CanvasColor>    colors;
+	std::vector<ParticleInstance> drawList;     // Interpolated copies of the particles, drawn without reading the simulated ones.
+	ParticleGeometry              drawGeometry; // Triangles of the draw list.
+
+	size_t particleHighWater = 0; // Highest number of particles alive at the same time.
+	size_t spawnerHighWater  = 0; // Highest number of spawners alive at the same time.
+	size_t droppedParticles  = 0; // Number of particles that couldn't be spawned because the pool was full.
+
+	void RemoveParticle(const size_t& i);
 
 public:
-	~ParticleManager();
+	Maths::IntegratorBackend integratorBackend = Maths::GetBestIntegratorBackend();
+
+	ParticleManager(const uint64_t& _seed = 0);
 	
 	// Methods
-	void Update(const float& deltaTime);
-	void Draw() const;
-	void CreateSpawner(const int& spawnRate, const float& spawnDuration, const SpawnerParticleParams& params, const Maths::Transform2D* parentTransform = nullptr);
-	void AddParticle  (Particle* particle);
+	void Seed  (const uint64_t& _seed); // The same seed and the same calls always give the same particles.
+	void Update(const float& deltaTime, Physics::JobSystem& jobs);
+	void BuildDrawList(const float& alpha, Physics::JobSystem& jobs); // Alpha interpolates between the positions before and after the last update.
+	void CreateSpawner (const int& spawnRate, const float& spawnDuration, const SpawnerParticleParams& params);
+	void SpawnParticles(const int& count, const SpawnerParticleParams& params);
+	bool AddParticle   (const Particle& particle);
 
 	// Native Types - Getter
-	std::vector<ParticleSpawner*> GetSpawners()  const { return particleSpawners; }
-    std::vector<Particle*>        GetParticles() const { return particles; }
+	const std::vector<ParticleSpawner>& GetSpawners()     const { return particleSpawners; }
+	const ParticleGeometry&             GetDrawGeometry() const { return drawGeometry;     } // Particles as they were when the draw list was built.
+	Particle GetParticle(const size_t& i, const float& alpha = 1) const; // Returns a copy of the particle, at the interpolated position.
+
+	size_t GetParticleCount()     const { return transforms.Size();       }
+	size_t GetSpawnerCount()      const { return particleSpawners.size(); }
+	size_t GetParticleHighWater() const { return particleHighWater;       }
+	size_t GetSpawnerHighWater()  const { return spawnerHighWater;        }
+	size_t GetDroppedParticles()  const { return droppedParticles;        }
+	uint64_t GetSeed()            const { return seed;                    }
 };
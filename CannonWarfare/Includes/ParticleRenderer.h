@@ -0,0 +1,23 @@
+#pragma once
+
+#include "ParticleGeometry.h"
+
+// Draws particle geometry with a single draw call, from a dynamic vertex buffer that grows to fit the largest geometry drawn.
+// Uses raylib's default shader, and its immediate mode if the vertex buffer can't be created.
+class ParticleRenderer
+{
+private:
+	unsigned int vertexArray    = 0; // Only used if the GPU supports vertex array objects.
+	unsigned int vertexBuffer   = 0;
+	size_t       bufferCapacity = 0; // Number of vertices the buffer can hold.
+	size_t       lastDrawCalls  = 0;
+
+	void DrawImmediate(const ParticleGeometry& geometry);
+
+public:
+	// Must be called before the window is closed.
+	void Unload();
+	void Draw(const ParticleGeometry& geometry);
+
+	size_t GetLastDrawCalls() const { return lastDrawCalls; } // Number of draw calls of the last Draw.
+};
@@ -1,10 +1,10 @@
 ﻿#pragma once
 
 #include "Particle.h"
+#include "Random.h"
+#include <cstdint>
 #include <vector>
 
-class ParticleManager;
-
 struct SpawnerParticleParams
 {
     ParticleShapes      shape;
@@ -15,27 +15,29 @@ struct SpawnerParticleParams
     float minAngularV,  maxAngularV;
     float minSize,      maxSize;
     float minFriction,  maxFriction;
-    Color color;
+    CanvasColor color;
 };
 
+// Appends the given number of particles with random values within the bounds of the given params.
+// The random values are generated in bulk, one array per property.
+void CreateRandomParticles(const SpawnerParticleParams& params, const int& count, Maths::Random& rng, std::vector<Particle>& out);
+
 class ParticleSpawner
 {
 private:
-    ParticleManager& particleManager;
-    
     int   spawnRate     = 0;
     float spawnDuration = 0;
+    Maths::Random rng; // Each spawner has its own random stream so that spawners give the same particles when updated in parallel.
 
 public:
-    SpawnerParticleParams     params;
-    const Maths::Transform2D* parentTransform = nullptr;
+    SpawnerParticleParams params;
     
 public:
     // Constructor.
-    ParticleSpawner(ParticleManager& _particleManager, const int& _spawnRate, const float& _spawnDuration, const SpawnerParticleParams& _params, const Maths::Transform2D* _parentTransform = nullptr);
+    ParticleSpawner(const int& _spawnRate, const float& _spawnDuration, const SpawnerParticleParams& _params, const uint64_t& _seed, const uint64_t& _stream);
 
     // Methods.
-    void Update(const float& deltaTime);
+    void Update(std::vector<Particle>& spawned, const float& deltaTime); // Appends the particles spawned during this update.
 
     // Getters.
     int   GetSpawnRate()     const { return spawnRate;          }
@@ -0,0 +1,44 @@
+#pragma once
+#include "Maths/Vector2.h"
+#include "Physics/PhysicsConstants.h"
+#include <vector>
+
+namespace Physics
+{
+    // Tweakable properties of a cannon and of the projectiles it shoots.
+    struct CannonProperties
+    {
+        Maths::Vector2 anchorPos;
+        float mass = 2500;                           // kg
+        float barrelLength = 3.08f * PIXEL_SCALE;    // m -> px
+        float powderCharge = 3.6f;                   // kg
+        float chargeVelocity = 685.8f * PIXEL_SCALE; // m/s -> px/s
+        float projectileRadius = 30;                 // px
+        float projectileMass = 3.92f;                // kg
+    };
+
+    // Predicted values for a cannonball shot from a given point.
+    struct TrajectoryPrediction
+    {
+        Maths::Vector2 landingVelocity, landingPosition, controlPoint, highestPoint;
+        float airTime = 0, maxHeight = 0, landingDistance = 0;
+    };
+
+    // Returns the velocity at which a projectile leaves the barrel (px/s).
+    float ComputeMuzzleVelocity(const CannonProperties& properties);
+
+    // Returns the velocity at which the cannon is pushed back after a shot (px/s).
+    float ComputeRecoilVelocity(const CannonProperties& properties);
+
+    // Returns the drag coefficient of a sphere of the given radius (px).
+    float ComputeDragCoefficient(const float& radius);
+
+    // Returns the drag to add to a projectile's acceleration during the given time step.
+    Maths::Vector2 ComputeDrag(const Maths::Vector2& velocity, const float& dragCoeff, const float& deltaTime);
+
+    // Solves the projectile's movement equation to find where and when it lands (no drag).
+    TrajectoryPrediction PredictTrajectory(const Maths::Vector2& shootingPoint, const float& rotation, const CannonProperties& properties, const float& groundHeight);
+
+    // Simulates a projectile with drag until it lands. Sampled positions are written to points if it isn't null.
+    TrajectoryPrediction PredictTrajectoryWithDrag(const Maths::Vector2& shootingPoint, const float& rotation, const CannonProperties& properties, const float& groundHeight, std::vector<Maths::Vector2>* points = nullptr);
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include "Physics/Ballistics.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Physics
+{
+    // Evenly spaced values from min to max (both included).
+    struct FiringTableAxis
+    {
+        float  min = 0, max = 0;
+        size_t count = 1;
+
+        float Get(const size_t& i) const { return count > 1 ? min + (max - min) * i / (count - 1) : min; }
+    };
+
+    // Grids of cannon properties to compute a firing table for. Every combination of values gets an entry.
+    struct FiringTableParams
+    {
+        FiringTableAxis powderCharge     = { 2,   10,   5  }; // kg
+        FiringTableAxis barrelLength     = { 500, 2500, 5  }; // px
+        FiringTableAxis projectileMass   = { 2,   50,   5  }; // kg
+        FiringTableAxis projectileRadius = { 5,   50,   4  }; // px
+        FiringTableAxis elevation        = { 5,   85,   17 }; // deg above the horizon
+        float  launchHeight = 50;                              // Height of the barrel's tip above the landing point (px).
+        size_t threadCount  = 0;                               // 0 uses every core.
+    };
+
+    // Values predicted for a trajectory, without the positions.
+    struct FiringSolution
+    {
+        float airTime = 0, landingDistance = 0, maxHeight = 0;
+        Maths::Vector2 landingVelocity;
+    };
+
+    // Predicted values for one combination of cannon properties.
+    // Entries where the powder charge doesn't fit in the barrel have a NaN muzzle velocity and empty solutions.
+    struct FiringTableEntry
+    {
+        float powderCharge, barrelLength, projectileMass, projectileRadius, elevation;
+        float muzzleVelocity;
+        FiringSolution noDrag, drag;
+    };
+
+    class FiringTable
+    {
+    public:
+        // Version of the binary format, written after the "CWFT" magic.
+        static constexpr uint32_t BINARY_VERSION = 1;
+        // Number of floats per entry in the binary format.
+        static constexpr uint32_t BINARY_FIELD_COUNT = 16;
+
+        FiringTableParams params;
+        std::vector<FiringTableEntry> entries; // Ordered by powder charge, then barrel length, mass, radius and elevation (which changes fastest).
+
+        // Computes every entry of the table, with and without drag, splitting the work between threads.
+        static FiringTable Compute(const FiringTableParams& params);
+
+        // Writes the table as CSV with a header line. Returns false if the file couldn't be written.
+        bool WriteCSV(const std::string& path) const;
+
+        // Writes the table as little-endian binary: "CWFT", version, entry count and field count as uint32,
+        // then BINARY_FIELD_COUNT float32 per entry in the same order as the CSV columns. Returns false if the file couldn't be written.
+        bool WriteBinary(const std::string& path) const;
+    };
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+
+namespace Physics
+{
+    // Turns real frame times into a whole number of simulation steps of a fixed duration.
+    // The time left over is kept for the next frame and used to interpolate drawing between the last two steps.
+    class FixedTimestep
+    {
+    private:
+        float  stepRate    = 120; // Steps per second.
+        int    maxSubsteps = 8;   // Steps run per frame at most, the time they would have simulated is dropped.
+        double accumulator = 0;   // Time not simulated yet (s).
+        size_t stepCount   = 0;
+        double droppedTime = 0;   // Time dropped because there were too many steps to run in a frame (s).
+
+    public:
+        FixedTimestep() = default;
+        FixedTimestep(const float& _stepRate, const int& _maxSubsteps);
+
+        // Adds the duration of the last frame and returns the number of steps to run.
+        int Advance(const double& frameTime);
+
+        void SetStepRate   (const float& rate) { stepRate    = rate  > 1 ? rate  : 1; }
+        void SetMaxSubsteps(const int& steps)  { maxSubsteps = steps > 1 ? steps : 1; }
+
+        float  GetStepRate   () const { return stepRate;                       }
+        float  GetStep       () const { return 1 / stepRate;                   }
+        int    GetMaxSubsteps() const { return maxSubsteps;                    }
+        size_t GetStepCount  () const { return stepCount;                      }
+        double GetDroppedTime() const { return droppedTime;                    }
+        float  GetAlpha      () const { return (float)(accumulator * stepRate); } // Fraction of a step left in the accumulator, between 0 and 1.
+    };
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include "Physics/Ballistics.h"
+
+namespace Physics
+{
+    class TrajectoryPredictor;
+
+    // Distance from the target under which the drag solver stops refining an angle (px).
+    constexpr float FIRING_ANGLE_TOLERANCE = 0.5f;
+
+    // Rotations that make a projectile land on a target (rad, same convention as the cannon's rotation: negative is up when shooting right).
+    // If the target can't be reached, both angles are set to the one that shoots the furthest towards it.
+    struct FiringAngles
+    {
+        bool  reachable = false;
+        float low = 0, high = 0;
+        int   predictions = 0; // Number of trajectories predicted to find the angles (0 without drag).
+    };
+
+    // Solves the projectile's movement equation for the rotations that land it on target (no drag).
+    FiringAngles SolveFiringAngles(const Maths::Vector2& shootingPoint, const Maths::Vector2& target, const CannonProperties& properties);
+
+    // Finds the rotations that land a projectile with drag on target using the given predictor.
+    // The rotation that shoots the furthest is found with a golden-section search, then each angle with a bracketed root-finder.
+    // Each of these three searches predicts at most maxIterations trajectories, plus 2 to bracket the angles.
+    // Targets higher than the shooting point are considered unreachable.
+    FiringAngles SolveFiringAnglesWithDrag(const Maths::Vector2& shootingPoint, const Maths::Vector2& target, const CannonProperties& properties,
+                                           TrajectoryPredictor& predictor, const int& maxIterations = 20);
+}
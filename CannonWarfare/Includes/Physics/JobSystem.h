@@ -0,0 +1,133 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace Physics
+{
+    // Number of jobs run with a counter that haven't finished yet.
+    class JobCounter
+    {
+    private:
+        std::atomic<size_t> pending = { 0 };
+        friend class JobSystem;
+
+    public:
+        bool IsDone() const { return pending.load(std::memory_order_acquire) == 0; }
+    };
+
+    constexpr size_t JOB_CAPTURE_SIZE = 48;
+
+    // Function run by a job, stored in place so that queuing a job doesn't allocate.
+    // Its captures must be trivially copyable (references, pointers and numbers) and fit in JOB_CAPTURE_SIZE bytes.
+    class Job
+    {
+    private:
+        alignas(std::max_align_t) unsigned char captures[JOB_CAPTURE_SIZE];
+        void (*invoke)(const void* captures) = nullptr;
+
+    public:
+        Job() = default;
+
+        template<typename Function, typename = std::enable_if_t<!std::is_same_v<std::decay_t<Function>, Job>>>
+        Job(const Function& function)
+        {
+            static_assert(sizeof(Function) <= JOB_CAPTURE_SIZE, "Job captures are too big, capture a reference to them instead");
+            static_assert(alignof(Function) <= alignof(std::max_align_t), "Job captures are over-aligned");
+            static_assert(std::is_trivially_copyable_v<Function>, "Job captures must be trivially copyable");
+            new (captures) Function(function);
+            invoke = [](const void* captures) { (*static_cast<const Function*>(captures))(); };
+        }
+
+        void operator()() const { invoke(captures); }
+    };
+
+    // Small work-stealing job system.
+    // Each worker thread has its own queue: it runs its newest job first and steals the oldest job of another queue when its own is empty.
+    // Threads that aren't workers push their jobs to a shared queue, and run jobs while they wait for them.
+    // With no workers, jobs only run when they are waited for, on the waiting thread.
+    class JobSystem
+    {
+    private:
+        struct QueuedJob
+        {
+            Job         job;
+            JobCounter* counter;
+        };
+
+        // Ring buffer that only grows, so that queuing jobs doesn't allocate once it has held the most jobs queued at once.
+        struct JobQueue
+        {
+            std::mutex             mutex;
+            std::vector<QueuedJob> jobs = std::vector<QueuedJob>(64);
+            size_t                 first = 0; // Index of the oldest job.
+            size_t                 count = 0;
+
+            void      PushBack(const QueuedJob& job);
+            QueuedJob PopBack();  // Newest job, the queue must not be empty.
+            QueuedJob PopFront(); // Oldest job, the queue must not be empty.
+        };
+
+        std::vector<std::unique_ptr<JobQueue>> queues; // The shared queue, then one queue per worker.
+        std::vector<std::thread> workers;
+        std::atomic<size_t>      queuedJobs = { 0 };
+        std::mutex               sleepMutex;
+        std::condition_variable  wakeUp;
+        bool                     stopping = false;
+
+        void   WorkerLoop(const size_t& queueIndex);
+        bool   TryRunJob (const size_t& queueIndex); // Returns false if every queue is empty.
+        size_t GetCurrentQueue() const;
+        void   StartWorkers(const size_t& workerCount);
+        void   StopWorkers();
+
+    public:
+        // Returns one less than the number of cores, because the thread that waits on jobs runs them too.
+        static size_t GetDefaultWorkerCount();
+
+        explicit JobSystem(const size_t& workerCount = GetDefaultWorkerCount());
+        ~JobSystem();
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+
+        // Changes the number of worker threads. Must not be called while jobs are queued or running.
+        void   SetWorkerCount(const size_t& workerCount);
+        size_t GetWorkerCount() const { return workers.size(); }
+
+        // Queues a job. The counter must outlive the job.
+        void Run(JobCounter& counter, const Job& job);
+
+        // Runs queued jobs until every job run with the counter has finished.
+        void Wait(JobCounter& counter);
+
+        // Splits [0, count) into chunks of chunkSize elements and calls function(chunkIndex, begin, end) for each of them, in parallel.
+        // The chunks don't depend on the number of threads, so that per-chunk results can be merged in the same order every time.
+        template<typename Function>
+        void ParallelFor(const size_t& count, const size_t& chunkSize, const Function& function);
+
+        static size_t GetChunkCount(const size_t& count, const size_t& chunkSize) { return (count + chunkSize - 1) / chunkSize; }
+    };
+
+    template<typename Function>
+    void JobSystem::ParallelFor(const size_t& count, const size_t& chunkSize, const Function& function)
+    {
+        // Queue every chunk but the first one, which is run by this thread.
+        const size_t chunkCount = GetChunkCount(count, chunkSize);
+        JobCounter counter;
+        for (size_t chunk = 1; chunk < chunkCount; chunk++)
+        {
+            const size_t begin = chunk * chunkSize;
+            const size_t end   = begin + chunkSize < count ? begin + chunkSize : count;
+            Run(counter, [&function, chunk, begin, end]() { function(chunk, begin, end); });
+        }
+        if (chunkCount > 0)
+            function((size_t)0, (size_t)0, chunkSize < count ? chunkSize : count);
+        Wait(counter);
+    }
+}
@@ -1,3 +1,12 @@
 #pragma once
 
 #include "PhysicsConstants.h"
+#include "Ballistics.h"
+#include "FiringTable.h"
+#include "FixedTimestep.h"
+#include "InverseBallistics.h"
+#include "JobSystem.h"
+#include "Projectile.h"
+#include "ProjectilePool.h"
+#include "SpatialGrid.h"
+#include "TrajectoryPredictor.h"
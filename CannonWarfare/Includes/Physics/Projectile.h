@@ -0,0 +1,22 @@
+#pragma once
+#include "Maths/Vector2.h"
+
+namespace Physics
+{
+    // Spawn parameters and state snapshot of a single cannonball, independent from any rendering.
+    struct Projectile
+    {
+        Maths::Vector2 position, velocity, acceleration;
+        float radius = 30.f, mass = 4.f, elasticity = 0.25f;
+        bool  applyDrag = false;
+
+        // Trajectory values, frozen once the projectile has landed.
+        bool  landed = false, collided = false;
+        float airTime = 0; // Simulated seconds spent in the air before landing.
+        Maths::Vector2 startPos, startV;
+        Maths::Vector2 endPos,   endV;
+
+        Projectile() = default;
+        Projectile(const Maths::Vector2& startPosition, const Maths::Vector2& startVelocity);
+    };
+}
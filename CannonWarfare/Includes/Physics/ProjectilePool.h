@@ -0,0 +1,145 @@
+#pragma once
+#include "Physics/Projectile.h"
+#include <cstdint>
+#include <vector>
+
+namespace Physics
+{
+    class SpatialGrid;
+    class JobSystem;
+
+    // Bit flags stored for every projectile.
+    struct ProjectileFlags
+    {
+        enum : uint8_t
+        {
+            LANDED   = 1 << 0, // Touched the ground at least once, its trajectory values are frozen.
+            COLLIDED = 1 << 1, // Hit another projectile before landing.
+            DRAG     = 1 << 2, // Subject to drag while in the air.
+        };
+    };
+
+    enum class ProjectileEventType
+    {
+        LANDED,  // Touched the ground for the first time (the projectile also bounced).
+        BOUNCED, // Touched the ground again.
+        COLLIDED,
+    };
+
+    // Trail left by a projectile subject to drag, in a fixed block of points of the pool's trail arena.
+    // Samples are only kept when the line from the last kept point can't stay within tolerance of every sample since,
+    // so stepping only reads and writes this structure and the block is only written when a point is kept.
+    struct ProjectileTrail
+    {
+        static constexpr uint32_t NO_BLOCK  = UINT32_MAX;
+        static constexpr float    TOLERANCE = 0.5f; // Starting tolerance, in pixels.
+
+        uint32_t       block     = NO_BLOCK;  // Index of the trail's points in the arena, in blocks of TRAIL_CAPACITY.
+        uint32_t       keptCount = 0;         // Number of points kept in the block.
+        Maths::Vector2 lastKept, lastSample;  // The trail is drawn from the last kept point to the projectile while it is in the air.
+        bool           hasWedge  = false;     // Whether a sample went further than the tolerance from the last kept point.
+        Maths::Vector2 wedgeMin, wedgeMax;    // Directions that bound the lines from the last kept point that pass within tolerance of every sample.
+        float          farthest  = 0;         // Distance of the farthest sample from the last kept point.
+        float          tolerance = TOLERANCE; // Farthest a sample can be from the trail, doubled each time the block fills up.
+    };
+
+    // Something that happened to a projectile during a simulation step.
+    struct ProjectileEvent
+    {
+        ProjectileEventType type;
+        uint32_t       index, other; // Other is only used by collisions.
+        Maths::Vector2 position;     // Where the event happened (contact point for collisions).
+        float          speed;        // Speed after the event (mean speed of both projectiles for collisions).
+    };
+
+    // Structure-of-arrays storage for cannonballs, stepped with tight loops over contiguous data.
+    class ProjectilePool
+    {
+    public:
+        static constexpr float  DESTROY_DURATION = 1.f;
+        static constexpr size_t STEP_CHUNK_SIZE  = 4096; // Number of projectiles stepped by each job.
+        static constexpr size_t TRAIL_CAPACITY   = 64;   // Number of points kept in each trail's block.
+
+        // -- Hot data, read and written every step -- //
+        std::vector<float>   posX, posY;
+        std::vector<float>   prevX, prevY; // Positions before the last step, to interpolate drawing between steps.
+        std::vector<float>   velX, velY;
+        std::vector<float>   accX, accY;
+        std::vector<float>   radius, mass, elasticity;
+        std::vector<float>   dragCoeff;    // Zero when not subject to drag.
+        std::vector<float>   airTime, age; // Simulated seconds spent in the air / since the projectile was shot.
+        std::vector<float>   destroyTimer; // Starts at DESTROY_DURATION when destroyed, the projectile is removed below 0.
+        std::vector<uint8_t> flags;
+
+        // -- Cold data, only written on spawn and landing -- //
+        std::vector<Maths::Vector2> startPos, startV;
+        std::vector<Maths::Vector2> endPos,   endV;
+        std::vector<ProjectileTrail> trails; // Trajectories of projectiles subject to drag.
+
+    private:
+        // Scratch lists of each chunk of projectiles stepped in parallel.
+        struct StepChunk
+        {
+            std::vector<uint32_t>        bouncing; // Projectiles under the ground.
+            std::vector<ProjectileEvent> events;
+        };
+        std::vector<StepChunk> stepChunks;
+
+        std::vector<Maths::Vector2> trailPoints;     // Arena of the trails' blocks.
+        std::vector<uint32_t>       freeTrailBlocks; // Blocks of removed projectiles, reused before the arena grows.
+
+        void ReserveStepChunks(const size_t& count, const size_t& capacity);
+        void StepRange(const float& deltaTime, const float& groundHeight, const size_t& begin, const size_t& end,
+                       std::vector<uint32_t>& bouncing, std::vector<ProjectileEvent>* events);
+        void Bounce(const uint32_t& i, const float& groundHeight, std::vector<ProjectileEvent>* events);
+        void MoveSlot(const size_t& from, const size_t& to);
+        void AddTrailSample(const size_t& i, const Maths::Vector2& position);
+        void KeepTrailPoint(const size_t& i, const Maths::Vector2& position);
+        void Resize(const size_t& size);
+
+    public:
+        // Adds a projectile at the end of the pool and returns its index.
+        size_t Add(const Projectile& projectile);
+        void   Clear() { Resize(0); }
+        void   Reserve(const size_t& capacity);
+
+        // Applies drag, gravity, bouncing and destroy timers to all projectiles. Events are appended if the vector isn't null.
+        void Step(const float& deltaTime, const float& groundHeight, std::vector<ProjectileEvent>* events = nullptr);
+
+        // Same as above, splitting the projectiles in chunks stepped in parallel. The results and events are the same as above.
+        void Step(const float& deltaTime, const float& groundHeight, JobSystem& jobs, std::vector<ProjectileEvent>* events = nullptr);
+
+        // Tests every pair of projectiles and applies an elastic collision response to the overlapping ones.
+        void Collide(std::vector<ProjectileEvent>* events = nullptr);
+
+        // Same as above, but only tests the pairs that are neighbours in the spatial grid, which is rebuilt first.
+        // Pairs are resolved in the same order and on the same positions, so the results are the same as testing every pair.
+        void Collide(SpatialGrid& grid, std::vector<ProjectileEvent>* events = nullptr);
+
+        // Applies an elastic collision response to both projectiles if they overlap. Returns true if they collided.
+        bool ResolveCollision(const uint32_t& a, const uint32_t& b, std::vector<ProjectileEvent>* events = nullptr);
+
+        // Removes the projectiles that finished destroying themselves, keeping the others in order. Returns the number removed.
+        size_t RemoveDestroyed();
+
+        void Destroy(const size_t& i) { destroyTimer[i] = DESTROY_DURATION; }
+
+        // Getters.
+        size_t         Size           ()                const { return posX.size(); }
+        bool           IsLanded       (const size_t& i) const { return flags[i] & ProjectileFlags::LANDED;   }
+        bool           HasCollided    (const size_t& i) const { return flags[i] & ProjectileFlags::COLLIDED; }
+        bool           HasDrag        (const size_t& i) const { return flags[i] & ProjectileFlags::DRAG;     }
+        bool           IsDestroying   (const size_t& i) const { return 0.f < destroyTimer[i] && destroyTimer[i] < DESTROY_DURATION; }
+        bool           IsDestroyed    (const size_t& i) const { return destroyTimer[i] < 0.f; }
+        Maths::Vector2 GetPosition    (const size_t& i) const { return { posX[i], posY[i] }; }
+        Maths::Vector2 GetVelocity    (const size_t& i) const { return { velX[i], velY[i] }; }
+        Maths::Vector2 GetInterpolatedPosition(const size_t& i, const float& alpha) const { return { prevX[i] + (posX[i] - prevX[i]) * alpha, prevY[i] + (posY[i] - prevY[i]) * alpha }; }
+        Maths::Vector2 GetEndPos      (const size_t& i) const { return IsLanded(i) ? endPos[i] : GetPosition(i); }
+        Maths::Vector2 GetEndV        (const size_t& i) const { return IsLanded(i) ? endV  [i] : GetVelocity(i); }
+        const Maths::Vector2* GetTrail(const size_t& i) const { return &trailPoints[trails[i].block * TRAIL_CAPACITY]; } // Kept points, only for projectiles with drag.
+        size_t         GetTrailSize   (const size_t& i) const { return trails[i].keptCount; }
+        Maths::Vector2 GetControlPoint(const size_t& i) const; // Control point of the bezier curve going from the start to the end of the trajectory.
+        float          GetAlpha       (const size_t& i) const; // Opacity of the projectile, fades out while it is destroyed.
+        Projectile     Get            (const size_t& i) const; // Returns a copy of the projectile's state.
+    };
+}
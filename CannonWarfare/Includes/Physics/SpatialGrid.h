@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+namespace Physics
+{
+    class ProjectilePool;
+
+    // Uniform grid broad phase for projectile collisions.
+    // Projectiles are sorted into square cells as wide as the biggest projectile, stored in a hash table
+    // so that the grid doesn't need bounds. Overlapping projectiles are always in the same or neighbouring cells.
+    // Projectiles can be moved to other cells while collisions are resolved, so that the grid always matches their current positions.
+    class SpatialGrid
+    {
+    private:
+        static constexpr uint32_t NONE = UINT32_MAX;
+
+        float    cellSize  = 1.f;
+        uint32_t tableMask = 0;
+
+        std::vector<int32_t>  cellX, cellY;  // Cell coordinates of every projectile.
+        std::vector<uint32_t> bucketOf;      // Hash table bucket of every projectile.
+        std::vector<uint32_t> bucketHead;    // First projectile of every bucket, or NONE.
+        std::vector<uint32_t> next, prev;    // Doubly linked lists of the projectiles of each bucket.
+        std::vector<uint32_t> neighbours;    // Result of the last neighbour search.
+
+        uint32_t GetBucket(const int32_t& x, const int32_t& y) const;
+        void Link  (const uint32_t& i);
+        void Unlink(const uint32_t& i);
+
+    public:
+        // Sorts the projectiles into the grid.
+        void Build(const ProjectilePool& pool);
+
+        // Moves the given projectile to the cell of its current position in the pool. Returns true if its cell changed.
+        bool Update(const ProjectilePool& pool, const uint32_t& i);
+
+        // Returns the projectiles with an index of at least first in the cell of the given one and in the neighbouring cells, in increasing order.
+        // Projectiles further away can't overlap the given one. The list is reused by the next search.
+        const std::vector<uint32_t>& FindNeighbours(const uint32_t& i, const uint32_t& first);
+
+        float GetCellSize() const { return cellSize; }
+    };
+}
@@ -0,0 +1,99 @@
+#pragma once
+#include "Physics/Ballistics.h"
+#include "Maths/MathConstants.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace Physics
+{
+    // Error allowed per step by the adaptive integrator, relative to the size of the values (and absolute below 1).
+    constexpr double RK45_TOLERANCE = 1e-6;
+
+    // Number of positions sampled along trajectories predicted by the adaptive integrator.
+    constexpr size_t PREDICTION_POINT_COUNT = 64;
+
+    // How trajectories with drag are predicted.
+    enum class DragPredictionMode
+    {
+        EULER,  // Fixed 0.01s Euler steps (PredictTrajectoryWithDrag).
+        RK45,   // Adaptive Dormand-Prince steps (PredictTrajectoryRK45).
+        CACHED, // Interpolation between cached RK45 predictions.
+    };
+
+    const char* GetDragPredictionModeName(const DragPredictionMode& mode);
+
+    // Position, velocity and acceleration of a projectile. The drag model changes the acceleration over time,
+    // so the acceleration is part of the state: p' = v, v' = a, a' = -k * v * |v|.
+    struct DragState
+    {
+        double px, py, vx, vy, ax, ay;
+    };
+
+    // Accepted step of the adaptive integrator, kept to interpolate positions inside the steps.
+    struct DragNode
+    {
+        double    time;
+        DragState state;
+    };
+
+    // Integrates the same drag model as PredictTrajectoryWithDrag with adaptive Dormand-Prince 5(4) steps, and finds the exact landing time.
+    // Landing distances stay within 1% of PredictTrajectoryWithDrag's, most of the difference being the Euler predictor overshooting the ground by up to one step.
+    // Positions evenly spaced in time are written to points if it isn't null.
+    // The steps are stored in scratch if it isn't null, so that repeated predictions reuse its memory instead of allocating.
+    TrajectoryPrediction PredictTrajectoryRK45(const Maths::Vector2& shootingPoint, const float& rotation, const CannonProperties& properties, const float& groundHeight,
+                                               std::vector<Maths::Vector2>* points = nullptr, const double& tolerance = RK45_TOLERANCE,
+                                               std::vector<DragNode>* scratch = nullptr);
+
+    // Predicts trajectories with drag, caching RK45 predictions on a grid of shooting angles and heights above the ground.
+    // Predictions are bilinearly interpolated between the 4 closest cached samples, which are kept while predictions stay between them.
+    // The cache is cleared when the muzzle velocity or the projectile radius change (the mass only matters through the muzzle velocity).
+    // Its memory is allocated by the first prediction and kept when it is cleared.
+    class TrajectoryPredictor
+    {
+    public:
+        static constexpr float  ANGLE_STEP  = 0.25f * PI / 180; // Angle between cached samples (rad).
+        static constexpr float  DROP_STEP   = 4.f;             // Height between cached samples (px).
+        static constexpr size_t MAX_SAMPLES = 4096;            // The cache is cleared when it gets bigger than this.
+
+        DragPredictionMode mode = DragPredictionMode::CACHED;
+
+    private:
+        // Prediction for a projectile shot from (0, 0), landing DROP_STEP * dropIndex pixels lower.
+        struct Sample
+        {
+            uint64_t key;
+            TrajectoryPrediction prediction;
+            std::array<Maths::Vector2, PREDICTION_POINT_COUNT> points;
+        };
+
+        // Open addressing table of sample indices, twice as big as the cache so that probes stay short.
+        static constexpr uint32_t SLOT_COUNT = MAX_SAMPLES * 2;
+        static constexpr uint32_t EMPTY_SLOT = UINT32_MAX;
+
+        float muzzleVelocity = -1, projectileRadius = -1;
+        std::vector<Sample>   samples; // Reserved for MAX_SAMPLES, so that new samples don't allocate or move the others.
+        std::vector<uint32_t> slots;
+        size_t hitCount = 0, missCount = 0;
+
+        // Samples around the last prediction (null after the cache is cleared), at the indices of the first one.
+        int32_t       cellAngleIndex = 0, cellDropIndex = 0;
+        const Sample* cell[4] = {};
+
+        // Buffers of the RK45 predictions, cleared between them but kept allocated so that steady frames don't allocate.
+        std::vector<DragNode>       scratchNodes;
+        std::vector<Maths::Vector2> scratchPoints;
+
+        const Sample& GetSample(const int32_t& angleIndex, const int32_t& dropIndex, const CannonProperties& properties);
+
+    public:
+        // Predicts the trajectory of a projectile with drag using the current mode.
+        TrajectoryPrediction Predict(const Maths::Vector2& shootingPoint, const float& rotation, const CannonProperties& properties, const float& groundHeight,
+                                     std::vector<Maths::Vector2>* points = nullptr);
+        void Clear();
+
+        size_t GetSampleCount() const { return samples.size(); }
+        size_t GetHitCount()    const { return hitCount;       }
+        size_t GetMissCount()   const { return missCount;      }
+    };
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Physics/JobSystem.h"
+#include <cstdint>
+#include <vector>
+
+// Instruction sets the CPU post-processing can use.
+enum class PostProcessBackend {
+	SCALAR,
+	SSE,
+	AVX2,
+};
+
+const char*        GetPostProcessBackendName    (const PostProcessBackend& backend);
+bool               IsPostProcessBackendSupported(const PostProcessBackend& backend); // Checks the CPU at runtime.
+PostProcessBackend GetBestPostProcessBackend    ();
+
+// RGBA image with 8 bits per channel, stored row by row like a framebuffer.
+struct FrameImage
+{
+	int width  = 0;
+	int height = 0;
+	std::vector<uint8_t> pixels; // 4 bytes per pixel.
+
+	void Resize(const int& _width, const int& _height); // Fills the image with opaque black.
+
+	uint8_t*       GetRow  (const int& y)                     { return &pixels[(size_t)y * width * 4]; }
+	const uint8_t* GetRow  (const int& y)               const { return &pixels[(size_t)y * width * 4]; }
+	uint8_t*       GetPixel(const int& x, const int& y)       { return &pixels[((size_t)y * width + x) * 4]; }
+	const uint8_t* GetPixel(const int& x, const int& y) const { return &pixels[((size_t)y * width + x) * 4]; }
+};
+
+// CPU version of the post-processing done by Graphics::EndDrawing with blur passes (NonBlackPixels.fs, GaussianBlur.fs and ChromaticAberration.fs).
+// Textures are sampled with wrapped coordinates like raylib's render textures, and colors are rounded to 8 bits after each pass like on the GPU.
+// Rows are processed in parallel tiles. Every backend and thread count gives the same bytes, so that frames can be compared pixel for pixel.
+class PostProcess
+{
+public:
+	static constexpr int TILE_ROWS = 16; // Number of rows processed by each job.
+
+private:
+	FrameImage blurImages[2];
+
+	void MaskRows      (const FrameImage& source, FrameImage& destination, const int& rowBegin, const int& rowEnd) const;
+	void BlurRows      (const FrameImage& source, FrameImage& destination, const bool& vertical, const PostProcessBackend& usedBackend, const int& rowBegin, const int& rowEnd) const;
+	void AberrationRows(const FrameImage& source, const FrameImage& glow, FrameImage& result, const PostProcessBackend& usedBackend, const int& rowBegin, const int& rowEnd) const;
+
+public:
+	PostProcessBackend backend = GetBestPostProcessBackend(); // Replaced by the best supported one if the CPU doesn't support it.
+	int   blurPasses          = 5;
+	float aberrationIntensity = 5;    // Distance between the red, green and blue channels at the edges of the screen (px).
+	float vignetteSize        = 1100; // Distance from the center at which the chromatic aberration is at its maximum (px).
+
+	// Applies the whole chain to a frame: the lit pixels of the source are drawn over its chromatically aberrated glow.
+	void Apply(const FrameImage& source, FrameImage& result, Physics::JobSystem& jobs);
+
+	// Returns the glow of the last frame, before the chromatic aberration.
+	const FrameImage& GetGlow() const { return blurImages[0]; }
+};
+
+// Shrinks a frame by averaging blocks of factor x factor pixels, to make thumbnails.
+void DownscaleFrame(const FrameImage& source, FrameImage& result, const int& factor);
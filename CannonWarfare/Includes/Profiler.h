@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Profiling zones are compiled in debug builds, and in release builds only if PROFILING is defined to 1 by the build.
+#ifndef PROFILING
+	#ifdef NDEBUG
+		#define PROFILING 0
+	#else
+		#define PROFILING 1
+	#endif
+#endif
+
+// Number of zones kept per thread. Older zones are overwritten.
+constexpr size_t PROFILER_ZONE_CAPACITY = 16384;
+
+struct ProfileZone
+{
+	const char* name  = nullptr; // Must be a string literal.
+	uint64_t    start = 0;       // Nanoseconds since the profiler started.
+	uint64_t    end   = 0;
+	uint32_t    depth = 0;       // Number of zones of the same thread this zone is in.
+};
+
+struct ProfileThread
+{
+	uint32_t                 id = 0;
+	std::string              name;
+	std::vector<ProfileZone> zones; // Ordered by end time.
+};
+
+// Scoped-zone profiler. Each thread writes the zones it ends to its own ring buffer without locking,
+// and the zones are collected from every thread to be shown or exported.
+namespace Profiler
+{
+	uint64_t GetTime(); // Nanoseconds since the profiler started, from a monotonic clock.
+
+	void SetThreadName(const std::string& name);
+	void RecordZone(const char* name, const uint64_t& start, const uint64_t& end, const uint32_t& depth);
+
+	// Marks the start of a frame. Only called by the thread that draws.
+	void MarkFrame();
+	bool GetLastFrame(uint64_t& start, uint64_t& end); // Returns false if no frame has ended yet.
+
+	// Copies the zones of every thread that overlap [start, end). Zones overwritten while they are copied are left out.
+	std::vector<ProfileThread> Collect(const uint64_t& start = 0, const uint64_t& end = UINT64_MAX);
+
+	// Writes every zone still in the ring buffers, and the frame starts, in the Chrome trace event format (chrome://tracing, Perfetto).
+	bool WriteChromeTrace(const std::string& path);
+}
+
+// Records the time between its construction and its destruction as a zone of the current thread.
+class ProfileScope
+{
+private:
+	const char* name;
+	uint64_t    start;
+	uint32_t    depth;
+
+public:
+	ProfileScope(const char* _name);
+	~ProfileScope();
+	ProfileScope(const ProfileScope&) = delete;
+	ProfileScope& operator=(const ProfileScope&) = delete;
+};
+
+#if PROFILING
+	#define PROFILE_CONCAT_(a, b) a##b
+	#define PROFILE_CONCAT(a, b)  PROFILE_CONCAT_(a, b)
+	#define PROFILE_ZONE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#else
+	#define PROFILE_ZONE(name)
+#endif
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Canvas.h"
+#include "ParticleRenderer.h"
+#include <vector>
+
+// Quad of a glyph relative to where its text is drawn, with its texture coordinates in the font atlas.
+struct GlyphQuad
+{
+	float x, y, width, height;
+	float u0, v0, u1, v1;
+};
+
+// Glyph quads of a text at a font size, laid out like raylib's DrawText with the default font.
+struct GlyphRun
+{
+	char      text[LABEL_CAPACITY] = "";
+	int       fontSize   = 0; // 0 if the run is empty.
+	int       glyphCount = 0;
+	GlyphQuad glyphs[LABEL_CAPACITY];
+};
+
+// Number of glyph runs kept. Each text and font size has one slot, and replaces the run that was there.
+constexpr size_t GLYPH_RUN_CACHE_SIZE = 256;
+
+// Canvas that draws with raylib in the current render target.
+class RaylibCanvas : public Canvas
+{
+private:
+	ParticleRenderer particleRenderer;
+
+	std::vector<GlyphRun> glyphRuns = std::vector<GlyphRun>(GLYPH_RUN_CACHE_SIZE);
+	size_t glyphRunHits   = 0;
+	size_t glyphRunMisses = 0;
+
+	const GlyphRun& GetGlyphRun(const char* text, const int& fontSize); // Lays the text out if its run isn't cached.
+
+public:
+	// Must be called before the window is closed.
+	void Unload() { particleRenderer.Unload(); }
+
+	void DrawLine             (const Maths::Vector2& start, const Maths::Vector2& end, const float& thickness, const CanvasColor& color) override;
+	void DrawBezierQuad       (const Maths::Vector2& start, const Maths::Vector2& end, const Maths::Vector2& control, const float& thickness, const CanvasColor& color) override;
+	void DrawBezierCubic      (const Maths::Vector2& start, const Maths::Vector2& end, const Maths::Vector2& startControl, const Maths::Vector2& endControl, const float& thickness, const CanvasColor& color) override;
+	void DrawTriangle         (const Maths::Vector2& a, const Maths::Vector2& b, const Maths::Vector2& c, const CanvasColor& color) override;
+	void DrawRectangle        (const Maths::Vector2& position, const Maths::Vector2& size, const CanvasColor& color) override;
+	void DrawCircle           (const Maths::Vector2& center, const float& radius, const CanvasColor& color) override;
+	void DrawCircleLines      (const Maths::Vector2& center, const float& radius, const CanvasColor& color) override;
+	void DrawCircleSector     (const Maths::Vector2& center, const float& radius, const float& startAngle, const float& endAngle, const int& segments, const CanvasColor& color) override;
+	void DrawCircleSectorLines(const Maths::Vector2& center, const float& radius, const float& startAngle, const float& endAngle, const int& segments, const CanvasColor& color) override;
+	void DrawPoly             (const Maths::Vector2& center, const int& sides, const float& radius, const float& rotation, const CanvasColor& color) override;
+	void DrawText             (const char* text, const Maths::Vector2& position, const int& fontSize, const CanvasColor& color) override;
+	int  MeasureText          (const char* text, const int& fontSize) const override;
+	void DrawLabels           (const CanvasLabel* labels, const size_t& count) override; // All the labels' glyphs are drawn in one batch.
+	void DrawParticles        (const ParticleGeometry& geometry) override;
+
+	const ParticleRenderer& GetParticleRenderer() const { return particleRenderer; }
+	size_t GetGlyphRunHits  () const { return glyphRunHits;   }
+	size_t GetGlyphRunMisses() const { return glyphRunMisses; }
+};
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "Scene.h"
+#include "Physics/JobSystem.h"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Version of the replay format, written after the "CWRP" magic.
+constexpr uint32_t REPLAY_VERSION = 1;
+
+// Number of simulation steps between checkpoints while recording (1 second at the default rate).
+constexpr uint64_t REPLAY_CHECKPOINT_INTERVAL = 120;
+
+// What is needed to recreate the scene a replay starts from.
+struct ReplayHeader
+{
+	uint64_t       seed = 0;
+	Maths::Vector2 screenSize;
+	float          stepRate = 120; // Simulation steps per second at the start.
+};
+
+enum class ReplayEntryType : uint8_t {
+	COMMAND,
+	STEP_RATE,  // The simulation rate changed.
+	CHECKPOINT, // Checksum of the scene, to check that the replay gives the same simulation.
+};
+
+struct ReplayEntry
+{
+	uint64_t        step = 0; // Number of simulation steps run before the entry.
+	ReplayEntryType type = ReplayEntryType::COMMAND;
+	SceneCommand    command  = { SceneCommandType::SHOOT };
+	float           stepRate = 0;
+	uint64_t        checksum = 0;
+};
+
+// Writes the entries of a session to a file as they happen, so that the replay is kept if the app stops unexpectedly.
+// The format is little-endian binary: "CWRP", version as uint32, the header (seed as uint64, screen size and step rate as float32),
+// then each entry as the number of steps since the last entry (LEB128), its type and command type as uint8, and its value:
+// nothing for shots and clears, a uint8 for toggles and modes, a float32 for other commands and step rates, a uint64 for checksums.
+class ReplayRecorder
+{
+private:
+	FILE*    file     = nullptr;
+	uint64_t lastStep = 0;
+	size_t   entryCount = 0;
+	std::vector<uint8_t> bytes; // Encoding buffer reused by every entry, so that recording doesn't allocate once it has grown.
+
+	void Write(const ReplayEntry& entry);
+
+public:
+	ReplayRecorder() = default;
+	ReplayRecorder(const ReplayRecorder&) = delete;
+	ReplayRecorder& operator=(const ReplayRecorder&) = delete;
+	~ReplayRecorder() { Close(); }
+
+	// Returns false if the file couldn't be opened.
+	bool Open (const std::string& path, const ReplayHeader& header);
+	void Close();
+
+	void RecordCommand   (const uint64_t& step, const SceneCommand& command);
+	void RecordStepRate  (const uint64_t& step, const float& stepRate);
+	void RecordCheckpoint(const uint64_t& step, const uint64_t& checksum); // Also flushes the file.
+
+	bool   IsOpen       () const { return file != nullptr; }
+	size_t GetEntryCount() const { return entryCount;      }
+};
+
+struct Replay
+{
+	ReplayHeader             header;
+	std::vector<ReplayEntry> entries; // Ordered by step.
+
+	// Returns false if the file isn't a replay of this version. A replay cut in the middle of an entry keeps the entries before it.
+	bool Load(const std::string& path);
+
+	uint64_t GetStepCount() const { return entries.empty() ? 0 : entries.back().step; }
+};
+
+// Re-drives a scene with the entries of a replay, one simulation step at a time, and checks its checksum at every checkpoint.
+// The scene must have been created and initialized from the replay's header.
+class ReplayPlayer
+{
+private:
+	const Replay& replay;
+	size_t   nextEntry = 0;
+	uint64_t step      = 0;
+	float    stepRate;
+	size_t   commandCount    = 0;
+	size_t   checkpointCount = 0;
+	size_t   mismatchCount   = 0;
+	uint64_t firstMismatchStep = 0;
+
+public:
+	ReplayPlayer(const Replay& _replay) : replay(_replay), stepRate(_replay.header.stepRate) {}
+
+	void ApplyEntries(Scene& scene);                   // Applies the entries of the current step.
+	void Step(Scene& scene, Physics::JobSystem& jobs); // Applies the entries of the current step, then runs it.
+
+	bool     IsFinished          () const { return step >= replay.GetStepCount(); } // The entries of the last step still need to be applied.
+	uint64_t GetStep             () const { return step;              }
+	float    GetStepRate         () const { return stepRate;          }
+	size_t   GetCommandCount     () const { return commandCount;      }
+	size_t   GetCheckpointCount  () const { return checkpointCount;   }
+	size_t   GetMismatchCount    () const { return mismatchCount;     }
+	uint64_t GetFirstMismatchStep() const { return firstMismatchStep; }
+};
@@ -0,0 +1,78 @@
+#pragma once
+#include "Cannon.h"
+#include "Star.h"
+#include "ParticleManager.h"
+#include "Canvas.h"
+#include "Physics/JobSystem.h"
+#include <vector>
+
+constexpr size_t STAR_COUNT = 100;
+
+enum class SceneCommandType : uint8_t {
+	SHOOT,
+	CLEAR_PROJECTILES,
+	SET_ROTATION,          // rad
+	SET_HEIGHT,            // Height of the cannon above its default position (px).
+	SET_POWDER_CHARGE,
+	SET_BARREL_LENGTH,
+	SET_PROJECTILE_RADIUS,
+	SET_PROJECTILE_MASS,
+	SET_DRAG_PREDICTION_MODE,
+	SET_AUTOMATIC_ROTATION,
+	SET_APPLY_RECOIL,
+	SET_APPLY_DRAG,        // Also turns collisions off.
+	SET_APPLY_COLLISIONS,  // Also turns drag off.
+	SET_USE_SPATIAL_GRID,
+	SET_SHOW_TRAJECTORY,
+	SET_SHOW_MEASUREMENTS,
+	SET_SHOW_PROJECTILE_TRAJECTORIES,
+};
+constexpr size_t SCENE_COMMAND_TYPE_COUNT = 17;
+
+// Change made to the scene from the UI.
+// Besides the seed, commands are the only inputs of the simulation, so recording them is enough to replay a session.
+struct SceneCommand
+{
+	SceneCommandType type;
+	float value = 0; // New value of the setting: 0 or 1 for toggles, the index of modes.
+};
+
+// Everything that is simulated and drawn: the stars, the cannon and its cannonballs, the particles and the ground.
+// It doesn't depend on raylib so that the app and the headless renderer draw the same scene.
+class Scene
+{
+private:
+	Maths::Vector2              screenSize;
+	uint64_t                    seed;
+	float                       groundHeight = 0;
+	std::vector<Star>           stars;
+	std::vector<Maths::Vector2> starDrawPositions;
+	FrameArena                  frameArena; // Transient data of the foreground, freed each time it is drawn.
+
+public:
+	ParticleManager particleManager;
+	Cannon          cannon;
+
+	Scene(const uint64_t& _seed); // Seeds all the random numbers of the scene.
+
+	// Places the stars, the ground and the cannon on a screen of the given size.
+	void Init(const Maths::Vector2& _screenSize);
+
+	void Update(const float& deltaTime, Physics::JobSystem& jobs);
+	void BuildDrawLists(const float& alpha, Physics::JobSystem& jobs); // Alpha interpolates between the positions before and after the last update.
+
+	// The background (stars and particles) is drawn from the draw lists, so it can be drawn while the next update runs.
+	// The foreground (trajectories, cannon, cannonballs, ground and measurements) reads the simulation.
+	void DrawBackground(Canvas& canvas) const;
+	void DrawForeground(Canvas& canvas, const float& alpha);
+
+	void Execute(const SceneCommand& command);
+
+	// Hash of the simulated state of the cannon, cannonballs and particles (not of what is only drawn), to check that replays give the same simulation.
+	uint64_t GetChecksum() const;
+
+	const FrameArena& GetFrameArena() const { return frameArena; }
+
+	Maths::Vector2 GetScreenSize  () const { return screenSize;   }
+	float          GetGroundHeight() const { return groundHeight; }
+};
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "Canvas.h"
+#include "PostProcess.h"
+
+// Canvas that rasterizes on the CPU into a frame image, to draw the scene without a window.
+// Shapes are split in triangles like raylib does (same circle segments, bezier divisions and line quads),
+// and a pixel is covered when its center is inside a triangle. Edges shared by two triangles only cover their pixels once.
+// Text uses a small built-in font that only has the characters of the scene's measurements (digits, '.', '-', 's', 'p' and 'x').
+class SoftwareCanvas : public Canvas
+{
+private:
+	FrameImage& frame;
+
+	void BlendPixel   (uint8_t* pixel, const CanvasColor& color) const;
+	void FillTriangle (Maths::Vector2 a, Maths::Vector2 b, Maths::Vector2 c, const CanvasColor& color);
+	void FillRectangle(const float& x, const float& y, const float& width, const float& height, const CanvasColor& color);
+
+public:
+	SoftwareCanvas(FrameImage& _frame) : frame(_frame) {}
+
+	void Clear(const CanvasColor& color);
+
+	void DrawLine             (const Maths::Vector2& start, const Maths::Vector2& end, const float& thickness, const CanvasColor& color) override;
+	void DrawBezierQuad       (const Maths::Vector2& start, const Maths::Vector2& end, const Maths::Vector2& control, const float& thickness, const CanvasColor& color) override;
+	void DrawBezierCubic      (const Maths::Vector2& start, const Maths::Vector2& end, const Maths::Vector2& startControl, const Maths::Vector2& endControl, const float& thickness, const CanvasColor& color) override;
+	void DrawTriangle         (const Maths::Vector2& a, const Maths::Vector2& b, const Maths::Vector2& c, const CanvasColor& color) override;
+	void DrawRectangle        (const Maths::Vector2& position, const Maths::Vector2& size, const CanvasColor& color) override;
+	void DrawCircle           (const Maths::Vector2& center, const float& radius, const CanvasColor& color) override;
+	void DrawCircleLines      (const Maths::Vector2& center, const float& radius, const CanvasColor& color) override;
+	void DrawCircleSector     (const Maths::Vector2& center, const float& radius, const float& startAngle, const float& endAngle, const int& segments, const CanvasColor& color) override;
+	void DrawCircleSectorLines(const Maths::Vector2& center, const float& radius, const float& startAngle, const float& endAngle, const int& segments, const CanvasColor& color) override;
+	void DrawPoly             (const Maths::Vector2& center, const int& sides, const float& radius, const float& rotation, const CanvasColor& color) override;
+	void DrawText             (const char* text, const Maths::Vector2& position, const int& fontSize, const CanvasColor& color) override;
+	int  MeasureText          (const char* text, const int& fontSize) const override;
+	void DrawParticles        (const ParticleGeometry& geometry) override;
+};
@@ -1,6 +1,7 @@
 ﻿#pragma once
 #include "Vector2.h"
-#include "raylib.h"
+#include "Random.h"
+#include "Canvas.h"
 
 class Star
 {
@@ -9,12 +10,15 @@ private:
     
 public:
     Maths::Vector2 position;
+    Maths::Vector2 prevPosition; // Position before the last update, to interpolate drawing between updates.
     Maths::Vector2 velocity;
     int   radius = 0;
-    Color color  = {};
+    CanvasColor color = {};
 
-    Star(const Maths::Vector2& _screenSize);
+    Star(const Maths::Vector2& _screenSize, Maths::Random& rng);
 
     void Update(const float& deltaTime);
-    void Draw() const;
+    void Draw(Canvas& canvas, const Maths::Vector2& drawPosition) const;
+
+    Maths::Vector2 GetDrawPosition(const float& alpha) const; // Interpolated between the positions before and after the last update.
 };
@@ -0,0 +1,24 @@
+#version 100
+
+precision highp float;
+
+// Input vertex attributes (from vertex shader).
+varying vec2 fragTexCoord;
+varying vec4 fragColor;
+
+// Input uniform values.
+uniform sampler2D texture0;
+uniform vec4      colDiffuse;
+uniform vec2      texelSize; // Size of a texel of the source texture, twice as big as the destination.
+
+void main()
+{
+    // Average 4 bilinear samples one texel away diagonally, which covers the 4x4 source texels around this pixel.
+    vec4 sum = texture2D(texture0, fragTexCoord + vec2(-1.0, -1.0) * texelSize)
+             + texture2D(texture0, fragTexCoord + vec2( 1.0, -1.0) * texelSize)
+             + texture2D(texture0, fragTexCoord + vec2(-1.0,  1.0) * texelSize)
+             + texture2D(texture0, fragTexCoord + vec2( 1.0,  1.0) * texelSize);
+
+    // Calculate final fragment color.
+    gl_FragColor = vec4(sum.rgb * 0.25, 1.0) * colDiffuse;
+}
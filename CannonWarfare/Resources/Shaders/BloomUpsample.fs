@@ -0,0 +1,28 @@
+#version 100
+
+precision highp float;
+
+// Input vertex attributes (from vertex shader).
+varying vec2 fragTexCoord;
+varying vec4 fragColor;
+
+// Input uniform values.
+uniform sampler2D texture0;
+uniform vec4      colDiffuse;
+uniform vec2      texelSize; // Size of a texel of the source texture, smaller than the destination.
+uniform float     intensity;
+
+void main()
+{
+    // Do a 3x3 tent filter of bilinear samples to smooth the enlarged texels.
+    vec4 sum = vec4(0.0);
+    for (float x = -1.0; x <= 1.0; x++) {
+        for (float y = -1.0; y <= 1.0; y++)
+        {
+            sum += (2.0 - abs(x)) * (2.0 - abs(y)) * texture2D(texture0, fragTexCoord + vec2(x, y) * texelSize);
+        }
+    }
+
+    // Calculate final fragment color.
+    gl_FragColor = vec4(sum.rgb * intensity / 16.0, 1.0) * colDiffuse;
+}
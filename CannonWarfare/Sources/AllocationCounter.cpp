@@ -0,0 +1,57 @@
+#include "AllocationCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+
+static std::atomic<uint64_t> allocationCount = 0;
+static std::atomic<uint64_t> allocatedBytes  = 0;
+
+uint64_t AllocationCounter::GetCount() { return allocationCount.load(std::memory_order_relaxed); }
+uint64_t AllocationCounter::GetBytes() { return allocatedBytes .load(std::memory_order_relaxed); }
+
+static void* Allocate(std::size_t size)
+{
+    allocationCount.fetch_add(1,    std::memory_order_relaxed);
+    allocatedBytes .fetch_add(size, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+static void* AllocateAligned(std::size_t size, const std::align_val_t& alignment)
+{
+    allocationCount.fetch_add(1,    std::memory_order_relaxed);
+    allocatedBytes .fetch_add(size, std::memory_order_relaxed);
+    const std::size_t align = (std::size_t)alignment;
+#ifdef _MSC_VER
+    return _aligned_malloc(size ? size : 1, align);
+#else
+    return std::aligned_alloc(align, (size + align - 1) / align * align); // The size must be a multiple of the alignment.
+#endif
+}
+
+static void FreeAligned(void* pointer)
+{
+#ifdef _MSC_VER
+    _aligned_free(pointer);
+#else
+    std::free(pointer);
+#endif
+}
+
+void* operator new  (std::size_t size) { if (void* pointer = Allocate(size)) return pointer; throw std::bad_alloc(); }
+void* operator new[](std::size_t size) { if (void* pointer = Allocate(size)) return pointer; throw std::bad_alloc(); }
+void* operator new  (std::size_t size, const std::nothrow_t&) noexcept { return Allocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return Allocate(size); }
+void  operator delete  (void* pointer) noexcept { std::free(pointer); }
+void  operator delete[](void* pointer) noexcept { std::free(pointer); }
+void  operator delete  (void* pointer, std::size_t) noexcept { std::free(pointer); }
+void  operator delete[](void* pointer, std::size_t) noexcept { std::free(pointer); }
+
+void* operator new  (std::size_t size, std::align_val_t alignment) { if (void* pointer = AllocateAligned(size, alignment)) return pointer; throw std::bad_alloc(); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { if (void* pointer = AllocateAligned(size, alignment)) return pointer; throw std::bad_alloc(); }
+void* operator new  (std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return AllocateAligned(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return AllocateAligned(size, alignment); }
+void  operator delete  (void* pointer, std::align_val_t) noexcept { FreeAligned(pointer); }
+void  operator delete[](void* pointer, std::align_val_t) noexcept { FreeAligned(pointer); }
+void  operator delete  (void* pointer, std::size_t, std::align_val_t) noexcept { FreeAligned(pointer); }
+void  operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept { FreeAligned(pointer); }
@@ -1,19 +1,32 @@
-#include "App.h"
+﻿#include "App.h"
 #include "Graphics.h"
 #include "RaylibConversions.h"
+#include "Profiler.h"
+#include "AllocationCounter.h"
 #include <rlImGui.h>
+#include <algorithm>
+#include <cstring>
 
 using namespace Maths;
 
 
-App::App(const Maths::Vector2& _screenSize, const int& _targetFPS)
-    : screenSize(_screenSize), targetFPS(_targetFPS), targetDeltaTime(1.f / targetFPS), cannon(particleManager, groundHeight)
+static float GetMillisecondsSince(const std::chrono::steady_clock::time_point& start)
 {
-    startTime = std::chrono::system_clock::now();
+    return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+App::App(const Maths::Vector2& _screenSize, const int& _targetFPS, const uint64_t& _replaySeed, const std::string& recordPath)
+    : screenSize(_screenSize), targetFPS(_targetFPS), targetDeltaTime(1.f / targetFPS), replaySeed(_replaySeed), scene(_replaySeed)
+{
+    Profiler::SetThreadName("Main");
+    startTime     = std::chrono::system_clock::now();
+    lastFrameTime = std::chrono::steady_clock::now();
 
 	// Initialize Raylib.
     InitWindow(screenSize.x <= 0 ? 1728 : (int)screenSize.x, screenSize.y <= 0 ? 972 : (int)screenSize.y, "Cannon Warfare");
     SetTargetFPS(targetFPS);
+    TraceLog(LOG_INFO, "APP: Replay seed: %llu (run with --seed %llu to replay)", (unsigned long long)replaySeed, (unsigned long long)replaySeed);
 
     // Set window size to the monitor size.
     if (screenSize.x <= 0 || screenSize.y <= 0)
@@ -39,23 +52,26 @@ App::App(const Maths::Vector2& _screenSize, const int& _targetFPS)
     // Initialize the app graphics.
     graphics = new Graphics(screenSize);
 
-    // Initialize the stars.
-    stars.reserve(STAR_COUNT);
-    for (size_t i = 0; i < STAR_COUNT; ++i)
-        stars.emplace_back(screenSize);
-
-    // Set the ground height.
-    groundHeight = screenSize.y - 100;
+    // Initialize the stars, the ground and the cannon.
+    scene.Init(screenSize);
+    BuildDrawLists(1);
 
-    // Set the cannon's default position, rotation and shooting velocity.
-    cannon.SetPosition ({ 90, screenSize.y - 150 });
-    cannon.SetAnchorPos({ 90, screenSize.y - 150 });
-    cannon.SetRotation(-PI / 5);
+    // Start recording the replay.
+    if (!recordPath.empty())
+    {
+        if (recorder.Open(recordPath, { replaySeed, screenSize, timestep.GetStepRate() }))
+            TraceLog(LOG_INFO, "APP: Recording replay to %s", recordPath.c_str());
+        else
+            TraceLog(LOG_WARNING, "APP: Can't record replay to %s", recordPath.c_str());
+    }
 }
 
 App::~App()
 {
+    if (recorder.IsOpen())
+        recorder.RecordCheckpoint(timestep.GetStepCount(), scene.GetChecksum());
     delete graphics;
+    canvas.Unload();
     ImGui::SaveIniSettingsToDisk("Resources/imgui.ini");
     ShutdownRLImGui();
     CloseWindow();
@@ -68,32 +84,117 @@ float App::GetTimeSinceStart()
 }
 
 
+void App::Frame()
+{
+    Profiler::MarkFrame();
+    PROFILE_ZONE("App::Frame");
+
+    // Measure the real time elapsed since the last frame.
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    const double frameTime = std::chrono::duration<double>(now - lastFrameTime).count();
+    lastFrameTime = now;
+
+    // Record the last frame's parts with the time it really took, waiting for the target frame rate included.
+    if (frameSampled)
+    {
+        frameSample[FrameParts::TOTAL] = (float)(frameTime * 1000);
+        frameTimes.Record(frameSample);
+    }
+    frameSample  = {};
+    frameSampled = true;
+
+    const uint64_t allocationCount = AllocationCounter::GetCount();
+    lastFrameAllocations = allocationCount - frameAllocationStart;
+    frameAllocationStart = allocationCount;
+
+    // Run the simulation steps that fit in that time and draw between the last two.
+    // When overlapping, the simulation runs while the stars and particles of the last frame are drawn, so they are shown one frame late.
+    lastFrameSteps = timestep.Advance(frameTime);
+    const int   steps = lastFrameSteps;
+    const float alpha = timestep.GetAlpha();
+    Physics::JobCounter simulation;
+    if (overlapSimulation)
+    {
+        jobs.Run(simulation, [this, steps]()
+        {
+            const std::chrono::steady_clock::time_point updateStart = std::chrono::steady_clock::now();
+            for (int i = 0; i < steps; i++)
+                Update(timestep.GetStep());
+            frameSample[FrameParts::UPDATE] = GetMillisecondsSince(updateStart);
+        });
+        Draw(alpha, simulation);
+        BuildDrawLists(alpha);
+    }
+    else
+    {
+        const std::chrono::steady_clock::time_point updateStart = std::chrono::steady_clock::now();
+        for (int i = 0; i < steps; i++)
+            Update(timestep.GetStep());
+        frameSample[FrameParts::UPDATE] = GetMillisecondsSince(updateStart);
+        BuildDrawLists(alpha);
+        Draw(alpha, simulation);
+    }
+
+    // The simulation is done with this frame's steps, record the state it reached.
+    if (recorder.IsOpen() && timestep.GetStepCount() >= nextCheckpointStep)
+    {
+        recorder.RecordCheckpoint(timestep.GetStepCount(), scene.GetChecksum());
+        nextCheckpointStep = timestep.GetStepCount() + REPLAY_CHECKPOINT_INTERVAL;
+    }
+}
+
+void App::Execute(const SceneCommand& command)
+{
+    if (recorder.IsOpen())
+        recorder.RecordCommand(timestep.GetStepCount(), command);
+    scene.Execute(command);
+}
+
 void App::Update(const float& deltaTime)
 {
-    for (Star& star : stars)
-        star.Update(deltaTime);
-    cannon.Update(deltaTime);
-    particleManager.Update(deltaTime);
+    PROFILE_ZONE("App::Update");
+    scene.Update(deltaTime, jobs);
+}
+
+void App::BuildDrawLists(const float& alpha)
+{
+    PROFILE_ZONE("App::BuildDrawLists");
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    scene.BuildDrawLists(alpha, jobs);
+    frameSample[FrameParts::DRAW] += GetMillisecondsSince(start);
 }
 
-void App::Draw()
+void App::Draw(const float& alpha, Physics::JobCounter& simulation)
 {
+    PROFILE_ZONE("App::Draw");
+    // The wait for the simulation isn't part of the drawing time.
     graphics->BeginDrawing();
     {
-        for (const Star& star : stars) star.Draw(); // Draw stars.
-        particleManager.Draw();
-        cannon.DrawTrajectories();
-        cannon.Draw();
-        DrawRectangle(0, (int)groundHeight, (int)screenSize.x, (int)(screenSize.y - groundHeight), BLACK); // Draw ground.
-        cannon.DrawMeasurements();
-        DrawLine(0, (int)groundHeight, (int)screenSize.x, (int)groundHeight, WHITE); // Draw ground top.
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        scene.DrawBackground(canvas);
+        frameSample[FrameParts::DRAW] += GetMillisecondsSince(start);
+        jobs.Wait(simulation);
+
+        start = std::chrono::steady_clock::now();
+        scene.DrawForeground(canvas, alpha);
+        frameSample[FrameParts::DRAW] += GetMillisecondsSince(start);
+
+        start = std::chrono::steady_clock::now();
         DrawUi();
+        frameSample[FrameParts::UI] = GetMillisecondsSince(start);
     }
+    const std::chrono::steady_clock::time_point postProcessStart = std::chrono::steady_clock::now();
+    graphics->PostProcess();
+    frameSample[FrameParts::POST_PROCESS] = GetMillisecondsSince(postProcessStart);
     graphics->EndDrawing();
 }
 
 void App::DrawUi()
 {
+    PROFILE_ZONE("App::DrawUi");
+    Cannon&          cannon          = scene.cannon;
+    ParticleManager& particleManager = scene.particleManager;
+
     BeginRLImGui();
     {
         // Stats window.
@@ -101,12 +202,76 @@ void App::DrawUi()
         {
             ImGui::SetWindowPos({ screenSize.x - ImGui::GetWindowWidth(), 1 });
             
-            ImGui::Checkbox("Show predicted trajectory", &cannon.showTrajectory);
-            ImGui::Checkbox("Show predicted measurements", &cannon.showMeasurements);
-            ImGui::Checkbox("Show cannonball trajectories", &cannon.showProjectileTrajectories);
+            bool showTrajectory             = cannon.showTrajectory;
+            bool showMeasurements           = cannon.showMeasurements;
+            bool showProjectileTrajectories = cannon.showProjectileTrajectories;
+            if (ImGui::Checkbox("Show predicted trajectory",    &showTrajectory))             Execute({ SceneCommandType::SET_SHOW_TRAJECTORY,              (float)showTrajectory });
+            if (ImGui::Checkbox("Show predicted measurements",  &showMeasurements))           Execute({ SceneCommandType::SET_SHOW_MEASUREMENTS,            (float)showMeasurements });
+            if (ImGui::Checkbox("Show cannonball trajectories", &showProjectileTrajectories)) Execute({ SceneCommandType::SET_SHOW_PROJECTILE_TRAJECTORIES, (float)showProjectileTrajectories });
             
-            const int fps = GetFPS();
-            ImGui::Text("FPS: %d | Delta Time: %.2f", fps, 1.f / fps);
+            const float lastFrameMs = frameTimes.GetSize() > 0 ? frameTimes.GetLast()[FrameParts::TOTAL] : 0;
+            ImGui::Text("FPS: %d | Last frame: %.2f ms", GetFPS(), lastFrameMs);
+            ImGui::Text("Heap allocations: %llu last frame, %llu in total", (unsigned long long)lastFrameAllocations, (unsigned long long)AllocationCounter::GetCount());
+            ImGui::Text("Frame arena: %zu / %zu bytes (peak %zu)", scene.GetFrameArena().GetUsed(), scene.GetFrameArena().GetCapacity(), scene.GetFrameArena().GetHighWater());
+            ImGui::Text("Replay seed: %llu", (unsigned long long)replaySeed);
+            ImGui::SameLine();
+            if (ImGui::SmallButton("Copy"))
+                SetClipboardText(TextFormat("%llu", (unsigned long long)replaySeed));
+            if (recorder.IsOpen())
+                ImGui::Text("Recording replay: %zu entries", recorder.GetEntryCount());
+
+            // Simulation rate.
+            static int stepRateIndex = 1; // 60, 120 or 240 Hz.
+            static int maxSubsteps   = timestep.GetMaxSubsteps();
+            ImGui::PushItemWidth(80);
+            if (ImGui::Combo("Simulation rate (Hz)", &stepRateIndex, "60\0" "120\0" "240\0")) {
+                timestep.SetStepRate(60.f * (1 << stepRateIndex));
+                if (recorder.IsOpen())
+                    recorder.RecordStepRate(timestep.GetStepCount(), timestep.GetStepRate());
+            }
+            if (ImGui::DragInt("Max substeps", &maxSubsteps, 0.1f, 1, 32))
+                timestep.SetMaxSubsteps(maxSubsteps);
+            ImGui::PopItemWidth();
+            ImGui::Text("Steps this frame: %d | Dropped time: %.2fs", lastFrameSteps, timestep.GetDroppedTime());
+
+            // Multithreading.
+            static int workerCount = (int)jobs.GetWorkerCount();
+            ImGui::PushItemWidth(80);
+            if (ImGui::DragInt("Worker threads", &workerCount, 0.1f, 0, 63))
+                jobs.SetWorkerCount((size_t)(workerCount < 0 ? 0 : workerCount));
+            ImGui::PopItemWidth();
+            ImGui::Checkbox("Overlap simulation and drawing", &overlapSimulation);
+            ImGui::Text("Particles: %zu / %zu (peak %zu, dropped %zu)", particleManager.GetParticleCount(), MAX_PARTICLES,
+                        particleManager.GetParticleHighWater(), particleManager.GetDroppedParticles());
+            ImGui::Text("Spawners: %zu / %zu (peak %zu)", particleManager.GetSpawnerCount(), MAX_PARTICLE_SPAWNERS, particleManager.GetSpawnerHighWater());
+            ImGui::Text("Particle vertices: %zu | Draw calls: %zu", particleManager.GetDrawGeometry().GetVertexCount(), canvas.GetParticleRenderer().GetLastDrawCalls());
+            ImGui::Text("Label layouts: %zu cached, %zu laid out", canvas.GetGlyphRunHits(), canvas.GetGlyphRunMisses());
+
+            // Particle integrator selection.
+            if (ImGui::BeginCombo("Integrator", Maths::GetIntegratorBackendName(particleManager.integratorBackend)))
+            {
+                for (const Maths::IntegratorBackend backend : { Maths::IntegratorBackend::SCALAR, Maths::IntegratorBackend::SSE, Maths::IntegratorBackend::AVX2 })
+                    if (Maths::IsIntegratorBackendSupported(backend) && ImGui::Selectable(Maths::GetIntegratorBackendName(backend), backend == particleManager.integratorBackend))
+                        particleManager.integratorBackend = backend;
+                ImGui::EndCombo();
+            }
+
+            // Bloom.
+            BloomSettings& bloom = graphics->bloom;
+            int bloomMode = (int)bloom.mode;
+            ImGui::PushItemWidth(80);
+            if (ImGui::Combo("Bloom", &bloomMode, "Blur passes\0" "Mip chain\0"))
+                bloom.mode = (BloomModes)bloomMode;
+            if (bloom.mode == BloomModes::BLUR_PASSES) {
+                ImGui::DragInt("Blur passes", &bloom.blurPasses, 0.1f, 1, BLOOM_MAX_BLUR_PASSES);
+            }
+            else {
+                ImGui::DragInt("Mip levels", &bloom.mipLevels, 0.1f, 1, BLOOM_MAX_MIP_LEVELS);
+                ImGui::DragFloat("Glow intensity", &bloom.mipIntensity, 0.02f, 0, 8, "%.2f");
+            }
+            ImGui::PopItemWidth();
+            const BloomCost bloomCost = GetBloomCost(bloom, (int)screenSize.x, (int)screenSize.y);
+            ImGui::Text("Bloom: %d passes | %.1f Mpx written | %.1f M texel fetches", bloomCost.passes, bloomCost.pixelsWritten / 1e6, bloomCost.texelFetches / 1e6);
         }
         ImGui::End();
 
@@ -118,48 +283,64 @@ void App::DrawUi()
 
             static float powderCharge = cannon.GetPowderCharge();
             if (ImGui::DragFloat("Powder Charge (kg)", &powderCharge, 0.1f, 2, 10, "%.1f"))
-                cannon.SetPowderCharge(clamp(powderCharge, 2, 10));
+                Execute({ SceneCommandType::SET_POWDER_CHARGE, clamp(powderCharge, 2, 10) });
 
             static float barrelLength = cannon.GetBarrelLength();
             if (ImGui::DragFloat("Barrel Length (px)", &barrelLength, 2, 500, 2500, "%.0f"))
-                cannon.SetBarrelLength(clamp(barrelLength, 500, 2500));
+                Execute({ SceneCommandType::SET_BARREL_LENGTH, clamp(barrelLength, 500, 2500) });
 
             static float projectileRadius = cannon.GetProjectileRadius();
             if (ImGui::DragFloat("Projectile Radius (px)", &projectileRadius, 0.5f, 5, 50, "%.0f"))
-                cannon.SetProjectileRadius(clamp(projectileRadius, 5, 50));
+                Execute({ SceneCommandType::SET_PROJECTILE_RADIUS, clamp(projectileRadius, 5, 50) });
 
             static float projectileMass = cannon.GetProjectileMass();
             if (ImGui::DragFloat("Projectile Mass (kg)", &projectileMass, 0.2f, 2, 50, "%.1f"))
-                cannon.SetProjectileMass(clamp(projectileMass, 2, 50));
+                Execute({ SceneCommandType::SET_PROJECTILE_MASS, clamp(projectileMass, 2, 50) });
 
             static float height = 0;
-            if (ImGui::DragFloat("Height (px)", &height, 0.5f, 0.f, screenSize.y - 250, "%.0f")) {
-                cannon.SetAnchorPos({ cannon.GetAnchorPos().x, screenSize.y - 150 - height });
-                cannon.SetPosition (cannon.GetAnchorPos());
-            }
+            if (ImGui::DragFloat("Height (px)", &height, 0.5f, 0.f, screenSize.y - 250, "%.0f"))
+                Execute({ SceneCommandType::SET_HEIGHT, height });
 
             static float rotation = -radToDeg(cannon.GetRotation());
             if (!cannon.automaticRotation && ImGui::DragFloat("Rotation (deg)", &rotation, 0.1f, -89.9f, 89.9f, "%.1f"))
-                cannon.SetRotation(-degToRad(clamp(rotation, -89.9f, 89.9f)));
+                Execute({ SceneCommandType::SET_ROTATION, -degToRad(clamp(rotation, -89.9f, 89.9f)) });
 
-            if (ImGui::Checkbox("Automatic rotation", &cannon.automaticRotation))
+            bool automaticRotation = cannon.automaticRotation;
+            if (ImGui::Checkbox("Automatic rotation", &automaticRotation)) {
+                Execute({ SceneCommandType::SET_AUTOMATIC_ROTATION, (float)automaticRotation });
                 rotation = -radToDeg(cannon.GetRotation());
+            }
+
+            // Aim at a target distance.
+            static float targetDistance = 1000;
+            ImGui::DragFloat("Target distance (px)", &targetDistance, 2, 50, 5000, "%.0f");
+            const Physics::FiringAngles& angles = cannon.GetFiringAngles(targetDistance);
+            if (!angles.reachable)
+                ImGui::Text("Target out of range");
+            else
+            {
+                ImGui::Text("Low: %.1f deg | High: %.1f deg", -radToDeg(angles.low), -radToDeg(angles.high));
+                ImGui::SameLine();
+                if (ImGui::Button("Aim low"))  { Execute({ SceneCommandType::SET_AUTOMATIC_ROTATION, 0 }); Execute({ SceneCommandType::SET_ROTATION, angles.low  }); rotation = -radToDeg(angles.low);  }
+                ImGui::SameLine();
+                if (ImGui::Button("Aim high")) { Execute({ SceneCommandType::SET_AUTOMATIC_ROTATION, 0 }); Execute({ SceneCommandType::SET_ROTATION, angles.high }); rotation = -radToDeg(angles.high); }
+            }
 
             if (ImGui::Button("Shoot"))
-                cannon.Shoot();
+                Execute({ SceneCommandType::SHOOT });
 
             ImGui::SameLine();
             if (ImGui::Button("Clear"))
-                cannon.ClearProjectiles();
+                Execute({ SceneCommandType::CLEAR_PROJECTILES });
 
             ImGui::SameLine();
             if (ImGui::Button("Reset"))
             {
-                const CannonProperties defaults;
-                cannon.SetPowderCharge(defaults.powderCharge);
-                cannon.SetBarrelLength(defaults.barrelLength);
-                cannon.SetProjectileRadius(defaults.projectileRadius);
-                cannon.SetProjectileMass(defaults.projectileMass);
+                const Physics::CannonProperties defaults;
+                Execute({ SceneCommandType::SET_POWDER_CHARGE,     defaults.powderCharge     });
+                Execute({ SceneCommandType::SET_BARREL_LENGTH,     defaults.barrelLength     });
+                Execute({ SceneCommandType::SET_PROJECTILE_RADIUS, defaults.projectileRadius });
+                Execute({ SceneCommandType::SET_PROJECTILE_MASS,   defaults.projectileMass   });
                 powderCharge     = defaults.powderCharge;
                 barrelLength     = defaults.barrelLength;
                 projectileRadius = defaults.projectileRadius;
@@ -177,16 +358,208 @@ void App::DrawUi()
             ImGui::Text("Landing distance: %.0f pixels", cannon.GetLandingDistance());
             ImGui::Text("Maximum height: %.0f pixels",   cannon.GetMaxHeight());
             
-            ImGui::Checkbox("Apply recoil", &cannon.applyRecoil);
-            if (ImGui::Checkbox("Apply drag", &cannon.applyDrag)) {
-                cannon.applyCollisions = false;
-                cannon.SetRotation(cannon.GetRotation());
-            }
-            if (ImGui::Checkbox("Apply collisions", &cannon.applyCollisions)) {
-                cannon.applyDrag = false;
+            bool applyRecoil     = cannon.applyRecoil;
+            bool applyDrag       = cannon.applyDrag;
+            bool applyCollisions = cannon.applyCollisions;
+            bool useSpatialGrid  = cannon.useSpatialGrid;
+            if (ImGui::Checkbox("Apply recoil", &applyRecoil)) Execute({ SceneCommandType::SET_APPLY_RECOIL, (float)applyRecoil });
+            if (ImGui::Checkbox("Apply drag",   &applyDrag))   Execute({ SceneCommandType::SET_APPLY_DRAG,   (float)applyDrag   });
+            if (cannon.applyDrag)
+            {
+                const Physics::TrajectoryPredictor& predictor = cannon.GetTrajectoryPredictor();
+                ImGui::PushItemWidth(80);
+                if (ImGui::BeginCombo("Drag prediction", Physics::GetDragPredictionModeName(predictor.mode)))
+                {
+                    for (const Physics::DragPredictionMode mode : { Physics::DragPredictionMode::EULER, Physics::DragPredictionMode::RK45, Physics::DragPredictionMode::CACHED })
+                        if (ImGui::Selectable(Physics::GetDragPredictionModeName(mode), mode == predictor.mode))
+                            Execute({ SceneCommandType::SET_DRAG_PREDICTION_MODE, (float)mode });
+                    ImGui::EndCombo();
+                }
+                ImGui::PopItemWidth();
+                if (predictor.mode == Physics::DragPredictionMode::CACHED)
+                    ImGui::Text("Cached samples: %zu (%zu hits, %zu misses)", predictor.GetSampleCount(), predictor.GetHitCount(), predictor.GetMissCount());
             }
+            if (ImGui::Checkbox("Apply collisions", &applyCollisions))
+                Execute({ SceneCommandType::SET_APPLY_COLLISIONS, (float)applyCollisions });
+            if (cannon.applyCollisions && ImGui::Checkbox("Use spatial grid", &useSpatialGrid))
+                Execute({ SceneCommandType::SET_USE_SPATIAL_GRID, (float)useSpatialGrid });
         }
         ImGui::End();
+
+        DrawProfiler();
+        DrawFrameTimes();
     }
     EndRLImGui();
 }
+
+void App::DrawProfiler()
+{
+    ImGui::SetNextWindowPos ({ 1, screenSize.y - 301 }, ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowSize({ screenSize.x / 2, 300 }, ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowCollapsed(true, ImGuiCond_FirstUseEver);
+    if (!ImGui::Begin("Profiler"))
+    {
+        ImGui::End();
+        return;
+    }
+
+#if !PROFILING
+    ImGui::TextUnformatted("Profiling zones are compiled out of release builds, build with PROFILING=1 to keep them.");
+#else
+    // Keep the zones of the last frame, unless paused to look at one.
+    static bool paused = false;
+    static std::vector<ProfileThread> frameThreads;
+    static uint64_t frameStart = 0, frameEnd = 1;
+    ImGui::Checkbox("Pause", &paused);
+    if (!paused && Profiler::GetLastFrame(frameStart, frameEnd))
+        frameThreads = Profiler::Collect(frameStart, frameEnd);
+    ImGui::SameLine();
+    ImGui::Text("Frame: %.2f ms", (frameEnd - frameStart) / 1e6);
+
+    // Export every zone still in the ring buffers.
+    static const char* exportMessage = "";
+    ImGui::SameLine();
+    if (ImGui::Button("Export Chrome trace"))
+        exportMessage = Profiler::WriteChromeTrace("profile_trace.json") ? "Written to profile_trace.json" : "Can't write profile_trace.json";
+    ImGui::SameLine();
+    ImGui::TextUnformatted(exportMessage);
+
+    // Timeline: each thread has a row per zone depth.
+    ImDrawList* drawList  = ImGui::GetWindowDrawList();
+    const float width     = ImGui::GetContentRegionAvail().x;
+    const float rowHeight = ImGui::GetTextLineHeight() + 2;
+    const double scale    = width / (double)std::max(frameEnd - frameStart, (uint64_t)1);
+    for (const ProfileThread& thread : frameThreads)
+    {
+        uint32_t depthCount = 0;
+        for (const ProfileZone& zone : thread.zones)
+            depthCount = std::max(depthCount, zone.depth + 1);
+
+        ImGui::TextUnformatted(thread.name.c_str());
+        const ImVec2 origin = ImGui::GetCursorScreenPos();
+        ImGui::Dummy({ width, rowHeight * depthCount });
+        for (const ProfileZone& zone : thread.zones)
+        {
+            const ImVec2 min = { origin.x + (float)((std::max(zone.start, frameStart) - frameStart) * scale), origin.y + zone.depth * rowHeight };
+            const ImVec2 max = { std::max(origin.x + (float)((std::min(zone.end, frameEnd) - frameStart) * scale), min.x + 1), min.y + rowHeight - 1 };
+
+            // Each zone name gets its own color.
+            uint32_t hash = 2166136261u;
+            for (const char* c = zone.name; *c; c++)
+                hash = (hash ^ (uint8_t)*c) * 16777619u;
+            drawList->AddRectFilled(min, max, IM_COL32(80 + hash % 120, 80 + (hash >> 8) % 120, 80 + (hash >> 16) % 120, 255));
+            drawList->PushClipRect(min, max, true);
+            drawList->AddText({ min.x + 2, min.y + 1 }, IM_COL32_WHITE, zone.name);
+            drawList->PopClipRect();
+            if (ImGui::IsMouseHoveringRect(min, max))
+                ImGui::SetTooltip("%s: %.3f ms", zone.name, (zone.end - zone.start) / 1e6);
+        }
+    }
+
+    // Totals of the frame's zones, the most expensive first.
+    struct ZoneTotal { const char* name; int count; uint64_t total, max; };
+    std::vector<ZoneTotal> totals;
+    for (const ProfileThread& thread : frameThreads)
+    {
+        for (const ProfileZone& zone : thread.zones)
+        {
+            const uint64_t duration = zone.end - zone.start;
+            auto total = std::find_if(totals.begin(), totals.end(), [&](const ZoneTotal& total) { return std::strcmp(total.name, zone.name) == 0; });
+            if (total == totals.end())
+                totals.push_back({ zone.name, 1, duration, duration });
+            else {
+                total->count++;
+                total->total += duration;
+                total->max    = std::max(total->max, duration);
+            }
+        }
+    }
+    std::sort(totals.begin(), totals.end(), [](const ZoneTotal& a, const ZoneTotal& b) { return a.total > b.total; });
+    if (ImGui::BeginTable("Zone totals", 4, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit))
+    {
+        ImGui::TableSetupColumn("Zone");
+        ImGui::TableSetupColumn("Count");
+        ImGui::TableSetupColumn("Total (ms)");
+        ImGui::TableSetupColumn("Max (ms)");
+        ImGui::TableHeadersRow();
+        for (const ZoneTotal& total : totals)
+        {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn(); ImGui::TextUnformatted(total.name);
+            ImGui::TableNextColumn(); ImGui::Text("%d",   total.count);
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", total.total / 1e6);
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", total.max   / 1e6);
+        }
+        ImGui::EndTable();
+    }
+#endif
+    ImGui::End();
+}
+
+void App::DrawFrameTimes()
+{
+    ImGui::SetNextWindowPos ({ screenSize.x / 2 + 1, screenSize.y - 301 }, ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowSize({ screenSize.x / 2 - 2, 300 }, ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowCollapsed(true, ImGuiCond_FirstUseEver);
+    if (!ImGui::Begin("Frame times"))
+    {
+        ImGui::End();
+        return;
+    }
+
+    ImGui::Text("Last %zu frames", frameTimes.GetSize());
+    ImGui::SameLine();
+    if (ImGui::Button("Clear"))
+        frameTimes.Clear();
+
+    // Dump the frames kept to look at them elsewhere.
+    static const char* dumpMessage = "";
+    ImGui::SameLine();
+    if (ImGui::Button("Dump CSV"))
+        dumpMessage = frameTimes.WriteCsv("frame_times.csv") ? "Written to frame_times.csv" : "Can't write frame_times.csv";
+    ImGui::SameLine();
+    ImGui::TextUnformatted(dumpMessage);
+
+    // Percentiles of each part.
+    FrameTimePercentiles percentiles[FRAME_PART_COUNT];
+    for (size_t part = 0; part < FRAME_PART_COUNT; part++)
+        percentiles[part] = frameTimes.GetPercentiles((FrameParts)part);
+    if (ImGui::BeginTable("Frame time percentiles", 5, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit))
+    {
+        ImGui::TableSetupColumn("Part");
+        ImGui::TableSetupColumn("p50 (ms)");
+        ImGui::TableSetupColumn("p95 (ms)");
+        ImGui::TableSetupColumn("p99 (ms)");
+        ImGui::TableSetupColumn("Max (ms)");
+        ImGui::TableHeadersRow();
+        for (size_t part = 0; part < FRAME_PART_COUNT; part++)
+        {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn(); ImGui::TextUnformatted(GetFramePartName((FrameParts)part));
+            ImGui::TableNextColumn(); ImGui::Text("%.2f", percentiles[part].p50);
+            ImGui::TableNextColumn(); ImGui::Text("%.2f", percentiles[part].p95);
+            ImGui::TableNextColumn(); ImGui::Text("%.2f", percentiles[part].p99);
+            ImGui::TableNextColumn(); ImGui::Text("%.2f", percentiles[part].max);
+        }
+        ImGui::EndTable();
+    }
+
+    // History of a part, where the hitches stand out, and how its times are distributed.
+    static int shownPart = (int)FrameParts::TOTAL;
+    ImGui::PushItemWidth(120);
+    ImGui::Combo("Part", &shownPart, "Total\0" "Update\0" "Draw\0" "Post-process\0" "UI\0");
+    ImGui::PopItemWidth();
+    const FrameParts part    = (FrameParts)shownPart;
+    const float      maxTime = std::max(percentiles[shownPart].max, 1.f);
+    const float      width   = ImGui::GetContentRegionAvail().x;
+
+    static std::vector<float> history;
+    frameTimes.GetHistory(part, history);
+    ImGui::PlotLines("##History", history.data(), (int)history.size(), 0, TextFormat("Target: %.2f ms", targetDeltaTime * 1000), 0, maxTime, { width, 80 });
+
+    static std::vector<float> bins(50);
+    frameTimes.GetHistogram(part, maxTime, bins);
+    ImGui::PlotHistogram("##Distribution", bins.data(), (int)bins.size(), 0, TextFormat("0 to %.2f ms", maxTime), 0, FLT_MAX, { width, 80 });
+
+    ImGui::End();
+}
@@ -0,0 +1,548 @@
+#include "Physics/Physics.h"
+#include "Maths/Maths.h"
+#include "Maths/MatrixBatch.h"
+#include "ParticleManager.h"
+#include "Profiler.h"
+#include "Scene.h"
+#include "NumberLabel.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+using namespace std::chrono;
+using namespace Maths;
+
+// Benchmark suite: times the simulation's hot paths and maths kernels, and reports their cost per operation.
+// Each benchmark is calibrated to run for at least --min-time seconds per repetition, then repeated to get the spread of the timings.
+struct BenchmarkParams
+{
+    std::string filter;              // Only runs the benchmarks whose name contains this.
+    int         repetitions  = 10;
+    double      minTime      = 0.05; // Seconds per repetition.
+    size_t      threadCount  = 1;    // Threads used by the benchmarks that run jobs, 1 runs them all on the main thread.
+    bool        list         = false;
+    std::string jsonPath;            // If not empty, the results are written there as JSON.
+    std::string baselinePath;        // If not empty, the results are compared to the ones of this JSON file.
+    double      maxRegression = 0;   // If not 0, fails when a benchmark is slower than its baseline by more than this percentage.
+};
+
+// An operation is run in a loop and returns the number of items it processed.
+// The setup isn't timed, it runs before each repetition so that every repetition starts from the same state.
+struct Benchmark
+{
+    std::string             name;
+    std::function<void()>   setup;
+    std::function<size_t()> operation;
+};
+
+struct BenchmarkResult
+{
+    std::string         name;
+    size_t              iterations = 0; // Operations per repetition.
+    double              itemsPerOp = 0;
+    std::vector<double> nsPerOp;        // One per repetition.
+    double median = 0, mean = 0, stddev = 0, min = 0, max = 0;
+};
+
+// Values written here can't be optimized out by the compiler.
+static volatile float sink = 0;
+
+static void PrintUsage(const char* program)
+{
+    std::printf("Usage: %s [--filter text] [--repetitions N] [--min-time seconds] [--threads N] [--list]\n"
+                "          [--json results.json] [--baseline results.json] [--max-regression percent]\n", program);
+}
+
+static bool ParseArgs(const int argc, char** argv, BenchmarkParams& params)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const bool hasValue = i + 1 < argc;
+        if      (!std::strcmp(argv[i], "--filter")         && hasValue) params.filter        = argv[++i];
+        else if (!std::strcmp(argv[i], "--repetitions")    && hasValue) params.repetitions   = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--min-time")       && hasValue) params.minTime       = std::strtod(argv[++i], nullptr);
+        else if (!std::strcmp(argv[i], "--threads")        && hasValue) params.threadCount   = std::max((size_t)1, (size_t)std::strtoull(argv[++i], nullptr, 10));
+        else if (!std::strcmp(argv[i], "--json")           && hasValue) params.jsonPath      = argv[++i];
+        else if (!std::strcmp(argv[i], "--baseline")       && hasValue) params.baselinePath  = argv[++i];
+        else if (!std::strcmp(argv[i], "--max-regression") && hasValue) params.maxRegression = std::strtod(argv[++i], nullptr);
+        else if (!std::strcmp(argv[i], "--list"))                       params.list          = true;
+        else return false;
+    }
+    return true;
+}
+
+
+// -- Benchmarks -- //
+
+// Projectiles shot at every angle of the cannon's automatic rotation range, laid out on a grid with the given spacing.
+static Physics::ProjectilePool MakeProjectiles(const size_t& count, const bool& applyDrag, const float& spacing)
+{
+    Physics::CannonProperties properties;
+    properties.anchorPos = { 90, 972 - 150 };
+    const float muzzleVelocity = Physics::ComputeMuzzleVelocity(properties);
+
+    Physics::ProjectilePool projectiles;
+    projectiles.Reserve(count);
+    const size_t columns = (size_t)ceilInt(sqrtf((float)count));
+    for (size_t i = 0; i < count; i++)
+    {
+        const float t        = count > 1 ? (float)i / (count - 1) : 0.5f;
+        const float rotation = t * (-PI/3) - PI/8;
+        Physics::Projectile projectile(properties.anchorPos + Maths::Vector2((float)(i % columns), -(float)(i / columns)) * spacing,
+                                       Maths::Vector2(rotation, muzzleVelocity, true));
+        projectile.applyDrag = applyDrag;
+        projectile.radius    = properties.projectileRadius;
+        projectile.mass      = properties.projectileMass;
+        projectiles.Add(projectile);
+    }
+    return projectiles;
+}
+
+static void AddProjectileBenchmarks(std::vector<Benchmark>& benchmarks, Physics::JobSystem& jobs)
+{
+    // Stepping, with the ground out of reach so that the number of projectiles doesn't change.
+    for (const bool applyDrag : { false, true })
+    {
+        for (const size_t count : { 1000, 10000, 100000 })
+        {
+            auto projectiles = std::make_shared<Physics::ProjectilePool>();
+            benchmarks.push_back({
+                std::string("ProjectilePool::Step/") + (applyDrag ? "drag/" : "") + std::to_string(count),
+                [=]() { *projectiles = MakeProjectiles(count, applyDrag, 70); },
+                [=, &jobs]() { projectiles->Step(1.f / 120, 1e9f, jobs); return projectiles->Size(); },
+            });
+        }
+    }
+
+    // Collisions between 2000 projectiles of 30px radius, from far apart to overlapping, with a step to keep them moving.
+    for (const float spacing : { 120.f, 60.f, 45.f })
+    {
+        auto projectiles = std::make_shared<Physics::ProjectilePool>();
+        auto grid        = std::make_shared<Physics::SpatialGrid>();
+        benchmarks.push_back({
+            "ProjectilePool::Collide/grid/spacing:" + std::to_string((int)spacing),
+            [=]() { *projectiles = MakeProjectiles(2000, false, spacing); },
+            [=, &jobs]() { projectiles->Collide(*grid); projectiles->Step(1.f / 120, 1e9f, jobs); return projectiles->Size(); },
+        });
+    }
+    auto bruteForce = std::make_shared<Physics::ProjectilePool>();
+    benchmarks.push_back({
+        "ProjectilePool::Collide/brute-force/spacing:60",
+        [=]() { *bruteForce = MakeProjectiles(2000, false, 60); },
+        [=, &jobs]() { bruteForce->Collide(); bruteForce->Step(1.f / 120, 1e9f, jobs); return bruteForce->Size(); },
+    });
+}
+
+static void AddParticleBenchmarks(std::vector<Benchmark>& benchmarks, Physics::JobSystem& jobs)
+{
+    // Trails and landing bursts like the cannon plays them, each update spawning and removing particles.
+    const SpawnerParticleParams trailParams = {
+        ParticleShapes::POLYGON, { 800, 400 },
+        -PI, 0, 5, 20, 0, 0, 0, 0, 20, 35, 0.05f, 0.2f, CANVAS_ORANGE,
+    };
+    const SpawnerParticleParams burstParams = {
+        ParticleShapes::LINE, { 800, 872 },
+        0, 2*PI, 200, 600, 0, 0, 0, 0, 4, 20, 0.05f, 0.2f, CANVAS_WHITE,
+    };
+    auto particleManager = std::make_shared<std::unique_ptr<ParticleManager>>();
+    auto update = [=, &jobs]()
+    {
+        ParticleManager& particles = **particleManager;
+        particles.SpawnParticles(20, trailParams);
+        particles.CreateSpawner(5, 0.1f, burstParams);
+        particles.Update(1.f / 120, jobs);
+        return particles.GetParticleCount();
+    };
+    benchmarks.push_back({
+        "ParticleManager::Update/churn",
+        [=]() {
+            *particleManager = std::make_unique<ParticleManager>(1);
+            for (int i = 0; i < 240; i++) // Reach the steady number of particles.
+                update();
+        },
+        update,
+    });
+}
+
+static void AddTrajectoryBenchmarks(std::vector<Benchmark>& benchmarks, Physics::JobSystem& jobs)
+{
+    // Rotates the cannon across its range, which predicts the trajectory again at each angle.
+    struct TrajectoryCase { const char* name; bool applyDrag; Physics::DragPredictionMode mode; };
+    for (const TrajectoryCase& trajectoryCase : {
+        TrajectoryCase{ "no-drag",    false, Physics::DragPredictionMode::EULER  },
+        TrajectoryCase{ "drag/euler", true,  Physics::DragPredictionMode::EULER  },
+        TrajectoryCase{ "drag/rk45",  true,  Physics::DragPredictionMode::RK45   },
+        TrajectoryCase{ "drag/cached",true,  Physics::DragPredictionMode::CACHED },
+    })
+    {
+        auto scene = std::make_shared<std::unique_ptr<Scene>>();
+        auto angle = std::make_shared<size_t>(0);
+        benchmarks.push_back({
+            std::string("Cannon::UpdateTrajectory/") + trajectoryCase.name,
+            [=]() {
+                *scene = std::make_unique<Scene>(1);
+                (*scene)->Init({ 1728, 972 });
+                (*scene)->Execute({ SceneCommandType::SET_AUTOMATIC_ROTATION, 0 });
+                (*scene)->Execute({ SceneCommandType::SET_APPLY_DRAG, (float)trajectoryCase.applyDrag });
+                (*scene)->Execute({ SceneCommandType::SET_DRAG_PREDICTION_MODE, (float)trajectoryCase.mode });
+                *angle = 0;
+            },
+            [=]() {
+                const float t = (float)((*angle)++ % 97) / 96;
+                (*scene)->Execute({ SceneCommandType::SET_ROTATION, t * (-PI/2 + 0.1f) - 0.05f });
+                sink = sink + (*scene)->cannon.GetLandingDistance();
+                return (size_t)1;
+            },
+        });
+    }
+
+    // A frame of automatic rotation with 4 steps at 240 Hz, after which the measurements are read once like when drawing.
+    for (const bool applyDrag : { false, true })
+    {
+        auto scene = std::make_shared<std::unique_ptr<Scene>>();
+        benchmarks.push_back({
+            std::string("Cannon::Update/automatic-rotation/") + (applyDrag ? "drag" : "no-drag"),
+            [=]() {
+                *scene = std::make_unique<Scene>(1);
+                (*scene)->Init({ 1728, 972 });
+                (*scene)->Execute({ SceneCommandType::SET_APPLY_DRAG, (float)applyDrag });
+            },
+            [=, &jobs]() {
+                for (int i = 0; i < 4; i++)
+                    (*scene)->cannon.Update(1.f / 240, jobs);
+                sink = sink + (*scene)->cannon.GetLandingDistance();
+                return (size_t)1;
+            },
+        });
+    }
+}
+
+static void AddLabelBenchmarks(std::vector<Benchmark>& benchmarks)
+{
+    // Air times of many cannonballs, which change every step while they fly and stop changing once they land.
+    constexpr size_t LABEL_COUNT = 1024;
+    auto time   = std::make_shared<float>(0.f);
+    auto labels = std::make_shared<std::vector<NumberLabel>>(LABEL_COUNT);
+    benchmarks.push_back({ "Labels/snprintf", nullptr, [=]() {
+        char text[LABEL_CAPACITY];
+        *time += 1 / 120.f;
+        for (size_t i = 0; i < LABEL_COUNT; i++)
+            sink = sink + std::snprintf(text, sizeof(text), "%.2fs", *time + i * 0.37f);
+        return LABEL_COUNT;
+    }});
+    benchmarks.push_back({ "Labels/NumberLabel/changed", nullptr, [=]() {
+        *time += 1 / 120.f;
+        for (size_t i = 0; i < LABEL_COUNT; i++)
+            sink = sink + (*labels)[i].Set(*time + i * 0.37f, 2, "s");
+        return LABEL_COUNT;
+    }});
+    benchmarks.push_back({ "Labels/NumberLabel/unchanged", nullptr, [=]() {
+        for (size_t i = 0; i < LABEL_COUNT; i++)
+            sink = sink + (*labels)[i].Set(i * 0.37f, 2, "s");
+        return LABEL_COUNT;
+    }});
+}
+
+static void AddMathsBenchmarks(std::vector<Benchmark>& benchmarks)
+{
+    // Inputs are random but the same every run.
+    constexpr size_t count = 4096;
+    auto vectors  = std::make_shared<std::vector<Maths::Vector2>>();
+    auto angles   = std::make_shared<std::vector<float>>();
+    auto mat4s    = std::make_shared<std::vector<Mat4>>();
+    auto mat3s    = std::make_shared<std::vector<Mat3>>();
+    auto vector4s = std::make_shared<std::vector<Vector4>>();
+
+    // Kernels that return vectors or matrices write all of them, so that none of their work is optimized out.
+    auto vectorsOut  = std::make_shared<std::vector<Maths::Vector2>>(count);
+    auto mat3sOut    = std::make_shared<std::vector<Mat3>>(count / 4);
+    auto mat4sOut    = std::make_shared<std::vector<Mat4>>(count / 4);
+    auto vector4sOut = std::make_shared<std::vector<Vector4>>(count);
+    Random rng(1);
+    for (size_t i = 0; i < count; i++)
+    {
+        vectors->emplace_back(rng.Range(-100, 100), rng.Range(-100, 100));
+        angles ->push_back(rng.Range(-PI, PI));
+        vector4s->emplace_back(rng.Range(-1, 1), rng.Range(-1, 1), rng.Range(-1, 1), 1.f);
+    }
+    for (size_t i = 0; i < count / 4; i++)
+    {
+        // Rotation, scale and translation so that the matrices can be inverted.
+        mat4s->push_back(Mat4::FromTransform({ rng.Range(-10, 10), rng.Range(-10, 10), rng.Range(-10, 10) },
+                                             Quaternion::FromEuler({ rng.Range(-PI, PI), rng.Range(-PI, PI), rng.Range(-PI, PI) }),
+                                             { rng.Range(0.5f, 2), rng.Range(0.5f, 2), rng.Range(0.5f, 2) }));
+        Mat3 mat3;
+        for (int r = 0; r < 3; r++)
+            for (int c = 0; c < 3; c++)
+                mat3[r][c] = mat4s->back()[r][c];
+        mat3s->push_back(mat3);
+    }
+
+    const auto add = [&](const std::string& name, const std::function<float()>& kernel, const size_t& items)
+    {
+        benchmarks.push_back({ name, nullptr, [=]() { sink = sink + kernel(); return items; } });
+    };
+    add("Vector2::GetLength/4096", [=]() {
+        float sum = 0;
+        for (const Maths::Vector2& v : *vectors) sum += v.GetLength();
+        return sum;
+    }, count);
+    add("Vector2::GetNormalized/4096", [=]() {
+        for (size_t i = 0; i < count; i++) (*vectorsOut)[i] = (*vectors)[i].GetNormalized();
+        return (*vectorsOut)[count / 2].x;
+    }, count);
+    add("Vector2::Dot/4096", [=]() {
+        float sum = 0;
+        for (size_t i = 1; i < count; i++) sum += (*vectors)[i - 1].Dot((*vectors)[i]);
+        return sum;
+    }, count - 1);
+    add("Vector2::GetAngle/4096", [=]() {
+        float sum = 0;
+        for (const Maths::Vector2& v : *vectors) sum += v.GetAngle();
+        return sum;
+    }, count);
+    add("Vector2(angle, length)/4096", [=]() {
+        for (size_t i = 0; i < count; i++) (*vectorsOut)[i] = Maths::Vector2((*angles)[i], 10, true);
+        return (*vectorsOut)[count / 2].y;
+    }, count);
+    // Euler step of a cannonball with drag, like the drag trajectory prediction runs it.
+    // The acceleration is reset at each step so that the transforms reach their terminal velocity instead of overflowing.
+    auto transforms = std::make_shared<std::vector<Transform2D>>();
+    for (size_t i = 0; i < count; i++)
+        transforms->push_back({ (*vectors)[i], Maths::Vector2((*angles)[i], 1000, true), { 0, GRAVITY }, 0, 0, true });
+    add("Transform2D::Update/drag/4096", [=]() {
+        const float dragCoeff = Physics::ComputeDragCoefficient(30);
+        for (Transform2D& transform : *transforms)
+        {
+            transform.acceleration = Maths::Vector2(0, GRAVITY) + Physics::ComputeDrag(transform.velocity, dragCoeff, 1e-4f);
+            transform.Update(1e-4f);
+        }
+        return (*transforms)[count / 2].position.x;
+    }, count);
+    add("Physics::PredictTrajectoryWithDrag", [=]() {
+        Physics::CannonProperties properties;
+        properties.anchorPos = { 90, 972 - 150 };
+        return Physics::PredictTrajectoryWithDrag(properties.anchorPos, (*angles)[0] * 0.25f - PIDIV4, properties, 972).airTime;
+    }, 1);
+    add("Mat3*Mat3/1024", [=]() {
+        for (size_t i = 1; i < mat3s->size(); i++) (*mat3sOut)[i] = (*mat3s)[i - 1] * (*mat3s)[i];
+        return (*mat3sOut)[1][1][2];
+    }, mat3s->size() - 1);
+    add("Mat4*Mat4/1024", [=]() {
+        for (size_t i = 1; i < mat4s->size(); i++) (*mat4sOut)[i] = (*mat4s)[i - 1] * (*mat4s)[i];
+        return (*mat4sOut)[1][2][3];
+    }, mat4s->size() - 1);
+    add("Mat4::GetTransposed/1024", [=]() {
+        for (size_t i = 0; i < mat4s->size(); i++) (*mat4sOut)[i] = (*mat4s)[i].GetTransposed();
+        return (*mat4sOut)[0][0][3];
+    }, mat4s->size());
+    add("Mat4::Det4/1024", [=]() {
+        float sum = 0;
+        for (const Mat4& m : *mat4s) sum += m.Det4();
+        return sum;
+    }, mat4s->size());
+    add("Mat4::Inv4/1024", [=]() {
+        for (size_t i = 0; i < mat4s->size(); i++) (*mat4sOut)[i] = (*mat4s)[i].Inv4();
+        return (*mat4sOut)[0][0][0];
+    }, mat4s->size());
+    add("Vector4*Mat4/4096", [=]() {
+        const Mat4& m = mat4s->front();
+        for (size_t i = 0; i < count; i++) (*vector4sOut)[i] = (*vector4s)[i] * m;
+        return (*vector4sOut)[count / 2].x;
+    }, count);
+    add("Mat3::Inv3/1024", [=]() {
+        for (size_t i = 0; i < mat3s->size(); i++) (*mat3sOut)[i] = (*mat3s)[i].Inv3();
+        return (*mat3sOut)[0][0][0];
+    }, mat3s->size());
+    // Batched transforms, with the best backend of the CPU.
+    add("TransformVectors/4096", [=]() {
+        Maths::TransformVectors(mat4s->front(), vector4s->data(), vector4sOut->data(), count);
+        return (*vector4sOut)[count / 2].x;
+    }, count);
+    add("MultiplyMatrices/1024", [=]() {
+        Maths::MultiplyMatrices(mat4s->data(), mat4s->front(), mat4sOut->data(), mat4s->size());
+        return (*mat4sOut)[1][2][3];
+    }, mat4s->size());
+}
+
+
+// -- Running and reporting -- //
+
+static double RunRepetition(const Benchmark& benchmark, const size_t& iterations, size_t& items)
+{
+    if (benchmark.setup)
+        benchmark.setup();
+    items = 0;
+    const steady_clock::time_point start = steady_clock::now();
+    for (size_t i = 0; i < iterations; i++)
+        items += benchmark.operation();
+    return duration<double>(steady_clock::now() - start).count();
+}
+
+static BenchmarkResult RunBenchmark(const Benchmark& benchmark, const BenchmarkParams& params)
+{
+    BenchmarkResult result;
+    result.name = benchmark.name;
+
+    // Double the iterations until a repetition lasts long enough, which also warms the caches up.
+    size_t items;
+    size_t iterations = 1;
+    while (true)
+    {
+        const double seconds = RunRepetition(benchmark, iterations, items);
+        if (seconds >= params.minTime || iterations >= ((size_t)1 << 30))
+            break;
+        const double scale = seconds > 0 ? params.minTime / seconds * 1.2 : 10;
+        iterations = (size_t)std::ceil(iterations * std::clamp(scale, 2.0, 10.0));
+    }
+    result.iterations = iterations;
+
+    double totalItems = 0;
+    for (int r = 0; r < params.repetitions; r++)
+    {
+        const double seconds = RunRepetition(benchmark, iterations, items);
+        result.nsPerOp.push_back(seconds * 1e9 / iterations);
+        totalItems += items;
+    }
+    result.itemsPerOp = totalItems / ((double)iterations * params.repetitions);
+
+    std::vector<double> sorted = result.nsPerOp;
+    std::sort(sorted.begin(), sorted.end());
+    const size_t n = sorted.size();
+    result.median = n % 2 ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2;
+    result.min    = sorted.front();
+    result.max    = sorted.back();
+    for (const double& ns : sorted)
+        result.mean += ns / n;
+    for (const double& ns : sorted)
+        result.stddev += (ns - result.mean) * (ns - result.mean);
+    result.stddev = n > 1 ? std::sqrt(result.stddev / (n - 1)) : 0;
+    return result;
+}
+
+static double GetItemsPerSecond(const BenchmarkResult& result)
+{
+    return result.median > 0 ? result.itemsPerOp * 1e9 / result.median : 0;
+}
+
+// Benchmark names don't need escaping.
+static bool WriteJson(const std::string& path, const std::vector<BenchmarkResult>& results, const BenchmarkParams& params)
+{
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (!file)
+        return false;
+
+    char date[32];
+    const std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+    std::fprintf(file, "{\n  \"context\": {\"date\": \"%s\", \"threads\": %zu, \"repetitions\": %d, \"min_time\": %g, \"profiling\": %s},\n  \"benchmarks\": [\n",
+                 date, params.threadCount, params.repetitions, params.minTime, PROFILING ? "true" : "false");
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const BenchmarkResult& result = results[i];
+        std::fprintf(file, "    {\"name\": \"%s\", \"iterations\": %zu, \"items_per_op\": %.3f, \"ns_per_op\": {\"median\": %.3f, \"mean\": %.3f, \"stddev\": %.3f, \"min\": %.3f, \"max\": %.3f}, \"items_per_second\": %.1f}%s\n",
+                     result.name.c_str(), result.iterations, result.itemsPerOp, result.median, result.mean, result.stddev, result.min, result.max,
+                     GetItemsPerSecond(result), i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(file, "  ]\n}\n");
+    return std::fclose(file) == 0;
+}
+
+// Reads the median ns/op of each benchmark of a file written by WriteJson.
+static bool LoadBaseline(const std::string& path, std::map<std::string, double>& medians)
+{
+    FILE* file = std::fopen(path.c_str(), "r");
+    if (!file)
+        return false;
+    char line[1024];
+    while (std::fgets(line, sizeof(line), file))
+    {
+        const char* name   = std::strstr(line, "\"name\": \"");
+        const char* median = std::strstr(line, "\"median\": ");
+        if (!name || !median)
+            continue;
+        name += std::strlen("\"name\": \"");
+        const char* nameEnd = std::strchr(name, '"');
+        if (nameEnd)
+            medians[std::string(name, nameEnd)] = std::strtod(median + std::strlen("\"median\": "), nullptr);
+    }
+    std::fclose(file);
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    BenchmarkParams params;
+    if (!ParseArgs(argc, argv, params)) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    Physics::JobSystem jobs(params.threadCount - 1);
+    std::vector<Benchmark> benchmarks;
+    AddProjectileBenchmarks(benchmarks, jobs);
+    AddParticleBenchmarks  (benchmarks, jobs);
+    AddTrajectoryBenchmarks(benchmarks, jobs);
+    AddLabelBenchmarks     (benchmarks);
+    AddMathsBenchmarks     (benchmarks);
+    if (params.list) {
+        for (const Benchmark& benchmark : benchmarks)
+            std::printf("%s\n", benchmark.name.c_str());
+        return 0;
+    }
+
+    std::map<std::string, double> baseline;
+    if (!params.baselinePath.empty() && !LoadBaseline(params.baselinePath, baseline)) {
+        std::fprintf(stderr, "Can't read the baseline %s\n", params.baselinePath.c_str());
+        return 1;
+    }
+    if (PROFILING)
+        std::printf("Warning: the profiling zones are compiled in, timings include their cost\n");
+
+    std::printf("%-48s %14s %10s %14s %12s%s\n", "Benchmark", "ns/op", "stddev", "items/s", "iterations", baseline.empty() ? "" : "     change");
+    std::vector<BenchmarkResult> results;
+    size_t regressionCount = 0;
+    for (const Benchmark& benchmark : benchmarks)
+    {
+        if (!params.filter.empty() && benchmark.name.find(params.filter) == std::string::npos)
+            continue;
+        const BenchmarkResult result = RunBenchmark(benchmark, params);
+        std::printf("%-48s %14.1f %9.1f%% %14.4g %12zu", result.name.c_str(), result.median,
+                    result.mean > 0 ? result.stddev / result.mean * 100 : 0.0, GetItemsPerSecond(result), result.iterations);
+
+        // Change of the median time from the baseline, positive when slower.
+        const auto base = baseline.find(result.name);
+        if (base != baseline.end() && base->second > 0)
+        {
+            const double change = (result.median / base->second - 1) * 100;
+            const bool   regressed = params.maxRegression > 0 && change > params.maxRegression;
+            regressionCount += regressed;
+            std::printf(" %+9.1f%%%s", change, regressed ? " REGRESSION" : "");
+        }
+        std::printf("\n");
+        std::fflush(stdout);
+        results.push_back(result);
+    }
+
+    if (!params.jsonPath.empty())
+    {
+        if (!WriteJson(params.jsonPath, results, params)) {
+            std::fprintf(stderr, "Can't write the results to %s\n", params.jsonPath.c_str());
+            return 1;
+        }
+        std::printf("Results written to %s\n", params.jsonPath.c_str());
+    }
+    if (regressionCount > 0) {
+        std::printf("%zu benchmarks are more than %.1f%% slower than the baseline\n", regressionCount, params.maxRegression);
+        return 1;
+    }
+    return 0;
+}
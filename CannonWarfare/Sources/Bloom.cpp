@@ -0,0 +1,253 @@
+#include "Bloom.h"
+#include <algorithm>
+#include <cmath>
+
+
+// Taps of the blur shader (GaussianBlur.fs): offsets from -4 to 3 weighted by 5 - |offset|.
+constexpr int   BLUR_FIRST_TAP  = -4;
+constexpr int   BLUR_LAST_TAP   = 3;
+constexpr float BLUR_WEIGHT_SUM = 24;
+
+BloomSettings GetDefaultBloomSettings(const int& screenWidth)
+{
+    // The glow of the blur passes grows linearly with their number, the one of the mip chain doubles with each level.
+    BloomSettings settings;
+    settings.blurPasses = std::clamp((int)(settings.blurPasses * screenWidth / 2560.f), 1, BLOOM_MAX_BLUR_PASSES);
+    settings.mipLevels  = std::clamp(settings.mipLevels + (int)std::round(std::log2(std::max(screenWidth, 1) / 2560.f)), 1, BLOOM_MAX_MIP_LEVELS);
+    return settings;
+}
+
+int GetBloomMipLevelCount(const BloomSettings& settings, const int& width, const int& height)
+{
+    int levelCount = std::clamp(settings.mipLevels, 1, BLOOM_MAX_MIP_LEVELS);
+    while (levelCount > 1 && ((width >> levelCount) < 1 || (height >> levelCount) < 1))
+        levelCount--;
+    return levelCount;
+}
+
+int GetBloomMipWidth(const int& width, const int& level)
+{
+    return std::max(width >> (level + 1), 1);
+}
+
+int GetBloomMipHeight(const int& height, const int& level)
+{
+    return std::max(height >> (level + 1), 1);
+}
+
+BloomCost GetBloomCost(const BloomSettings& settings, const int& width, const int& height)
+{
+    BloomCost cost;
+    const size_t screenPixels = (size_t)width * height;
+    if (settings.mode == BloomModes::BLUR_PASSES)
+    {
+        // Each pass copies the lit pixels, then blurs horizontally and vertically.
+        const size_t passCount = (size_t)std::clamp(settings.blurPasses, 1, BLOOM_MAX_BLUR_PASSES);
+        const size_t tapCount  = BLUR_LAST_TAP - BLUR_FIRST_TAP + 1;
+        cost.passes        = (int)passCount * 3;
+        cost.pixelsWritten = passCount * 3 * screenPixels;
+        cost.texelFetches  = passCount * (1 + 2 * tapCount) * screenPixels;
+        return cost;
+    }
+
+    // 4 samples for each downsampled pixel, 9 for each upsampled one, then 9 for each screen pixel.
+    const int levelCount = GetBloomMipLevelCount(settings, width, height);
+    for (int level = 0; level < levelCount; level++)
+    {
+        const size_t levelPixels = (size_t)GetBloomMipWidth(width, level) * GetBloomMipHeight(height, level);
+        cost.passes++;
+        cost.pixelsWritten += levelPixels;
+        cost.texelFetches  += levelPixels * 4;
+        if (level < levelCount - 1) {
+            cost.passes++;
+            cost.pixelsWritten += levelPixels;
+            cost.texelFetches  += levelPixels * 9;
+        }
+    }
+    cost.passes++;
+    cost.pixelsWritten += screenPixels;
+    cost.texelFetches  += screenPixels * 9;
+    return cost;
+}
+
+float GetBloomUpsampleOpacity(const int& levelCount, const int& level)
+{
+    const int addedLevels = levelCount - level; // Levels already summed in the upsampled one.
+    return std::round(255.f * addedLevels / (addedLevels + 1)) / 255.f;
+}
+
+void BloomImage::Resize(const int& _width, const int& _height)
+{
+    width  = _width;
+    height = _height;
+    pixels.assign((size_t)width * height * 3, 0.f);
+}
+
+// Nearest texel with clamped coordinates.
+static const float* GetClampedPixel(const BloomImage& image, const int& x, const int& y)
+{
+    return image.GetPixel(std::clamp(x, 0, image.width - 1), std::clamp(y, 0, image.height - 1));
+}
+
+static bool IsLit(const float* pixel)
+{
+    return pixel[0] != 0 || pixel[1] != 0 || pixel[2] != 0;
+}
+
+// Adds the weighted bilinear samples at the given offsets (in source texels) around each destination pixel, like texture2D with a linear filter and clamped coordinates.
+// Both the bilinear filter and the taps are separable, so the rows are filtered first into the temporary image, then the columns.
+// The sum times the scale is blended over the destination with the given opacity.
+void BloomReference::Resample(const BloomImage& source, BloomImage& destination, const float* taps, const float* weights, const int& tapCount, const float& scale, const float& opacity)
+{
+    // Source texels read for each destination texel along an axis, with their weights.
+    const int samplesPerTexel = tapCount * 2;
+    const auto getSamples = [&](const int& destinationSize, const int& sourceSize, std::vector<BloomSample>& samples)
+    {
+        samples.resize((size_t)destinationSize * samplesPerTexel);
+        for (int i = 0; i < destinationSize; i++)
+        {
+            for (int tap = 0; tap < tapCount; tap++)
+            {
+                const float position = (i + 0.5f) * sourceSize / destinationSize + taps[tap] - 0.5f;
+                const float first    = std::floor(position);
+                const float fraction = position - first;
+                samples[(size_t)i * samplesPerTexel + tap * 2]     = { std::clamp((int)first,     0, sourceSize - 1), weights[tap] * (1 - fraction) };
+                samples[(size_t)i * samplesPerTexel + tap * 2 + 1] = { std::clamp((int)first + 1, 0, sourceSize - 1), weights[tap] * fraction };
+            }
+        }
+    };
+    getSamples(destination.width,  source.width,  columnSamples);
+    getSamples(destination.height, source.height, rowSamples);
+
+    rowsImage.Resize(destination.width, source.height);
+    for (int y = 0; y < source.height; y++)
+    {
+        for (int x = 0; x < destination.width; x++)
+        {
+            float* pixel = rowsImage.GetPixel(x, y);
+            const BloomSample* samples = &columnSamples[(size_t)x * samplesPerTexel];
+            for (int i = 0; i < samplesPerTexel; i++)
+            {
+                const float* texel = source.GetPixel(samples[i].index, y);
+                for (int c = 0; c < 3; c++)
+                    pixel[c] += texel[c] * samples[i].weight;
+            }
+        }
+    }
+
+    for (int y = 0; y < destination.height; y++)
+    {
+        const BloomSample* samples = &rowSamples[(size_t)y * samplesPerTexel];
+        for (int x = 0; x < destination.width; x++)
+        {
+            float sum[3] = { 0, 0, 0 };
+            for (int i = 0; i < samplesPerTexel; i++)
+            {
+                const float* texel = rowsImage.GetPixel(x, samples[i].index);
+                for (int c = 0; c < 3; c++)
+                    sum[c] += texel[c] * samples[i].weight;
+            }
+
+            float* pixel = destination.GetPixel(x, y);
+            for (int c = 0; c < 3; c++)
+                pixel[c] += (sum[c] * scale - pixel[c]) * opacity;
+        }
+    }
+}
+
+// Same as BloomDownsample.fs: averages 4 bilinear samples one source texel away diagonally, which covers 4x4 source texels.
+void BloomReference::Downsample(const BloomImage& source, BloomImage& destination)
+{
+    const float taps[2] = { -1, 1 }, weights[2] = { 0.5f, 0.5f };
+    Resample(source, destination, taps, weights, 2, 1, 1);
+}
+
+// Same as BloomUpsample.fs: 3x3 tent of bilinear samples one source texel apart, times the intensity, blended over the destination with the given opacity.
+void BloomReference::Upsample(const BloomImage& source, BloomImage& destination, const float& intensity, const float& opacity)
+{
+    const float taps[3] = { -1, 0, 1 }, weights[3] = { 0.25f, 0.5f, 0.25f };
+    Resample(source, destination, taps, weights, 3, intensity, opacity);
+}
+
+const BloomImage& BloomReference::Apply(const BloomImage& source, const BloomSettings& settings)
+{
+    if (settings.mode == BloomModes::BLUR_PASSES)
+        ApplyBlurPasses(source, std::clamp(settings.blurPasses, 1, BLOOM_MAX_BLUR_PASSES));
+    else
+        ApplyMipChain(source, GetBloomMipLevelCount(settings, source.width, source.height), std::max(settings.mipIntensity, 0.f));
+    return blurImages[0];
+}
+
+void BloomReference::ApplyBlurPasses(const BloomImage& source, const int& passCount)
+{
+    blurImages[0].Resize(source.width, source.height);
+    blurImages[1].Resize(source.width, source.height);
+    for (int pass = 0; pass < passCount; pass++)
+    {
+        // Copy the lit pixels over the last blurred image.
+        for (int y = 0; y < source.height; y++)
+        {
+            for (int x = 0; x < source.width; x++)
+            {
+                const float* pixel = source.GetPixel(x, y);
+                if (IsLit(pixel))
+                    std::copy(pixel, pixel + 3, blurImages[0].GetPixel(x, y));
+            }
+        }
+
+        // Blur horizontally into the second image, then vertically back into the first one.
+        for (int vertical = 0; vertical < 2; vertical++)
+        {
+            const BloomImage& from = blurImages[vertical];
+            BloomImage&       to   = blurImages[1 - vertical];
+            for (int y = 0; y < source.height; y++)
+            {
+                for (int x = 0; x < source.width; x++)
+                {
+                    float sum[3] = { 0, 0, 0 };
+                    for (int tap = BLUR_FIRST_TAP; tap <= BLUR_LAST_TAP; tap++)
+                    {
+                        const float* texel  = vertical ? GetClampedPixel(from, x, y + tap) : GetClampedPixel(from, x + tap, y);
+                        const float  weight = (float)(BLUR_LAST_TAP + 2 - std::abs(tap));
+                        for (int c = 0; c < 3; c++)
+                            sum[c] += texel[c] * weight;
+                    }
+                    float* pixel = to.GetPixel(x, y);
+                    for (int c = 0; c < 3; c++)
+                        pixel[c] = sum[c] / BLUR_WEIGHT_SUM;
+                }
+            }
+        }
+    }
+}
+
+void BloomReference::ApplyMipChain(const BloomImage& source, const int& levelCount, const float& intensity)
+{
+    // Downsample the source into each level. Unlit pixels are already black, so the lit ones don't need to be copied first.
+    for (int level = 0; level < levelCount; level++)
+    {
+        mipImages[level].Resize(GetBloomMipWidth(source.width, level), GetBloomMipHeight(source.height, level));
+        Downsample(level == 0 ? source : mipImages[level - 1], mipImages[level]);
+    }
+
+    // Add each level to the one above it, then upsample the first level to the screen size with the glow intensity.
+    // The levels are averaged as they are added so that 8 bit textures don't saturate: each one is blended with the
+    // opacity of the levels already added to it among all the levels so far, rounded like an 8 bit alpha.
+    for (int level = levelCount - 1; level > 0; level--)
+        Upsample(mipImages[level], mipImages[level - 1], 1, GetBloomUpsampleOpacity(levelCount, level));
+    blurImages[0].Resize(source.width, source.height);
+    Upsample(mipImages[0], blurImages[0], intensity, 1);
+}
+
+void ComposeBloom(const BloomImage& source, const BloomImage& bloom, BloomImage& result)
+{
+    result.Resize(source.width, source.height);
+    for (int y = 0; y < source.height; y++)
+    {
+        for (int x = 0; x < source.width; x++)
+        {
+            const float* pixel = IsLit(source.GetPixel(x, y)) ? source.GetPixel(x, y) : bloom.GetPixel(x, y);
+            std::copy(pixel, pixel + 3, result.GetPixel(x, y));
+        }
+    }
+}
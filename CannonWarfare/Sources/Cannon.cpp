@@ -1,21 +1,17 @@
-#include "App.h"
 #include "Cannon.h"
-#include "PhysicsConstants.h"
-#include "RaylibConversions.h"
-#include <sstream>
-#include <iomanip>
+#include "ParticleManager.h"
+#include "Arithmetic.h"
+#include "MathConstants.h"
+#include "Profiler.h"
+#include <cmath>
 using namespace Maths;
 
 Cannon::Cannon(ParticleManager& _particleManager, const float& _groundHeight)
        : particleManager(_particleManager), groundHeight(_groundHeight)
 {
-}
-
-Cannon::~Cannon()
-{
-    for (const CannonBall* projectile : projectiles)
-        delete projectile;
-    projectiles.clear();
+    projectiles.Reserve(PROJECTILE_RESERVE);
+    projectileEvents.reserve(PROJECTILE_RESERVE);
+    projectileLabels.reserve(PROJECTILE_RESERVE);
 }
 
 void Cannon::UpdateDrawPoints()
@@ -43,119 +39,82 @@ void Cannon::UpdateDrawPoints()
 
 void Cannon::UpdateTrajectory()
 {
+    PROFILE_ZONE("Cannon::UpdateTrajectory");
     if (!applyDrag)
-    {
-        // Find the time (t) at which a cannonball would hit the ground.
-        // This is done by finding when the cannonball's vertical movement equation (a.y*0.5*t^2 + v0.y*t + p0.y) is equal to groundHeight
-        // It's the same as solving the following equation by finding its roots: a.y*0.5*t^2 + v0.y*t + p0.y - groundHeight
-        const Maths::Vector2 v0 = Maths::Vector2(transform.rotation, ComputeMuzzleVelocity(), true);
-
-        // The three coefficients of the equation: a*t^2 + b*t + c
-        const float a = GRAVITY * 0.5f;
-        const float b = v0.y;
-        const float c = shootingPoint.y - (groundHeight - properties.projectileRadius);
-
-        // Find the value for delta's square root.
-        const float sqrtDelta = sqrt(sqpow(b) - 4*a*c);
-
-        // Compute the equation's roots t1 and t2 and choose the highest one.
-        const float t1 = (-b - sqrtDelta) / (2*a);
-        const float t2 = (-b + sqrtDelta) / (2*a);
-        const float t  = (t1 >= t2 ? t1 : t2);
-
-        // Find the landing velocity using the cannonball's velocity equation: (v0.x, v0.y * g * t)
-        landingVelocity = { v0.x, v0.y + GRAVITY * t };
-
-        // Find the landing position using the cannonball's movement equation: (v0.x * t + p0.x, g * 0.5f * t^2 + v0.y * t + p0.y)
-        landingPosition = { v0.x*t + shootingPoint.x, GRAVITY*0.5f*sqpow(t) + v0.y*t + shootingPoint.y };
-
-        // Find the control point of the bezier curve linked to the cannonball's movement equation.
-        // This is done by finding the intersection between the line following lines:
-        // - line that passes through the start position in the direction of the start velocity
-        // - line that passes through the landing point in the direction of the landing velocity
-        controlPoint = LineIntersection(shootingPoint, v0, landingPosition, -landingVelocity);
-
-        // Save the trajectory's general parameters.
-        airTime = t;
-        landingDistance = landingPosition.x - shootingPoint.x;
-        const float highestPointT = clamp((shootingPoint.y - controlPoint.y) / (shootingPoint.y + landingPosition.y - 2*controlPoint.y), 0, 1);
-        highestPoint = shootingPoint * sqpow(1-highestPointT) + controlPoint * 2*(1-highestPointT)*highestPointT + landingPosition * sqpow(highestPointT);
-        maxHeight = clampAbove(shootingPoint.y - highestPoint.y, 0);
-    }
+        prediction = Physics::PredictTrajectory(shootingPoint, transform.rotation, properties, groundHeight);
     else
-    {
-        const float timeStep = 0.01f; airTime = 0; highestPoint.y = groundHeight;
-        Transform2D projectileTransform = { shootingPoint, { transform.rotation, ComputeMuzzleVelocity(), true }, { 0, GRAVITY }, 0, 0, true };
-        posPredicted.clear(); posPredicted.emplace_back(ToRayVector2(projectileTransform.position));
-
-        // Simulate a projectile with drag until it hits the ground.
-        while (projectileTransform.position.y < groundHeight - properties.projectileRadius)
-        {
-            // Increment air time.
-            airTime += timeStep;
-
-            // Apply drag.
-            const float dragCoeff = 0.5f * AIR_DENSITY * SPHERE_DRAG_COEFF * PI * sqpow(properties.projectileRadius / PIXEL_SCALE);
-            const float velocity  = projectileTransform.velocity.GetLength();
-            projectileTransform.acceleration -= projectileTransform.velocity * velocity * dragCoeff * timeStep * 0.1f;
-
-            // Update apply acceleration to velocity and velocity to acceleration.
-            projectileTransform.Update(timeStep);
-
-            // Save cannonball positions.
-            if (Maths::Vector2(FromRayVector2(posPredicted.back()), projectileTransform.position).GetLengthSquared() > 500.f)
-                posPredicted.emplace_back(ToRayVector2(projectileTransform.position));
+        prediction = trajectoryPredictor.Predict(shootingPoint, transform.rotation, properties, groundHeight, &posPredicted);
+    predictedWithDrag = applyDrag;
+    predictionCount++;
+}
 
-            // Stop simulation once the cannonball hits the ground.
-            if (projectileTransform.position.y < highestPoint.y)
-                highestPoint = projectileTransform.position;
-        }
+void Cannon::RefreshDrawPoints()
+{
+    if (dirtyFlags & CannonDirtyFlags::DRAW_POINTS)
+        UpdateDrawPoints();
+    dirtyFlags &= ~CannonDirtyFlags::DRAW_POINTS;
+}
 
-        // Save its final velocity, position, and maximum height.
-        landingVelocity = projectileTransform.velocity;
-        landingPosition = { projectileTransform.position.x, groundHeight - properties.projectileRadius };
-        landingDistance = landingPosition.x - shootingPoint.x;
-        maxHeight = clampAbove(shootingPoint.y - highestPoint.y, 0);
-        posPredicted.emplace_back(ToRayVector2(landingPosition));
-    }
+void Cannon::RefreshTrajectory()
+{
+    // Drag can be toggled directly, so it is compared with the value of the last prediction instead of being marked.
+    RefreshDrawPoints();
+    if ((dirtyFlags & CannonDirtyFlags::TRAJECTORY) || applyDrag != predictedWithDrag)
+        UpdateTrajectory();
+    dirtyFlags &= ~CannonDirtyFlags::TRAJECTORY;
 }
 
-void Cannon::UpdateCollisions(CannonBall* cannonBall) const
+Maths::Vector2 Cannon::GetShootingPoint(const float& rotation) const
 {
-    for (CannonBall* projectile : projectiles)
-        if (cannonBall != projectile)
-            cannonBall->CheckCollisions(projectile);
+    // Same as the middle of the barrel's front in UpdateDrawPoints.
+    const float barrelLength = properties.barrelLength / PIXEL_SCALE * 50;
+    const float barrelAngle  = atan(20 / barrelLength);
+    return transform.position + Maths::Vector2(rotation, barrelLength * cos(barrelAngle) + 14, true);
 }
 
-void Cannon::ApplyRecoil()
+const Physics::FiringAngles& Cannon::GetFiringAngles(const float& targetDistance)
 {
-    if (applyRecoil)
+    // Drag and the ground height aren't set through the cannon, so they are compared with the values of the last solve like the distance.
+    if (!(dirtyFlags & CannonDirtyFlags::FIRING_ANGLES) && targetDistance == firingTargetDistance && groundHeight == firingGroundHeight && applyDrag == solvedWithDrag)
+        return firingAngles;
+    PROFILE_ZONE("Cannon::GetFiringAngles");
+    firingTargetDistance = targetDistance;
+    firingGroundHeight   = groundHeight;
+    solvedWithDrag       = applyDrag;
+    dirtyFlags &= ~CannonDirtyFlags::FIRING_ANGLES;
+
+    const Maths::Vector2 target = { transform.position.x + targetDistance, groundHeight - properties.projectileRadius };
+    const auto solve = [&](const Maths::Vector2& from)
     {
-        // See this link for more info: https://www.omnicalculator.com/physics/recoil-energy
-        float velocity = (sqpow(properties.projectileMass) * ComputeMuzzleVelocity() + properties.powderCharge * properties.chargeVelocity) / properties.mass;
-        transform.velocity = -Maths::Vector2(transform.rotation, velocity, true);
+        return applyDrag ? Physics::SolveFiringAnglesWithDrag(from, target, properties, firingPredictor)
+                         : Physics::SolveFiringAngles        (from, target, properties);
+    };
+
+    // The barrel's tip moves with the rotation, so solve again from where it is at each angle.
+    // The first guess is solved from the tip at the horizontal rotation, so that the result doesn't depend on the current rotation.
+    Physics::FiringAngles angles = solve(GetShootingPoint(0));
+    if (angles.reachable)
+    {
+        const Physics::FiringAngles low  = solve(GetShootingPoint(angles.low));
+        const Physics::FiringAngles high = solve(GetShootingPoint(angles.high));
+        angles.reachable    = low.reachable && high.reachable;
+        angles.low          = low.low;
+        angles.high         = high.high;
+        angles.predictions += low.predictions + high.predictions;
     }
+    firingAngles = angles;
+    return firingAngles;
 }
 
-float Cannon::ComputeMuzzleVelocity()
+void Cannon::ApplyRecoil()
 {
-    // See this link for more info: https://www.arc.id.au/CannonBallistics.html
-    const float d = properties.projectileRadius * 2; // Barrel diameter (px)
-    const float m = properties.projectileMass; // (kg)
-    const float p = properties.powderCharge; // (kg)
-    const float L = properties.barrelLength; // (px)
-    const float eta = 881    / PIXEL_SCALE;  // Density of powder (kg/m^3 -> kg/px^3)
-    const float rho = 997    / PIXEL_SCALE;  // Density of water (kg/m^3 -> kg/px^3)
-    const float atm = 1.225f / PIXEL_SCALE;  // Atmospheric pressure (kg/m^3 -> kg/px^3)
-    const float R   = 1600;                  // Gunpowder gas pressure to atm ratio
-    const float c   = p*4/(PI*sqpow(d)*eta); // Length of charge
-
-    const float v = sqrt(2*R*atm/eta) * sqrt(p/(m+p/3) * log(L/c));
-    return v * 130;
+    if (applyRecoil)
+        transform.velocity = -Maths::Vector2(transform.rotation, Physics::ComputeRecoilVelocity(properties), true);
 }
 
-void Cannon::Update(const float& deltaTime)
+void Cannon::Update(const float& deltaTime, Physics::JobSystem& jobs)
 {
+    PROFILE_ZONE("Cannon::Update");
     if (applyRecoil)
     {
         transform.Update(deltaTime);
@@ -164,145 +123,281 @@ void Cannon::Update(const float& deltaTime)
         transform.velocity -= transform.velocity * deltaTime * 10;
         if (transform.velocity.GetLengthSquared() > 0.1f && posToAnchor.GetLengthSquared() > 0.01f) {
             transform.position += posToAnchor * deltaTime * 10 * (1 / transform.velocity.GetLengthSquared());
-            UpdateDrawPoints();
-            UpdateTrajectory();
+            dirtyFlags |= CannonDirtyFlags::DRAW_POINTS | CannonDirtyFlags::TRAJECTORY | CannonDirtyFlags::FIRING_ANGLES;
         }
     }
 
     // Automatically update cannon rotation.
+    simulationTime += deltaTime;
     if (automaticRotation)
-        SetRotation((sin(App::GetTimeSinceStart() * 0.25f) * 0.5f + 0.5f) * (-PI/3) - PI/8);
+        SetRotation((sin(simulationTime * 0.25f) * 0.5f + 0.5f) * (-PI/3) - PI/8);
 
     // Update alphas depending on what is shown.
     if      ( showTrajectory   && drawParams.trajectoryAlpha   < 1.f) drawParams.trajectoryAlpha   = clamp(drawParams.trajectoryAlpha   + deltaTime, 0, 1);
     else if (!showTrajectory   && drawParams.trajectoryAlpha   > 0.f) drawParams.trajectoryAlpha   = clamp(drawParams.trajectoryAlpha   - deltaTime, 0, 1);
     if      ( showMeasurements && drawParams.measurementsAlpha < 1.f) drawParams.measurementsAlpha = clamp(drawParams.measurementsAlpha + deltaTime, 0, 1);
     else if (!showMeasurements && drawParams.measurementsAlpha > 0.f) drawParams.measurementsAlpha = clamp(drawParams.measurementsAlpha - deltaTime, 0, 1);
+    if      ( showProjectileTrajectories && drawParams.projectileTrajectoryAlpha < 1.f) drawParams.projectileTrajectoryAlpha = clamp(drawParams.projectileTrajectoryAlpha + deltaTime, 0, 1);
+    else if (!showProjectileTrajectories && drawParams.projectileTrajectoryAlpha > 0.f) drawParams.projectileTrajectoryAlpha = clamp(drawParams.projectileTrajectoryAlpha - deltaTime, 0, 1);
 
     // Update projectiles.
-    for (size_t i = 0; i < projectiles.size(); i++) 
+    projectileEvents.clear();
+    if (applyCollisions && useSpatialGrid)
+        projectiles.Collide(collisionGrid, &projectileEvents);
+    else if (applyCollisions)
+        projectiles.Collide(&projectileEvents);
+    projectiles.Step(deltaTime, groundHeight, jobs, &projectileEvents);
+    PlayProjectileParticles();
+
+    // Delete any projectile that has finished destroying itself.
+    projectiles.RemoveDestroyed();
+}
+
+void Cannon::PlayProjectileParticles()
+{
+    // Play particles behind the projectiles that are still in the air.
+    SpawnerParticleParams trailParams = {
+        ParticleShapes::POLYGON,
+        {},
+        -PI, 0,
+        5, 20,
+        0, 0,
+        0, 0,
+        20, 35,
+        0.05f, 0.2f,
+        CANVAS_ORANGE,
+    };
+    for (size_t i = 0; i < projectiles.Size(); i++)
     {
-        if (applyCollisions)
-            UpdateCollisions(projectiles[i]);
-        projectiles[i]->Update(deltaTime);
-
-        // Set all projectiles to show/hide their trajectory.
-        if (projectiles[i]->showTrajectory != showProjectileTrajectories)
-            projectiles[i]->showTrajectory  = showProjectileTrajectories;
-
-        // Delete any projectile that has finished destroying itself.
-        if (projectiles[i]->IsDestroyed()) {
-            delete projectiles[i];
-            projectiles.erase(projectiles.begin() + i);
-            i -= 1;
+        if (projectiles.IsLanded(i))
+            continue;
+        const float rotation = projectiles.GetVelocity(i).GetAngle();
+        trailParams.position     = projectiles.GetPosition(i);
+        trailParams.minDirection = rotation - PI;
+        trailParams.maxDirection = rotation;
+        particleManager.SpawnParticles(1, trailParams);
+    }
+
+    // Play landing and collision particles.
+    for (const Physics::ProjectileEvent& event : projectileEvents)
+    {
+        const float v = event.speed;
+        if (event.type == Physics::ProjectileEventType::COLLIDED)
+        {
+            const SpawnerParticleParams params = {
+                ParticleShapes::LINE,
+                event.position,
+                0, 2*PI,
+                v, v*3,
+                0, 0,
+                0, 0,
+                v/50, v/10,
+                0.05f, 0.2f,
+                GetProjectileColor(event.index),
+            };
+            particleManager.CreateSpawner(5, 0.1f, params);
         }
+        else
+        {
+            const SpawnerParticleParams params = {
+                ParticleShapes::POLYGON,
+                event.position + Maths::Vector2(0, projectiles.radius[event.index] * 1.5f),
+                -PI/4, PI+PI/2,
+                v, 5 * v,
+                0, 0,
+                0, 0,
+                20, 35,
+                0.05f, 0.2f,
+                CANVAS_WHITE,
+            };
+            particleManager.CreateSpawner(1, 0.1f, params);
+        }
+    }
+}
+
+CanvasColor Cannon::GetProjectileColor(const size_t& i) const
+{
+    CanvasColor color = drawParams.projectileColor;
+    color.a = (uint8_t)(255 * projectiles.GetAlpha(i));
+    return color;
+}
+
+void Cannon::DrawProjectiles(Canvas& canvas, FrameArena& arena, const float& alpha)
+{
+    // The air times are drawn after every cannonball, in one batch.
+    projectileLabels.resize(projectiles.Size());
+    CanvasLabel* labels = arena.Allocate<CanvasLabel>(projectiles.Size());
+    for (size_t i = 0; i < projectiles.Size(); i++)
+    {
+        // Draw the cannonball.
+        const Maths::Vector2 position = projectiles.GetInterpolatedPosition(i, alpha);
+        const CanvasColor    color    = GetProjectileColor(i);
+        canvas.DrawCircle     (position, projectiles.radius[i], CANVAS_BLACK);
+        canvas.DrawCircleLines(position, projectiles.radius[i], color);
+
+        // Get the current trajectory color.
+        const float trajectoryAlpha = min(clamp(projectiles.age[i], 0, 1), drawParams.projectileTrajectoryAlpha);
+        const CanvasColor curColor = { color.r, color.g, color.b, (uint8_t)min(trajectoryAlpha * 255, color.a) };
+
+        // Air time.
+        NumberLabel& label = projectileLabels[i];
+        label.Set(projectiles.airTime[i], 2, "s");
+        labels[i] = { label.GetText(), { position.x - label.GetWidth(canvas, 20) / 2.f, position.y - 10 }, 20, curColor };
     }
+    canvas.DrawLabels(labels, projectiles.Size());
 }
 
-void Cannon::Draw() const
+void Cannon::DrawProjectileTrajectories(Canvas& canvas) const
 {
+    for (size_t i = 0; i < projectiles.Size(); i++)
+    {
+        if (projectiles.HasCollided(i))
+            continue;
+
+        const CanvasColor color = GetProjectileColor(i);
+        const float trajectoryAlpha = min(clamp(projectiles.age[i], 0, 1), drawParams.projectileTrajectoryAlpha);
+        const CanvasColor curColor = { color.r, color.g, color.b, (uint8_t)min(trajectoryAlpha * 255, color.a) };
+        if (curColor.a == 0)
+            continue;
+
+        const Maths::Vector2 startPos = projectiles.startPos[i];
+        const Maths::Vector2 endPos   = projectiles.GetEndPos(i);
+        if (!projectiles.HasDrag(i))
+        {
+            // Draw the trajectory with a bezier curve.
+            canvas.DrawBezierQuad(startPos, endPos, projectiles.GetControlPoint(i), 1, curColor);
+        }
+        else
+        {
+            // Draw the trail, and its end up to the cannonball until it lands.
+            canvas.DrawLineStrip(projectiles.GetTrail(i), projectiles.GetTrailSize(i), 1, curColor);
+            if (!projectiles.IsLanded(i))
+                canvas.DrawLine(projectiles.trails[i].lastKept, projectiles.GetPosition(i), 1, curColor);
+        }
+
+        // Draw the start circle and end arrow.
+        canvas.DrawCircle(startPos, 5, curColor);
+        canvas.DrawPoly(endPos, 3, 12, radToDeg(projectiles.GetEndV(i).GetAngle()) - 90, curColor);
+    }
+}
+
+void Cannon::Draw(Canvas& canvas, FrameArena& arena, const float& alpha)
+{
+    RefreshDrawPoints();
+
     // Draw the cannonballs.
-    for (const CannonBall* projectile : projectiles)
-        projectile->Draw();
+    DrawProjectiles(canvas, arena, alpha);
     
     // Draw the back semi-circle.
     const float degRot       = radToDeg(transform.rotation) + 90;
     const float circleRadius = Maths::Vector2(transform.position, drawParams.centerUp).GetLength();
-    DrawCircleSector     (ToRayVector2(transform.position), circleRadius, -degRot-90, -degRot+90, 10, BLACK);
-    DrawCircleSectorLines(ToRayVector2(transform.position), circleRadius, -degRot-90, -degRot+90, 10, drawParams.cannonColor);
-    DrawLineEx           (ToRayVector2(drawParams.centerUp), ToRayVector2(drawParams.centerDown), 2,  BLACK);
+    canvas.DrawCircleSector     (transform.position, circleRadius, -degRot-90, -degRot+90, 10, CANVAS_BLACK);
+    canvas.DrawCircleSectorLines(transform.position, circleRadius, -degRot-90, -degRot+90, 10, drawParams.cannonColor);
+    canvas.DrawLine             (drawParams.centerUp, drawParams.centerDown, 2,  CANVAS_BLACK);
 
     // Draw the barrel sides.
-    DrawTriangle(ToRayVector2(drawParams.midDown   ), ToRayVector2(drawParams.midUp     ), ToRayVector2(drawParams.centerUp), BLACK);
-    DrawTriangle(ToRayVector2(drawParams.centerUp  ), ToRayVector2(drawParams.centerDown), ToRayVector2(drawParams.midDown ), BLACK);
-    DrawLineEx  (ToRayVector2(drawParams.centerUp  ), ToRayVector2(drawParams.midUp     ), 1, drawParams.cannonColor);
-    DrawLineEx  (ToRayVector2(drawParams.centerDown), ToRayVector2(drawParams.midDown   ), 1, drawParams.cannonColor);
+    canvas.DrawTriangle(drawParams.midDown,    drawParams.midUp,      drawParams.centerUp, CANVAS_BLACK);
+    canvas.DrawTriangle(drawParams.centerUp,   drawParams.centerDown, drawParams.midDown,  CANVAS_BLACK);
+    canvas.DrawLine    (drawParams.centerUp,   drawParams.midUp,      1, drawParams.cannonColor);
+    canvas.DrawLine    (drawParams.centerDown, drawParams.midDown,    1, drawParams.cannonColor);
 
     // Draw the sides of the tip of the barrel.
-    DrawCircleSector     (ToRayVector2((drawParams.midUp   + drawParams.frontUp  ) / 2), 7, -degRot-180, -degRot, 10, BLACK);
-    DrawCircleSector     (ToRayVector2((drawParams.midDown + drawParams.frontDown) / 2), 7, -degRot, -degRot+180, 10, BLACK);
-    DrawCircleSectorLines(ToRayVector2((drawParams.midUp   + drawParams.frontUp  ) / 2), 7, -degRot-180, -degRot, 10, drawParams.cannonColor);
-    DrawCircleSectorLines(ToRayVector2((drawParams.midDown + drawParams.frontDown) / 2), 7, -degRot, -degRot+180, 10, drawParams.cannonColor);
-    DrawLineEx(ToRayVector2(drawParams.midUp  ), ToRayVector2(drawParams.frontUp  ), 2, BLACK);
-    DrawLineEx(ToRayVector2(drawParams.midDown), ToRayVector2(drawParams.frontDown), 2, BLACK);
+    canvas.DrawCircleSector     ((drawParams.midUp   + drawParams.frontUp  ) / 2, 7, -degRot-180, -degRot, 10, CANVAS_BLACK);
+    canvas.DrawCircleSector     ((drawParams.midDown + drawParams.frontDown) / 2, 7, -degRot, -degRot+180, 10, CANVAS_BLACK);
+    canvas.DrawCircleSectorLines((drawParams.midUp   + drawParams.frontUp  ) / 2, 7, -degRot-180, -degRot, 10, drawParams.cannonColor);
+    canvas.DrawCircleSectorLines((drawParams.midDown + drawParams.frontDown) / 2, 7, -degRot, -degRot+180, 10, drawParams.cannonColor);
+    canvas.DrawLine(drawParams.midUp,   drawParams.frontUp,   2, CANVAS_BLACK);
+    canvas.DrawLine(drawParams.midDown, drawParams.frontDown, 2, CANVAS_BLACK);
 
     // Draw the tip of the barrel.
-    DrawTriangle(ToRayVector2(drawParams.frontDown), ToRayVector2(drawParams.frontUp  ), ToRayVector2(drawParams.midUp    ), BLACK);
-    DrawTriangle(ToRayVector2(drawParams.midUp    ), ToRayVector2(drawParams.midDown  ), ToRayVector2(drawParams.frontDown), BLACK);
-    DrawLineEx  (ToRayVector2(drawParams.midUp    ), ToRayVector2(drawParams.midDown  ), 1, drawParams.cannonColor);
-    DrawLineEx  (ToRayVector2(drawParams.frontUp  ), ToRayVector2(drawParams.frontDown), 1, drawParams.cannonColor);
+    canvas.DrawTriangle(drawParams.frontDown, drawParams.frontUp,   drawParams.midUp,     CANVAS_BLACK);
+    canvas.DrawTriangle(drawParams.midUp,     drawParams.midDown,   drawParams.frontDown, CANVAS_BLACK);
+    canvas.DrawLine    (drawParams.midUp,     drawParams.midDown,   1, drawParams.cannonColor);
+    canvas.DrawLine    (drawParams.frontUp,   drawParams.frontDown, 1, drawParams.cannonColor);
 
     // Draw the wick.
-    DrawLineBezierCubic(ToRayVector2(drawParams.wick0),
-                        ToRayVector2(drawParams.wick1),
-                        ToRayVector2(drawParams.wick2),
-                        ToRayVector2(drawParams.wick3), 1, drawParams.cannonColor);
+    canvas.DrawBezierCubic(drawParams.wick0,
+                           drawParams.wick1,
+                           drawParams.wick2,
+                           drawParams.wick3, 1, drawParams.cannonColor);
 }
 
-void Cannon::DrawTrajectories()
+void Cannon::DrawTrajectories(Canvas& canvas)
 {
-    const Color curColor = { drawParams.trajectoryColor.r,
-                             drawParams.trajectoryColor.g,
-                             drawParams.trajectoryColor.b,
-                             (unsigned char)(drawParams.trajectoryAlpha * 255) };
+    RefreshTrajectory();
+    const CanvasColor curColor = { drawParams.trajectoryColor.r,
+                                   drawParams.trajectoryColor.g,
+                                   drawParams.trajectoryColor.b,
+                                   (uint8_t)(drawParams.trajectoryAlpha * 255) };
     
     // Draw the trajectory.
     if (!applyDrag)
-        DrawLineBezierQuad(ToRayVector2(shootingPoint), ToRayVector2(landingPosition), ToRayVector2(controlPoint), 1, curColor);
+    {
+        canvas.DrawBezierQuad(shootingPoint, prediction.landingPosition, prediction.controlPoint, 1, curColor);
+    }
     else
-        DrawLineStrip(posPredicted.data(), (int)posPredicted.size(), curColor);
+    {
+        canvas.DrawLineStrip(posPredicted.data(), posPredicted.size(), 1, curColor);
+    }
 
     // Draw the arrow at the end of the trajectory.
-    DrawPoly(ToRayVector2(landingPosition), 3, 12, radToDeg(landingVelocity.GetAngle()) - 90, curColor);
+    canvas.DrawPoly(prediction.landingPosition, 3, 12, radToDeg(prediction.landingVelocity.GetAngle()) - 90, curColor);
     
     // Draw the cannonball trajectories.
-    for (CannonBall* projectile : projectiles)
-        projectile->DrawTrajectory();
+    DrawProjectileTrajectories(canvas);
 }
 
-void Cannon::DrawMeasurements() const
+void Cannon::DrawMeasurements(Canvas& canvas, FrameArena& arena)
 {
+    RefreshTrajectory();
+
+    // The texts are drawn after the lines, in one batch.
+    CanvasLabel* labels = arena.Allocate<CanvasLabel>(3);
+
     // Draw the air time text.
     {
-        const Color curColor = { drawParams.trajectoryColor.r,
-                                 drawParams.trajectoryColor.g,
-                                 drawParams.trajectoryColor.b,
-                                 (unsigned char)(drawParams.trajectoryAlpha * 255) };
-        std::stringstream textValue; textValue << std::fixed << std::setprecision(2) << airTime << "s";
-        const Maths::Vector2 textPos = { highestPoint.x - MeasureText(textValue.str().c_str(), 30) / 2.f, highestPoint.y - 35 };
-        DrawText(textValue.str().c_str(), (int)textPos.x, (int)textPos.y, 30, curColor);
+        const CanvasColor curColor = { drawParams.trajectoryColor.r,
+                                       drawParams.trajectoryColor.g,
+                                       drawParams.trajectoryColor.b,
+                                       (uint8_t)(drawParams.trajectoryAlpha * 255) };
+        airTimeLabel.Set(prediction.airTime, 2, "s");
+        labels[0] = { airTimeLabel.GetText(), { prediction.highestPoint.x - airTimeLabel.GetWidth(canvas, 30) / 2.f, prediction.highestPoint.y - 35 }, 30, curColor };
     }
     
     // Draw the landing distance.
     {
-        const Color curColor = { drawParams.landingDistanceColor.r,
-                                 drawParams.landingDistanceColor.g,
-                                 drawParams.landingDistanceColor.b,
-                                 (unsigned char)(drawParams.measurementsAlpha * 255) };
-        DrawLine((int)shootingPoint.x, (int)groundHeight + 20, (int)(shootingPoint.x + landingDistance), (int)groundHeight + 20, curColor);
-        DrawPoly({ shootingPoint.x                   + 12, groundHeight + 20 }, 3, 12,  90, curColor);
-        DrawPoly({ shootingPoint.x + landingDistance - 12, groundHeight + 20 }, 3, 12, -90, curColor);
-        std::stringstream textValue; textValue << std::fixed << std::setprecision(0) << landingDistance << "px";
-        DrawText(textValue.str().c_str(), (int)(shootingPoint.x + landingDistance / 2 - MeasureText(textValue.str().c_str(), 30) / 2.f), (int)groundHeight + 30, 30, curColor);
+        const CanvasColor curColor = { drawParams.landingDistanceColor.r,
+                                       drawParams.landingDistanceColor.g,
+                                       drawParams.landingDistanceColor.b,
+                                       (uint8_t)(drawParams.measurementsAlpha * 255) };
+        const float landingDistance = prediction.landingDistance;
+        canvas.DrawLine({ shootingPoint.x, groundHeight + 20 }, { shootingPoint.x + landingDistance, groundHeight + 20 }, 1, curColor);
+        canvas.DrawPoly({ shootingPoint.x                   + 12, groundHeight + 20 }, 3, 12,  90, curColor);
+        canvas.DrawPoly({ shootingPoint.x + landingDistance - 12, groundHeight + 20 }, 3, 12, -90, curColor);
+        landingDistanceLabel.Set(landingDistance, 0, "px");
+        labels[1] = { landingDistanceLabel.GetText(), { shootingPoint.x + landingDistance / 2 - landingDistanceLabel.GetWidth(canvas, 30) / 2.f, groundHeight + 30 }, 30, curColor };
     }
 
     // Draw the maximum height.
     {
-        const Color curColor = { drawParams.maxHeightColor.r,
-                                 drawParams.maxHeightColor.g,
-                                 drawParams.maxHeightColor.b,
-                                 (unsigned char)(drawParams.measurementsAlpha * 255) };
-        DrawLine(30, (int)shootingPoint.y, 30, (int)(shootingPoint.y - maxHeight), curColor);
-        DrawPoly({ 30, shootingPoint.y             - 12 }, 3, 12,   0, curColor);
-        DrawPoly({ 30, shootingPoint.y - maxHeight + 12 }, 3, 12, 180, curColor);
-        std::stringstream textValue; textValue << std::fixed << std::setprecision(0) << maxHeight << "px";
-        DrawText(textValue.str().c_str(), 15, (int)(shootingPoint.y - maxHeight) - 30, 30, curColor);
+        const CanvasColor curColor = { drawParams.maxHeightColor.r,
+                                       drawParams.maxHeightColor.g,
+                                       drawParams.maxHeightColor.b,
+                                       (uint8_t)(drawParams.measurementsAlpha * 255) };
+        const float maxHeight = prediction.maxHeight;
+        canvas.DrawLine({ 30, shootingPoint.y }, { 30, shootingPoint.y - maxHeight }, 1, curColor);
+        canvas.DrawPoly({ 30, shootingPoint.y             - 12 }, 3, 12,   0, curColor);
+        canvas.DrawPoly({ 30, shootingPoint.y - maxHeight + 12 }, 3, 12, 180, curColor);
+        maxHeightLabel.Set(maxHeight, 0, "px");
+        labels[2] = { maxHeightLabel.GetText(), { 15, shootingPoint.y - maxHeight - 30 }, 30, curColor };
     }
+    canvas.DrawLabels(labels, 3);
 }
 
 void Cannon::Shoot()
 {
-    const float projectileVelocity = ComputeMuzzleVelocity();
+    RefreshDrawPoints();
+    const float projectileVelocity = Physics::ComputeMuzzleVelocity(properties);
 
     // Play shooting particles.
     const SpawnerParticleParams params = {
@@ -314,37 +409,38 @@ void Cannon::Shoot()
         0, 0,
         20, 50,
         0.05f, 0.2f,
-        ORANGE,
+        CANVAS_ORANGE,
     };
     particleManager.CreateSpawner(20, 0.2f, params);
     
     // Shoot a new cannonball.
-    projectiles.push_back(new CannonBall(particleManager, shootingPoint, Maths::Vector2(transform.rotation, projectileVelocity, true), airTime, groundHeight));
-    projectiles.back()->applyDrag = applyDrag;
-    projectiles.back()->radius    = properties.projectileRadius;
-    projectiles.back()->mass      = properties.projectileMass;
+    Physics::Projectile projectile(shootingPoint, Maths::Vector2(transform.rotation, projectileVelocity, true));
+    projectile.applyDrag = applyDrag;
+    projectile.radius    = properties.projectileRadius;
+    projectile.mass      = properties.projectileMass;
+    projectiles.Add(projectile);
 
     ApplyRecoil();
 
     // Destroy the oldest projectile if there are too many.
-    if (projectiles.size() > MAX_PROJECTILES)
+    if (projectiles.Size() > MAX_PROJECTILES)
     {
-        for (size_t i = 0; i < projectiles.size(); i++)
+        for (size_t i = 0; i < projectiles.Size(); i++)
         {
-            if (!projectiles[i]->IsDestroying())
+            if (!projectiles.IsDestroying(i))
             {
-                projectiles[i]->Destroy();
+                projectiles.Destroy(i);
                 break;
             }
         }
     }
 }
 
-void Cannon::ClearProjectiles() const
+void Cannon::ClearProjectiles()
 {
-    for (CannonBall* projectile : projectiles)
+    for (size_t i = 0; i < projectiles.Size(); i++)
     {
-        if (!projectile->IsDestroying())
-            projectile->Destroy();
+        if (!projectiles.IsDestroying(i))
+            projectiles.Destroy(i);
     }
 }
@@ -0,0 +1,70 @@
+#include "FrameArena.h"
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+
+
+static std::unique_ptr<std::max_align_t[]> AllocateBlock(const size_t& size)
+{
+    return std::make_unique<std::max_align_t[]>((size + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t));
+}
+
+FrameArena::FrameArena(const size_t& _capacity)
+    : buffer(AllocateBlock(_capacity)), capacity(_capacity)
+{
+}
+
+void* FrameArena::Allocate(const size_t& size, const size_t& alignment)
+{
+    const size_t start = (used + alignment - 1) & ~(alignment - 1);
+    if (start + size <= capacity)
+    {
+        used = start + size;
+        return reinterpret_cast<uint8_t*>(buffer.get()) + start;
+    }
+
+    // Doesn't fit: give it its own block until the buffer grows.
+    overflow.push_back(AllocateBlock(size));
+    overflowSize += size;
+    return overflow.back().get();
+}
+
+const char* FrameArena::Format(const char* format, ...)
+{
+    // Try to write in the space left, and allocate the exact size if it doesn't fit.
+    va_list args, argsCopy;
+    va_start(args, format);
+    va_copy(argsCopy, args);
+    const size_t space  = capacity - std::min(used, capacity);
+    char*        text   = reinterpret_cast<char*>(buffer.get()) + capacity - space;
+    const int    length = std::vsnprintf(text, space, format, args);
+    va_end(args);
+
+    if (length < 0) {
+        va_end(argsCopy);
+        return "";
+    }
+    if ((size_t)length < space) {
+        used += length + 1;
+    }
+    else {
+        text = static_cast<char*>(Allocate(length + 1, 1));
+        std::vsnprintf(text, length + 1, format, argsCopy);
+    }
+    va_end(argsCopy);
+    return text;
+}
+
+void FrameArena::Reset()
+{
+    highWater = std::max(highWater, GetUsed());
+    if (!overflow.empty())
+    {
+        // Grow to fit everything that was allocated this frame, with room to spare.
+        capacity = std::max(capacity * 2, highWater + highWater / 2);
+        buffer   = AllocateBlock(capacity);
+        overflow.clear();
+        overflowSize = 0;
+    }
+    used = 0;
+}
@@ -0,0 +1,91 @@
+#include "FrameTimeRecorder.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+
+const char* GetFramePartName(const FrameParts& part)
+{
+    switch (part)
+    {
+    case FrameParts::TOTAL:        return "Total";
+    case FrameParts::UPDATE:       return "Update";
+    case FrameParts::DRAW:         return "Draw";
+    case FrameParts::POST_PROCESS: return "Post-process";
+    case FrameParts::UI:           return "UI";
+    default:                       return "Unknown";
+    }
+}
+
+FrameTimeRecorder::FrameTimeRecorder(const size_t& _capacity)
+    : samples(std::max(_capacity, (size_t)1)), capacity(std::max(_capacity, (size_t)1))
+{
+}
+
+void FrameTimeRecorder::Record(const FrameTimeSample& sample)
+{
+    samples[frameCount++ % capacity] = sample;
+}
+
+const FrameTimeSample& FrameTimeRecorder::GetSample(const size_t& index) const
+{
+    const size_t first = frameCount < capacity ? 0 : frameCount - capacity;
+    return samples[(first + index) % capacity];
+}
+
+FrameTimePercentiles FrameTimeRecorder::GetPercentiles(const FrameParts& part) const
+{
+    const size_t size = GetSize();
+    if (size == 0)
+        return {};
+    GetHistory(part, sorted);
+    std::sort(sorted.begin(), sorted.end());
+
+    // Smallest time that at least p percent of the frames don't exceed.
+    const auto percentile = [&](const float& p) { return sorted[std::clamp((size_t)std::ceil(p * size), (size_t)1, size) - 1]; };
+    return { percentile(0.5f), percentile(0.95f), percentile(0.99f), sorted.back() };
+}
+
+void FrameTimeRecorder::GetHistory(const FrameParts& part, std::vector<float>& times) const
+{
+    const size_t size = GetSize();
+    times.resize(size);
+    for (size_t i = 0; i < size; i++)
+        times[i] = GetSample(i)[part];
+}
+
+void FrameTimeRecorder::GetHistogram(const FrameParts& part, const float& maxTime, std::vector<float>& bins) const
+{
+    std::fill(bins.begin(), bins.end(), 0.f);
+    if (bins.empty() || maxTime <= 0)
+        return;
+    const size_t size = GetSize();
+    for (size_t i = 0; i < size; i++)
+    {
+        const float  time = GetSample(i)[part];
+        const size_t bin  = time <= 0 ? 0 : std::min((size_t)(time / maxTime * bins.size()), bins.size() - 1);
+        bins[bin]++;
+    }
+}
+
+bool FrameTimeRecorder::WriteCsv(const std::string& path) const
+{
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (!file)
+        return false;
+
+    // Frame numbers count every frame recorded, so that dumps taken at different times can be lined up.
+    std::fprintf(file, "frame,total_ms,update_ms,draw_ms,post_process_ms,ui_ms\n");
+
+    const size_t size  = GetSize();
+    const size_t first = frameCount - size;
+    for (size_t i = 0; i < size; i++)
+    {
+        const FrameTimeSample& sample = GetSample(i);
+        std::fprintf(file, "%zu", first + i);
+        for (size_t part = 0; part < FRAME_PART_COUNT; part++)
+            std::fprintf(file, ",%.4f", sample.times[part]);
+        std::fprintf(file, "\n");
+    }
+    return std::fclose(file) == 0;
+}
@@ -0,0 +1,252 @@
+#include "FrameWriter.h"
+#include "Profiler.h"
+#include <algorithm>
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#define STB_IMAGE_WRITE_STATIC
+#include "raylib/external/stb_image_write.h"
+
+#ifdef _WIN32
+    #include <fcntl.h>
+    #include <io.h>
+#endif
+
+
+const char* GetFrameFormatName(const FrameFormats& format)
+{
+    switch (format)
+    {
+    case FrameFormats::RAW: return "Raw RGBA";
+    case FrameFormats::PNG: return "PNG sequence";
+    case FrameFormats::Y4M: return "Y4M";
+    default:                return "Unknown";
+    }
+}
+
+FrameFormats GetFrameFormat(const std::string& path)
+{
+    const auto hasExtension = [&](const std::string& extension)
+    {
+        return path.size() >= extension.size() && path.compare(path.size() - extension.size(), extension.size(), extension) == 0;
+    };
+    if (path == "-" || hasExtension(".y4m"))
+        return FrameFormats::Y4M;
+    if (hasExtension(".png"))
+        return FrameFormats::PNG;
+    return FrameFormats::RAW;
+}
+
+// Splits a PNG sequence path around its frame number conversion, which must be the only one: %d with an optional 0 flag and width.
+// Other percent signs must be escaped as "%%". Returns false if the path isn't a valid pattern.
+static bool ParseFramePattern(const std::string& path, std::string& prefix, std::string& suffix, int& digits, bool& zeroPad)
+{
+    bool found = false;
+    prefix.clear();
+    suffix.clear();
+    for (size_t i = 0; i < path.size(); i++)
+    {
+        std::string& part = found ? suffix : prefix;
+        if (path[i] != '%') {
+            part += path[i];
+            continue;
+        }
+        if (i + 1 < path.size() && path[i + 1] == '%') {
+            part += '%';
+            i++;
+            continue;
+        }
+        if (found)
+            return false;
+
+        // Read the flag and width, then expect the d.
+        size_t j = i + 1;
+        zeroPad = j < path.size() && path[j] == '0';
+        digits  = 0;
+        while (j < path.size() && '0' <= path[j] && path[j] <= '9' && digits < 100)
+            digits = digits * 10 + (path[j++] - '0');
+        if (j >= path.size() || path[j] != 'd')
+            return false;
+        found = true;
+        i = j;
+    }
+    return found;
+}
+
+bool FrameWriter::Open(const std::string& _path, const FrameFormats& _format, const int& width, const int& height, const int& _fps)
+{
+    Close();
+    path     = _path;
+    format   = _format;
+    fps      = _fps;
+    failed   = false;
+    stopping = false;
+    writing  = false;
+    writtenCount = 0;
+    drawnFrame   = 0;
+    frames[0].Resize(width, height);
+    frames[1].Resize(width, height);
+
+    // PNG sequences need a frame number in their path, streams are opened once.
+    if (format == FrameFormats::PNG)
+    {
+        if (!ParseFramePattern(path, framePrefix, frameSuffix, frameDigits, frameZeroPad))
+            return false;
+    }
+    else if (path == "-")
+    {
+        #ifdef _WIN32
+            _setmode(_fileno(stdout), _O_BINARY);
+        #endif
+        stream = stdout;
+    }
+    else
+    {
+        stream = std::fopen(path.c_str(), "wb");
+        if (!stream)
+            return false;
+    }
+
+    // Y4M only has full frame rates and square pixels.
+    if (format == FrameFormats::Y4M && std::fprintf(stream, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", width, height, fps) < 0)
+    {
+        Close();
+        return false;
+    }
+
+    thread = std::thread(&FrameWriter::Run, this);
+    return true;
+}
+
+bool FrameWriter::Submit()
+{
+    PROFILE_ZONE("FrameWriter::Submit");
+    std::unique_lock<std::mutex> lock(mutex);
+    condition.wait(lock, [this]() { return !writing; });
+    if (failed)
+        return false;
+
+    drawnFrame ^= 1;
+    writing = true;
+    condition.notify_all();
+    return true;
+}
+
+bool FrameWriter::Close()
+{
+    if (thread.joinable())
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this]() { return !writing; });
+            stopping = true;
+        }
+        condition.notify_all();
+        thread.join();
+    }
+
+    if (stream)
+    {
+        if (stream == stdout) failed |= std::fflush(stream) != 0;
+        else                  failed |= std::fclose(stream) != 0;
+        stream = nullptr;
+    }
+    return !failed;
+}
+
+void FrameWriter::Run()
+{
+    Profiler::SetThreadName("Frame writer");
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        condition.wait(lock, [this]() { return writing || stopping; });
+        if (!writing)
+            break;
+
+        // The frame that isn't drawn can be read without the lock until writing is cleared.
+        const FrameImage& frame = frames[drawnFrame ^ 1];
+        const size_t      index = writtenCount;
+        lock.unlock();
+        const bool written = Write(frame, index);
+        lock.lock();
+
+        if (written) writtenCount++;
+        else         failed = true;
+        writing = false;
+        condition.notify_all();
+    }
+}
+
+bool FrameWriter::Write(const FrameImage& frame, const size_t& index)
+{
+    PROFILE_ZONE("FrameWriter::Write");
+    const int width = frame.width, height = frame.height;
+    switch (format)
+    {
+    case FrameFormats::RAW:
+    {
+        // Frames are written opaque, like they are shown on screen.
+        encodeBuffer.assign(frame.pixels.begin(), frame.pixels.end());
+        for (size_t i = 3; i < encodeBuffer.size(); i += 4)
+            encodeBuffer[i] = 255;
+        return std::fwrite(encodeBuffer.data(), 1, encodeBuffer.size(), stream) == encodeBuffer.size();
+    }
+    case FrameFormats::PNG:
+    {
+        encodeBuffer.resize((size_t)width * height * 3);
+        for (size_t i = 0, j = 0; j < encodeBuffer.size(); i += 4, j += 3)
+        {
+            encodeBuffer[j + 0] = frame.pixels[i + 0];
+            encodeBuffer[j + 1] = frame.pixels[i + 1];
+            encodeBuffer[j + 2] = frame.pixels[i + 2];
+        }
+        // The path is never used as a format, only its parts around the frame number.
+        char framePath[1024];
+        const int length = std::snprintf(framePath, sizeof(framePath), frameZeroPad ? "%s%0*zu%s" : "%s%*zu%s",
+                                         framePrefix.c_str(), frameDigits, index, frameSuffix.c_str());
+        if (length < 0 || length >= (int)sizeof(framePath))
+            return false;
+        return stbi_write_png(framePath, width, height, 3, encodeBuffer.data(), width * 3) != 0;
+    }
+    case FrameFormats::Y4M:
+    {
+        // BT.601 limited range, with the chroma of each 2x2 block of pixels averaged.
+        const int chromaWidth = (width + 1) / 2, chromaHeight = (height + 1) / 2;
+        const size_t lumaSize = (size_t)width * height, chromaSize = (size_t)chromaWidth * chromaHeight;
+        encodeBuffer.resize(lumaSize + 2 * chromaSize);
+        uint8_t* luma = encodeBuffer.data();
+        uint8_t* cb   = luma + lumaSize;
+        uint8_t* cr   = cb   + chromaSize;
+        for (int y = 0; y < height; y++)
+        {
+            const uint8_t* row = frame.GetRow(y);
+            for (int x = 0; x < width; x++)
+            {
+                const int r = row[x * 4], g = row[x * 4 + 1], b = row[x * 4 + 2];
+                luma[(size_t)y * width + x] = (uint8_t)(16 + ((66 * r + 129 * g + 25 * b + 128) >> 8));
+            }
+        }
+        for (int y = 0; y < chromaHeight; y++)
+        {
+            for (int x = 0; x < chromaWidth; x++)
+            {
+                int r = 0, g = 0, b = 0, count = 0;
+                for (int sy = 2 * y; sy < std::min(2 * y + 2, height); sy++)
+                {
+                    for (int sx = 2 * x; sx < std::min(2 * x + 2, width); sx++)
+                    {
+                        const uint8_t* pixel = frame.GetPixel(sx, sy);
+                        r += pixel[0]; g += pixel[1]; b += pixel[2]; count++;
+                    }
+                }
+                r = (r + count / 2) / count; g = (g + count / 2) / count; b = (b + count / 2) / count;
+                cb[(size_t)y * chromaWidth + x] = (uint8_t)(128 + ((-38 * r -  74 * g + 112 * b + 128) >> 8));
+                cr[(size_t)y * chromaWidth + x] = (uint8_t)(128 + ((112 * r -  94 * g -  18 * b + 128) >> 8));
+            }
+        }
+        return std::fputs("FRAME\n", stream) >= 0 && std::fwrite(encodeBuffer.data(), 1, encodeBuffer.size(), stream) == encodeBuffer.size();
+    }
+    default:
+        return false;
+    }
+}
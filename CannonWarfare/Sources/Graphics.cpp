@@ -1,11 +1,14 @@
 ﻿#include "Graphics.h"
 #include "RaylibConversions.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cmath>
 
 Graphics::Graphics(const Maths::Vector2& _screenSize)
     : screenSize(_screenSize)
 {
-    // Adjust the bloom intensity according to screen size.
-    bloomIntensity = (int)(bloomIntensity * screenSize.x / 2560.f);
+    // Adjust the bloom settings according to screen size.
+    bloom = GetDefaultBloomSettings((int)screenSize.x);
 
     // Load shaders.
     gaussianBlurShader        = LoadShader(NULL, "Resources/Shaders/GaussianBlur.fs");
@@ -14,7 +17,22 @@ Graphics::Graphics(const Maths::Vector2& _screenSize)
     renderTexture             = LoadRenderTexture((int)screenSize.x, (int)screenSize.y);
     blurTextures[0]           = LoadRenderTexture((int)screenSize.x, (int)screenSize.y);
     blurTextures[1]           = LoadRenderTexture((int)screenSize.x, (int)screenSize.y);
-    blurDirLocation           = GetShaderLocation(gaussianBlurShader, "isVertical");
+    bloomDownsampleShader     = LoadShader(NULL, "Resources/Shaders/BloomDownsample.fs");
+    bloomUpsampleShader       = LoadShader(NULL, "Resources/Shaders/BloomUpsample.fs");
+    blurDirLocation             = GetShaderLocation(gaussianBlurShader, "isVertical");
+    downsampleTexelSizeLocation = GetShaderLocation(bloomDownsampleShader, "texelSize");
+    upsampleTexelSizeLocation   = GetShaderLocation(bloomUpsampleShader,   "texelSize");
+    upsampleIntensityLocation   = GetShaderLocation(bloomUpsampleShader,   "intensity");
+
+    // Load the mip chain textures. The bloom shaders sample between texels, so the textures they read are filtered bilinearly.
+    // Full size textures are still drawn on texel centers, so this doesn't change the other passes.
+    SetTextureFilter(renderTexture.texture, TEXTURE_FILTER_BILINEAR);
+    mipTextureCount = GetBloomMipLevelCount({ BloomModes::MIP_CHAIN, 0, BLOOM_MAX_MIP_LEVELS }, (int)screenSize.x, (int)screenSize.y);
+    for (int i = 0; i < mipTextureCount; i++)
+    {
+        mipTextures[i] = LoadRenderTexture(GetBloomMipWidth((int)screenSize.x, i), GetBloomMipHeight((int)screenSize.y, i));
+        SetTextureFilter(mipTextures[i].texture, TEXTURE_FILTER_BILINEAR);
+    }
 
     // Set gaussian blur shader screen size.
     {
@@ -29,6 +47,20 @@ Graphics::Graphics(const Maths::Vector2& _screenSize)
     }
 }
 
+Graphics::~Graphics()
+{
+    UnloadShader(gaussianBlurShader);
+    UnloadShader(nonBlackMaskShader);
+    UnloadShader(chromaticAberrationShader);
+    UnloadShader(bloomDownsampleShader);
+    UnloadShader(bloomUpsampleShader);
+    UnloadRenderTexture(renderTexture);
+    UnloadRenderTexture(blurTextures[0]);
+    UnloadRenderTexture(blurTextures[1]);
+    for (int i = 0; i < mipTextureCount; i++)
+        UnloadRenderTexture(mipTextures[i]);
+}
+
 void Graphics::BeginDrawing() const
 {
     if (mouseCursorHidden)
@@ -37,7 +69,7 @@ void Graphics::BeginDrawing() const
     ClearBackground(BLACK);
 }
 
-void Graphics::EndDrawing() const
+void Graphics::PostProcess() const
 {
     EndTextureMode();
     ApplyBlur();
@@ -66,12 +98,26 @@ void Graphics::EndDrawing() const
         }
         EndShaderMode();
     }
+}
+
+void Graphics::EndDrawing() const
+{
     ::EndDrawing();
 }
 
 void Graphics::ApplyBlur() const
 {
-    for (int i = 0; i < bloomIntensity; i++)
+    PROFILE_ZONE("Graphics::ApplyBlur"); // Time to submit the passes, the GPU runs them later.
+    if (bloom.mode == BloomModes::BLUR_PASSES)
+        ApplyBlurPasses();
+    else
+        ApplyMipChain();
+}
+
+void Graphics::ApplyBlurPasses() const
+{
+    const int passCount = std::clamp(bloom.blurPasses, 1, BLOOM_MAX_BLUR_PASSES);
+    for (int i = 0; i < passCount; i++)
     {
         // Draw the render texture on the first blurring texture.
         BeginTextureMode(blurTextures[0]);
@@ -105,3 +151,47 @@ void Graphics::ApplyBlur() const
         }
     }
 }
+
+// Draws a whole render texture stretched over the whole destination render texture, with the given shader.
+static void DrawBloomPass(const RenderTexture2D& source, const RenderTexture2D& destination, const Shader& shader, const int& texelSizeLocation, const Color& tint, const bool& clear)
+{
+    const ::Vector2 texelSize = { 1.f / source.texture.width, 1.f / source.texture.height };
+    BeginTextureMode(destination);
+    {
+        if (clear)
+            ClearBackground(BLACK);
+        BeginShaderMode(shader);
+        SetShaderValue(shader, texelSizeLocation, &texelSize, SHADER_UNIFORM_VEC2);
+        DrawTexturePro(source.texture,
+                       Rectangle{0, 0, (float)source.texture.width, -(float)source.texture.height},
+                       Rectangle{0, 0, (float)destination.texture.width, (float)destination.texture.height},
+                       ::Vector2{0, 0}, 0,
+                       tint);
+        EndShaderMode();
+    }
+    EndTextureMode();
+}
+
+void Graphics::ApplyMipChain() const
+{
+    // Same passes as BloomReference::ApplyMipChain (see Bloom.cpp).
+    const int levelCount = std::min(GetBloomMipLevelCount(bloom, (int)screenSize.x, (int)screenSize.y), mipTextureCount);
+
+    // Downsample the render texture into each level. Unlit pixels are already black, so they don't need to be masked.
+    for (int level = 0; level < levelCount; level++)
+        DrawBloomPass(level == 0 ? renderTexture : mipTextures[level - 1], mipTextures[level], bloomDownsampleShader, downsampleTexelSizeLocation, WHITE, true);
+
+    // Blend each level over the one above it with alpha blending, so that they are averaged.
+    float intensity = 1;
+    SetShaderValue(bloomUpsampleShader, upsampleIntensityLocation, &intensity, SHADER_UNIFORM_FLOAT);
+    for (int level = levelCount - 1; level > 0; level--)
+    {
+        const unsigned char alpha = (unsigned char)std::round(GetBloomUpsampleOpacity(levelCount, level) * 255);
+        DrawBloomPass(mipTextures[level], mipTextures[level - 1], bloomUpsampleShader, upsampleTexelSizeLocation, Color{ 255, 255, 255, alpha }, false);
+    }
+
+    // Upsample the first level to the screen size with the glow intensity.
+    intensity = std::max(bloom.mipIntensity, 0.f);
+    SetShaderValue(bloomUpsampleShader, upsampleIntensityLocation, &intensity, SHADER_UNIFORM_FLOAT);
+    DrawBloomPass(mipTextures[0], blurTextures[0], bloomUpsampleShader, upsampleTexelSizeLocation, WHITE, true);
+}
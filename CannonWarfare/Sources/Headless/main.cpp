@@ -0,0 +1,1022 @@
+#include "Physics/Physics.h"
+#include "Maths/Maths.h"
+#include "Maths/Transform2DBatch.h"
+#include "Maths/MatrixBatch.h"
+#include "ParticleGeometry.h"
+#include "Bloom.h"
+#include "PostProcess.h"
+#include "Scene.h"
+#include "SoftwareCanvas.h"
+#include "FrameWriter.h"
+#include "Replay.h"
+#include "Profiler.h"
+#include "FrameTimeRecorder.h"
+#include "AllocationCounter.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+using namespace std::chrono;
+using namespace Maths;
+
+// Headless driver: steps cannonballs without a window or a GPU and reports throughput.
+struct HeadlessParams
+{
+    size_t projectileCount = 100000;
+    size_t stepCount       = 600;
+    float  deltaTime       = 1.f / 60;
+    float  spacing         = 70;   // Distance between the projectiles' start positions (px).
+    bool   applyDrag       = false;
+    bool   applyCollisions = false;
+    bool   bruteForce      = false; // Test every pair of projectiles instead of using the spatial grid.
+    size_t threadCount     = 0;     // Threads used to step projectiles and compute firing tables, 0 uses every core.
+    size_t transformCount  = 0;     // If not 0, compares the transform integrator backends instead of stepping projectiles.
+    size_t predictionCount = 0;     // If not 0, compares the drag trajectory predictors instead of stepping projectiles.
+    size_t aimCount        = 0;     // If not 0, solves the firing angles for this many targets instead of stepping projectiles.
+    size_t particleCount   = 0;     // If not 0, builds and checks the geometry of this many particles instead of stepping projectiles.
+    size_t randomCount     = 0;     // If not 0, compares the random number generators on arrays of this many floats instead of stepping projectiles.
+    size_t matrixCount     = 0;     // If not 0, checks the SIMD matrix kernels against the generic template on this many matrices instead of stepping projectiles.
+    int    bloomWidth      = 0;     // If not 0, compares the CPU references of both bloom modes on an image of this size instead of stepping projectiles.
+    int    bloomHeight     = 0;
+    int    frameWidth      = 0;     // If not 0, post-processes a frame of this size on the CPU with each backend instead of stepping projectiles.
+    int    frameHeight     = 0;
+
+    // If the path isn't empty, renders the scene on the CPU and writes the frames there instead of stepping projectiles.
+    // PNG sequences need a frame number format in the path (e.g. frames/%05d.png), .y4m files and - (stdout) are Y4M streams, anything else is raw RGBA.
+    std::string renderPath;
+    int         renderWidth   = 1728;
+    int         renderHeight  = 972;
+    size_t      renderFrames  = 0;     // 0 renders 600 frames, or the whole replay.
+    int         renderFPS     = 60;
+    float       shootInterval = 0.5f;  // Simulated seconds between automatic shots, 0 never shoots.
+    uint64_t    seed          = 1;     // Seeds the stars and particles of the rendered scene.
+    bool        glow          = false; // Applies the CPU post-processing to the rendered frames.
+    std::string recordPath;            // If not empty, records the rendered session to this replay file.
+    size_t      warmUpFrames  = 0;     // If not 0, the render fails if a frame allocates on the heap after this many frames.
+
+    // If the path isn't empty, plays this replay back as fast as possible and checks its checkpoints instead of stepping projectiles.
+    // With --render, the replay drives the rendered scene instead of the automatic shots.
+    std::string replayPath;
+
+    // If not empty, the profiling zones of --render and --replay are written there as a Chrome trace.
+    std::string profilePath;
+
+    // If not empty, the time taken by each part of the rendered frames is written there as CSV.
+    std::string frameTimesPath;
+
+    // If the path isn't empty, computes a firing table and writes it there instead of stepping projectiles (binary if it ends with .bin, CSV otherwise).
+    std::string                firingTablePath;
+    Physics::FiringTableParams firingTable;
+};
+
+static void PrintUsage(const char* program)
+{
+    std::printf("Usage: %s [--projectiles N] [--steps N] [--dt seconds] [--spacing px] [--drag] [--collisions] [--brute-force] [--threads N]\n"
+                "          [--transforms N] [--predictions N] [--aim N] [--particle-geometry N] [--random N] [--matrices N]\n"
+                "          [--bloom WxH] [--post-process WxH]\n", program);
+    std::printf("       %s --render out.rgba|out.y4m|-|frames/%%05d.png [--size WxH] [--frames N] [--fps N] [--shoot-every seconds]\n"
+                "          [--seed N] [--glow] [--drag] [--collisions] [--threads N] [--record file.cwr] [--replay file.cwr]\n"
+                "          [--profile trace.json] [--frame-times file.csv] [--warm-up N]\n", program);
+    std::printf("       %s --replay file.cwr [--threads N] [--profile trace.json]\n", program);
+    std::printf("       %s --firing-table file.csv|file.bin [--charge min:max:count] [--barrel min:max:count] [--mass min:max:count]\n"
+                "          [--radius min:max:count] [--elevation min:max:count] [--launch-height px] [--threads N]\n", program);
+}
+
+// Parses a firing table axis written as min:max:count.
+static bool ParseAxis(const char* arg, Physics::FiringTableAxis& axis)
+{
+    return std::sscanf(arg, "%f:%f:%zu", &axis.min, &axis.max, &axis.count) == 3 && axis.count > 0;
+}
+
+static bool ParseArgs(const int argc, char** argv, HeadlessParams& params)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const bool hasValue = i + 1 < argc;
+        if      (!std::strcmp(argv[i], "--projectiles") && hasValue) params.projectileCount = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--steps")       && hasValue) params.stepCount       = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--dt")          && hasValue) params.deltaTime       = std::strtof(argv[++i], nullptr);
+        else if (!std::strcmp(argv[i], "--spacing")     && hasValue) params.spacing         = std::strtof(argv[++i], nullptr);
+        else if (!std::strcmp(argv[i], "--drag"))                    params.applyDrag       = true;
+        else if (!std::strcmp(argv[i], "--collisions"))              params.applyCollisions = true;
+        else if (!std::strcmp(argv[i], "--brute-force"))             params.bruteForce      = true;
+        else if (!std::strcmp(argv[i], "--transforms")  && hasValue) params.transformCount  = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--predictions") && hasValue) params.predictionCount = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--aim")         && hasValue) params.aimCount        = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--particle-geometry") && hasValue) params.particleCount = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--random")      && hasValue) params.randomCount     = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--matrices")    && hasValue) params.matrixCount     = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--bloom")       && hasValue) { if (std::sscanf(argv[++i], "%dx%d", &params.bloomWidth, &params.bloomHeight) != 2 || params.bloomWidth <= 0 || params.bloomHeight <= 0) return false; }
+        else if (!std::strcmp(argv[i], "--post-process") && hasValue) { if (std::sscanf(argv[++i], "%dx%d", &params.frameWidth, &params.frameHeight) != 2 || params.frameWidth <= 0 || params.frameHeight <= 0) return false; }
+        else if (!std::strcmp(argv[i], "--render")      && hasValue) params.renderPath      = argv[++i];
+        else if (!std::strcmp(argv[i], "--size")        && hasValue) { if (std::sscanf(argv[++i], "%dx%d", &params.renderWidth, &params.renderHeight) != 2 || params.renderWidth <= 0 || params.renderHeight <= 0) return false; }
+        else if (!std::strcmp(argv[i], "--frames")      && hasValue) params.renderFrames    = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--fps")         && hasValue) { params.renderFPS = std::atoi(argv[++i]); if (params.renderFPS <= 0) return false; }
+        else if (!std::strcmp(argv[i], "--shoot-every") && hasValue) params.shootInterval   = std::strtof(argv[++i], nullptr);
+        else if (!std::strcmp(argv[i], "--seed")        && hasValue) params.seed            = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--glow"))                    params.glow            = true;
+        else if (!std::strcmp(argv[i], "--warm-up")     && hasValue) params.warmUpFrames    = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--record")      && hasValue) params.recordPath      = argv[++i];
+        else if (!std::strcmp(argv[i], "--replay")      && hasValue) params.replayPath      = argv[++i];
+        else if (!std::strcmp(argv[i], "--profile")     && hasValue) params.profilePath     = argv[++i];
+        else if (!std::strcmp(argv[i], "--frame-times") && hasValue) params.frameTimesPath  = argv[++i];
+        else if (!std::strcmp(argv[i], "--firing-table")  && hasValue) params.firingTablePath = argv[++i];
+        else if (!std::strcmp(argv[i], "--launch-height") && hasValue) params.firingTable.launchHeight = std::strtof(argv[++i], nullptr);
+        else if (!std::strcmp(argv[i], "--threads")       && hasValue) params.threadCount = params.firingTable.threadCount = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--charge")    && hasValue) { if (!ParseAxis(argv[++i], params.firingTable.powderCharge))     return false; }
+        else if (!std::strcmp(argv[i], "--barrel")    && hasValue) { if (!ParseAxis(argv[++i], params.firingTable.barrelLength))     return false; }
+        else if (!std::strcmp(argv[i], "--mass")      && hasValue) { if (!ParseAxis(argv[++i], params.firingTable.projectileMass))   return false; }
+        else if (!std::strcmp(argv[i], "--radius")    && hasValue) { if (!ParseAxis(argv[++i], params.firingTable.projectileRadius)) return false; }
+        else if (!std::strcmp(argv[i], "--elevation") && hasValue) { if (!ParseAxis(argv[++i], params.firingTable.elevation))        return false; }
+        else return false;
+    }
+    return params.deltaTime > 0.f;
+}
+
+// Steps the same transforms with every supported integrator backend and compares their speed and results.
+static void RunTransformBenchmark(const HeadlessParams& params)
+{
+    Transform2DBatch reference;
+    for (size_t i = 0; i < params.transformCount; i++)
+    {
+        Transform2D transform;
+        transform.position       = { (float)(i % 1728), (float)(i % 972) };
+        transform.velocity       = { (float)(i % 200) - 100, (float)(i % 300) - 150 };
+        transform.acceleration   = { 0, 9.81f };
+        transform.rotateForwards = i % 2;
+        transform.angularVelocity = 1;
+        reference.Add(transform);
+    }
+
+    Transform2DBatch scalarResult;
+    for (const IntegratorBackend backend : { IntegratorBackend::SCALAR, IntegratorBackend::SSE, IntegratorBackend::AVX2 })
+    {
+        if (!IsIntegratorBackendSupported(backend)) {
+            std::printf("%-6s: not supported by this CPU\n", GetIntegratorBackendName(backend));
+            continue;
+        }
+
+        Transform2DBatch batch = reference;
+        const steady_clock::time_point start = steady_clock::now();
+        for (size_t step = 0; step < params.stepCount; step++)
+            batch.Update(params.deltaTime, backend);
+        const double seconds = duration<double>(steady_clock::now() - start).count();
+
+        // Compare the final positions with the scalar backend's.
+        float maxError = 0;
+        if (backend == IntegratorBackend::SCALAR)
+            scalarResult = batch;
+        for (size_t i = 0; i < batch.Size(); i++)
+            maxError = max(maxError, max(fabsf(batch.posX[i] - scalarResult.posX[i]), fabsf(batch.posY[i] - scalarResult.posY[i])));
+
+        const double transformSteps = (double)params.transformCount * params.stepCount;
+        std::printf("%-6s: %.3f s (%.1f M transform-steps/s), max difference with scalar: %g px\n", GetIntegratorBackendName(backend),
+                    seconds, seconds > 0 ? transformSteps / seconds / 1e6 : 0.0, maxError);
+    }
+}
+
+// Predicts trajectories with drag for many shooting angles and heights with every predictor, and compares them with the Euler predictor.
+static void RunPredictionBenchmark(const HeadlessParams& params)
+{
+    const float groundHeight = 972 - 100;
+    const Physics::CannonProperties properties;
+
+    // Shots from the barrel's tip while the cannon goes back and forth through its automatic rotation range 4 times, at 4 different heights.
+    std::vector<std::pair<Maths::Vector2, float>> shots;
+    const float barrelLength = properties.barrelLength / PIXEL_SCALE * 50 + 14;
+    for (size_t i = 0; i < params.predictionCount; i++)
+    {
+        const float time     = (float)i / params.predictionCount * 4 * 2*PI;
+        const float rotation = (sinf(time) * 0.5f + 0.5f) * (-PI/3) - PI/8;
+        const float height   = (float)(i * 4 / params.predictionCount) * 200;
+        const Maths::Vector2 anchor = { 90, groundHeight - 50 - height };
+        shots.push_back({ anchor + Maths::Vector2(rotation, barrelLength, true), rotation });
+    }
+
+    std::vector<Physics::TrajectoryPrediction> reference, rk45;
+    Physics::TrajectoryPredictor predictor;
+    for (const Physics::DragPredictionMode mode : { Physics::DragPredictionMode::EULER, Physics::DragPredictionMode::RK45, Physics::DragPredictionMode::CACHED })
+    {
+        predictor.mode = mode;
+        predictor.Clear();
+        std::vector<Physics::TrajectoryPrediction> predictions;
+        predictions.reserve(shots.size());
+
+        const steady_clock::time_point start = steady_clock::now();
+        for (const std::pair<Maths::Vector2, float>& shot : shots)
+            predictions.push_back(predictor.Predict(shot.first, shot.second, properties, groundHeight));
+        const double seconds = duration<double>(steady_clock::now() - start).count();
+
+        // Compare the landing distances and air times with Euler's.
+        if (mode == Physics::DragPredictionMode::EULER)
+            reference = predictions;
+        float maxDistanceError = 0, maxRelativeError = 0, maxAirTimeError = 0;
+        for (size_t i = 0; i < predictions.size(); i++)
+        {
+            const float distanceError = fabsf(predictions[i].landingDistance - reference[i].landingDistance);
+            maxDistanceError = max(maxDistanceError, distanceError);
+            maxRelativeError = max(maxRelativeError, distanceError / max(fabsf(reference[i].landingDistance), 1.f));
+            maxAirTimeError  = max(maxAirTimeError, fabsf(predictions[i].airTime - reference[i].airTime));
+        }
+        std::printf("%-6s: %.2f us/prediction | landing distance vs Euler: max %.2f px (%.3f%%) | air time vs Euler: max %.3f s\n",
+                    Physics::GetDragPredictionModeName(mode), seconds * 1e6 / max((float)shots.size(), 1.f), maxDistanceError, maxRelativeError * 100, maxAirTimeError);
+        if (mode == Physics::DragPredictionMode::RK45)
+            rk45 = predictions;
+
+        // Also compare the cached predictions with the ones they are interpolated from.
+        if (mode == Physics::DragPredictionMode::CACHED)
+        {
+            float maxInterpolationError = 0;
+            for (size_t i = 0; i < predictions.size(); i++)
+                maxInterpolationError = max(maxInterpolationError, fabsf(predictions[i].landingDistance - rk45[i].landingDistance));
+            std::printf("        landing distance vs RK45: max %.3f px | %zu cached samples, %zu hits, %zu misses\n",
+                        maxInterpolationError, predictor.GetSampleCount(), predictor.GetHitCount(), predictor.GetMissCount());
+        }
+    }
+}
+
+// Solves the firing angles for targets spread on the ground, then shoots at them to check how close the projectiles land.
+static void RunAimBenchmark(const HeadlessParams& params)
+{
+    const float groundHeight = 972 - 100;
+    const Physics::CannonProperties properties;
+    const Maths::Vector2 shootingPoint = { 90, groundHeight - 120 };
+    const float landingHeight = groundHeight - properties.projectileRadius;
+
+    std::vector<Maths::Vector2> targets;
+    for (size_t i = 0; i < params.aimCount; i++)
+        targets.push_back({ shootingPoint.x + 100 + 2400.f * i / max((float)params.aimCount - 1, 1.f), landingHeight });
+
+    for (const bool drag : { false, true })
+    {
+        Physics::TrajectoryPredictor predictor;
+        std::vector<Physics::FiringAngles> solutions;
+        const steady_clock::time_point start = steady_clock::now();
+        for (const Maths::Vector2& target : targets)
+            solutions.push_back(drag ? Physics::SolveFiringAnglesWithDrag(shootingPoint, target, properties, predictor)
+                                     : Physics::SolveFiringAngles        (shootingPoint, target, properties));
+        const double seconds = duration<double>(steady_clock::now() - start).count();
+
+        // Shoot at the solved angles and measure how far from the targets the projectiles land.
+        size_t reachable = 0, predictions = 0;
+        float  maxError  = 0;
+        for (size_t i = 0; i < targets.size(); i++)
+        {
+            predictions += solutions[i].predictions;
+            if (!solutions[i].reachable)
+                continue;
+            reachable++;
+            for (const float& rotation : { solutions[i].low, solutions[i].high })
+            {
+                const Physics::TrajectoryPrediction prediction = drag ? Physics::PredictTrajectoryRK45(shootingPoint, rotation, properties, groundHeight)
+                                                                      : Physics::PredictTrajectory    (shootingPoint, rotation, properties, groundHeight);
+                maxError = max(maxError, fabsf(prediction.landingPosition.x - targets[i].x));
+            }
+        }
+        std::printf("%-8s: %.2f us/solve | %zu/%zu targets reachable | max landing error %.2f px | %.1f predictions/solve\n",
+                    drag ? "Drag" : "No drag", seconds * 1e6 / max((float)targets.size(), 1.f), reachable, targets.size(), maxError,
+                    (float)predictions / max((float)targets.size(), 1.f));
+    }
+}
+
+// Builds the triangles of many particles, checks the vertex counts and positions, and that they are the same whatever the number of threads.
+static bool RunParticleGeometryBenchmark(const HeadlessParams& params)
+{
+    // Mostly lines and polygons like in the game, with a few circles.
+    std::vector<ParticleInstance> particles;
+    for (size_t i = 0; i < params.particleCount; i++)
+    {
+        const ParticleShapes shape = i % 16 == 0 ? ParticleShapes::CIRCLE : i % 2 ? ParticleShapes::LINE : ParticleShapes::POLYGON;
+        const float angle = (float)i * 0.37f;
+        particles.push_back({ shape, { (float)(i % 1728), (float)(i % 972) }, Maths::Vector2(angle, 50 + (float)(i % 300), true),
+                              angle, 5 + (float)(i % 45), (uint8_t)i, (uint8_t)(i >> 8), 255, (uint8_t)(255 - i % 128) });
+    }
+
+    Physics::JobSystem jobs(params.threadCount > 0 ? params.threadCount - 1 : Physics::JobSystem::GetDefaultWorkerCount());
+    ParticleGeometry geometry;
+    const steady_clock::time_point start = steady_clock::now();
+    for (size_t step = 0; step < params.stepCount; step++)
+        geometry.Build(particles, jobs);
+    const double seconds = duration<double>(steady_clock::now() - start).count() / max((float)params.stepCount, 1.f);
+
+    // Check that each particle's vertices are where they should be in its shape's group.
+    bool countsOk = true, contentsOk = true;
+    for (const ParticleShapes shape : { ParticleShapes::LINE, ParticleShapes::CIRCLE, ParticleShapes::POLYGON })
+    {
+        size_t particleIndex = 0, vertexIndex = geometry.GetGroupBegin(shape);
+        for (const ParticleInstance& particle : particles)
+        {
+            if (particle.shape != shape)
+                continue;
+            particleIndex++;
+            const ParticleVertex* vertices = &geometry.GetVertices()[vertexIndex];
+            vertexIndex += GetParticleVertexCount(shape);
+            for (size_t v = 0; v < GetParticleVertexCount(shape); v++)
+            {
+                const ParticleVertex& vertex = vertices[v];
+                contentsOk = contentsOk && vertex.r == particle.r && vertex.g == particle.g && vertex.b == particle.b && vertex.a == particle.a;
+                if (shape != ParticleShapes::LINE) {
+                    // Outlines are between the radius minus and plus half the line thickness.
+                    const float distance = Maths::Vector2(particle.position, { vertex.x, vertex.y }).GetLength();
+                    contentsOk = contentsOk && fabsf(fabsf(distance - particle.size) - PARTICLE_LINE_THICKNESS / 2) < 1e-3f;
+                }
+            }
+            if (shape == ParticleShapes::LINE) {
+                // The quad's corners are a0, a1, b0, b0, a1, b1: its middle is the particle and its ends are size apart.
+                const Maths::Vector2 a = (Maths::Vector2(vertices[0].x, vertices[0].y) + Maths::Vector2(vertices[1].x, vertices[1].y)) / 2;
+                const Maths::Vector2 b = (Maths::Vector2(vertices[2].x, vertices[2].y) + Maths::Vector2(vertices[5].x, vertices[5].y)) / 2;
+                contentsOk = contentsOk && Maths::Vector2(particle.position, (a + b) / 2).GetLength() < 1e-3f
+                                        && fabsf(Maths::Vector2(a, b).GetLength() - particle.size) < 1e-3f;
+            }
+        }
+        countsOk = countsOk && geometry.GetGroupSize(shape) == particleIndex * GetParticleVertexCount(shape);
+        std::printf("%-8s: %zu particles, %zu vertices from %zu\n", shape == ParticleShapes::LINE ? "Lines" : shape == ParticleShapes::CIRCLE ? "Circles" : "Polygons",
+                    particleIndex, geometry.GetGroupSize(shape), geometry.GetGroupBegin(shape));
+    }
+
+    // Build again on one thread and compare.
+    Physics::JobSystem singleThread(0);
+    ParticleGeometry reference;
+    reference.Build(particles, singleThread);
+    const bool sameAsSingleThread = reference.GetVertexCount() == geometry.GetVertexCount()
+        && std::memcmp(reference.GetVertices().data(), geometry.GetVertices().data(), geometry.GetVertexCount() * sizeof(ParticleVertex)) == 0;
+
+    std::printf("Built %zu vertices (%.1f MB) in %.3f ms on %zu threads (%.1f M vertices/s)\n", geometry.GetVertexCount(),
+                geometry.GetVertexCount() * sizeof(ParticleVertex) / 1e6, seconds * 1e3, jobs.GetWorkerCount() + 1, seconds > 0 ? geometry.GetVertexCount() / seconds / 1e6 : 0.0);
+    std::printf("Vertex counts: %s | Vertex contents: %s | Same as one thread: %s\n", countsOk ? "ok" : "WRONG", contentsOk ? "ok" : "WRONG", sameAsSingleThread ? "yes" : "NO");
+    return countsOk && contentsOk && sameAsSingleThread;
+}
+
+// Fills arrays of random floats with rand() like the particle spawners used to, and with each way of using Random.
+// Checks that the SIMD and scalar bulk generators give the same numbers, and that a seed always gives the same numbers.
+static bool RunRandomBenchmark(const HeadlessParams& params)
+{
+    const float minValue = -3.f, maxValue = 5.f;
+    std::vector<float> values(params.randomCount), reference(params.randomCount);
+    const auto time = [&](const char* name, const auto& fill)
+    {
+        const steady_clock::time_point start = steady_clock::now();
+        for (size_t step = 0; step < params.stepCount; step++)
+            fill(step);
+        const double seconds = duration<double>(steady_clock::now() - start).count();
+        std::printf("%-18s: %.2f ns/float\n", name, seconds * 1e9 / max((float)(params.stepCount * params.randomCount), 1.f));
+    };
+
+    // Same quantisation as the old RandFloatInBounds.
+    std::srand(1);
+    time("rand()", [&](const size_t&) {
+        for (float& value : values)
+            value = (float)(std::rand() % (int)(maxValue * 100 - minValue * 100) + (int)(minValue * 100)) / 100.f;
+    });
+    time("Random::Range", [&](const size_t& step) {
+        Random rng(step);
+        for (float& value : values)
+            value = rng.Range(minValue, maxValue);
+    });
+    time("FillFloatsScalar", [&](const size_t& step) {
+        Random rng(step);
+        rng.FillFloatsScalar(reference.data(), reference.size(), minValue, maxValue);
+    });
+    time("FillFloats", [&](const size_t& step) {
+        Random rng(step);
+        rng.FillFloats(values.data(), values.size(), minValue, maxValue);
+    });
+
+    // The last step of both bulk generators used the same seed.
+    const bool sameAsScalar = std::memcmp(values.data(), reference.data(), values.size() * sizeof(float)) == 0;
+    bool inRange = true;
+    double mean = 0;
+    for (const float& value : values) {
+        inRange = inRange && value >= minValue && value < maxValue;
+        mean   += value;
+    }
+    mean /= max((float)values.size(), 1.f);
+
+    // Generators with the same seed and stream give the same numbers, other streams give other numbers.
+    Random a(42, 7), b(42, 7), c(42, 8);
+    bool reproducible = true, streamsDiffer = false;
+    for (int i = 0; i < 1000; i++) {
+        const uint32_t x = a.NextU32();
+        reproducible  = reproducible  && x == b.NextU32();
+        streamsDiffer = streamsDiffer || x != c.NextU32();
+    }
+
+    std::printf("Mean: %.3f (expected %.3f) | In range: %s | SIMD same as scalar: %s | Reproducible: %s | Streams differ: %s\n",
+                mean, (minValue + maxValue) / 2, inRange ? "yes" : "NO", sameAsScalar ? "yes" : "NO", reproducible ? "yes" : "NO", streamsDiffer ? "yes" : "NO");
+    return inRange && sameAsScalar && reproducible && streamsDiffer;
+}
+
+// Compares the SIMD products, transpositions and inverses of Mat2, Mat3 and Mat4 with the generic template's on random invertible matrices,
+// and the batched transforms of every supported backend with the vectors and matrices multiplied one by one.
+// Products, transpositions and batches must give the same results, inverses use other formulas and must be within rounding of the generic ones.
+static bool RunMatrixCheck(const HeadlessParams& params)
+{
+    const size_t count = params.matrixCount;
+    std::vector<Mat2> mat2s;
+    std::vector<Mat3> mat3s;
+    std::vector<Mat4> mat4s;
+    std::vector<Vector4> vectors;
+    std::vector<Vector3> points;
+    Random rng(1);
+    for (size_t i = 0; i < count; i++)
+    {
+        // Rotation, scale and translation so that the matrices can be inverted, and a 2x2 matrix with a large diagonal.
+        mat4s.push_back(Mat4::FromTransform({ rng.Range(-10, 10), rng.Range(-10, 10), rng.Range(-10, 10) },
+                                            Quaternion::FromEuler({ rng.Range(-PI, PI), rng.Range(-PI, PI), rng.Range(-PI, PI) }),
+                                            { rng.Range(0.5f, 2), rng.Range(0.5f, 2), rng.Range(0.5f, 2) }));
+        Mat3 mat3;
+        for (int r = 0; r < 3; r++)
+            for (int c = 0; c < 3; c++)
+                mat3[r][c] = mat4s.back()[r][c];
+        mat3s.push_back(mat3);
+        mat2s.push_back(Mat2(rng.Range(0.5f, 2), rng.Range(-0.4f, 0.4f), rng.Range(-0.4f, 0.4f), rng.Range(0.5f, 2)));
+        vectors.emplace_back(rng.Range(-100, 100), rng.Range(-100, 100), rng.Range(-100, 100), rng.Range(0.5f, 2));
+        points .emplace_back(rng.Range(-100, 100), rng.Range(-100, 100), rng.Range(-100, 100));
+    }
+
+    // Average time of a kernel called for each index, in nanoseconds.
+    const auto time = [&](const auto& kernel)
+    {
+        const steady_clock::time_point start = steady_clock::now();
+        for (size_t step = 0; step < params.stepCount; step++)
+            for (size_t i = 0; i < count; i++)
+                kernel(i);
+        return duration<double>(steady_clock::now() - start).count() * 1e9 / max((float)(params.stepCount * count), 1.f);
+    };
+
+    // The SIMD kernels of the products and transpositions must give exactly the generic results.
+    // The inverses use other formulas, so their error is measured in double precision as |M * M^-1 - I|, and must stay close to the generic one.
+    bool passed = true;
+    const auto check = [&](const char* name, const auto& matrices, const auto& simd, const auto& generic, const bool& inverse)
+    {
+        using Result = decltype(simd(0));
+        std::vector<Result> simdResults(count), genericResults(count);
+        const double simdTime    = time([&](const size_t& i) { simdResults[i]    = simd(i);    });
+        const double genericTime = time([&](const size_t& i) { genericResults[i] = generic(i); });
+
+        bool same = true;
+        double simdError = 0, genericError = 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            for (int r = 0; r < simdResults[i].GetRows(); r++) {
+                for (int c = 0; c < simdResults[i].GetColumns(); c++) {
+                    same = same && simdResults[i][r][c] == genericResults[i][r][c];
+                    if (!inverse)
+                        continue;
+                    double simdProduct = 0, genericProduct = 0;
+                    for (int k = 0; k < simdResults[i].GetColumns(); k++) {
+                        simdProduct    += (double)matrices[i][r][k] * simdResults   [i][k][c];
+                        genericProduct += (double)matrices[i][r][k] * genericResults[i][k][c];
+                    }
+                    simdError    = std::max(simdError,    std::fabs(simdProduct    - (r == c)));
+                    genericError = std::max(genericError, std::fabs(genericProduct - (r == c)));
+                }
+            }
+        }
+        // Float rounding gives errors of a few 1e-7: the SIMD inverses may be up to twice as far from the identity as the generic ones.
+        const bool ok = inverse ? simdError <= 2 * std::max(genericError, 1e-6) : same;
+        std::printf("%-18s: SIMD %6.2f ns, generic %6.2f ns (%4.1fx), ", name, simdTime, genericTime, simdTime > 0 ? genericTime / simdTime : 0.0);
+        if (inverse)
+            std::printf("error %.2e vs %.2e%s\n", simdError, genericError, ok ? "" : " TOO LARGE");
+        else
+            std::printf("%s\n", ok ? "same results" : "DIFFERENT RESULTS");
+        passed = passed && ok;
+    };
+    const auto next = [&](const size_t& i) { return (i + 1) % count; };
+    check("Mat2 product",       mat2s, [&](const size_t& i) { return mat2s[i] * mat2s[next(i)]; }, [&](const size_t& i) { return MatrixGeneric::Multiply(mat2s[i], mat2s[next(i)]); }, false);
+    check("Mat4 product",       mat4s, [&](const size_t& i) { return mat4s[i] * mat4s[next(i)]; }, [&](const size_t& i) { return MatrixGeneric::Multiply(mat4s[i], mat4s[next(i)]); }, false);
+    check("Mat4 transposition", mat4s, [&](const size_t& i) { return mat4s[i].GetTransposed(); },  [&](const size_t& i) { return MatrixGeneric::Transpose(mat4s[i]); },               false);
+    check("Mat2 inverse",       mat2s, [&](const size_t& i) { return mat2s[i].Inv2(); },           [&](const size_t& i) { return MatrixGeneric::Inv2(mat2s[i]); },                    true);
+    check("Mat3 inverse",       mat3s, [&](const size_t& i) { return mat3s[i].Inv3(); },           [&](const size_t& i) { return MatrixGeneric::Inv3(mat3s[i]); },                    true);
+    check("Mat4 inverse",       mat4s, [&](const size_t& i) { return mat4s[i].Inv4(); },           [&](const size_t& i) { return MatrixGeneric::Inv4(mat4s[i]); },                    true);
+
+    // Batches against the elements multiplied one by one, with the generic product for the matrices.
+    std::vector<Vector4> vectorReference(count), vectorResults(count);
+    std::vector<Vector3> pointReference (count), pointResults (count);
+    std::vector<Mat4>    matrixReference(count), matrixResults(count);
+    const Mat4& matrix = mat4s[0];
+    for (size_t i = 0; i < count; i++)
+    {
+        vectorReference[i] = vectors[i] * matrix;
+        pointReference [i] = points [i] * matrix;
+        matrixReference[i] = MatrixGeneric::Multiply(mat4s[i], matrix);
+    }
+    for (const IntegratorBackend backend : { IntegratorBackend::SCALAR, IntegratorBackend::SSE, IntegratorBackend::AVX2 })
+    {
+        if (!IsIntegratorBackendSupported(backend)) {
+            std::printf("%-6s: not supported by this CPU\n", GetIntegratorBackendName(backend));
+            continue;
+        }
+        // Each batch is timed as one call per step, over every element.
+        const auto timeBatch = [&](const auto& batch)
+        {
+            const steady_clock::time_point start = steady_clock::now();
+            for (size_t step = 0; step < params.stepCount; step++)
+                batch();
+            return duration<double>(steady_clock::now() - start).count() * 1e9 / max((float)(params.stepCount * count), 1.f);
+        };
+        const double vectorTime = timeBatch([&]() { TransformVectors(matrix, vectors.data(), vectorResults.data(), count, backend); });
+        const double pointTime  = timeBatch([&]() { TransformPoints (matrix, points .data(), pointResults .data(), count, backend); });
+        const double matrixTime = timeBatch([&]() { MultiplyMatrices(mat4s.data(), matrix, matrixResults.data(), count, backend); });
+        const bool same = std::memcmp(vectorResults.data(), vectorReference.data(), count * sizeof(Vector4)) == 0
+                       && std::memcmp(pointResults .data(), pointReference .data(), count * sizeof(Vector3)) == 0
+                       && std::memcmp(matrixResults.data(), matrixReference.data(), count * sizeof(Mat4))    == 0;
+        std::printf("%-6s: %.2f ns/vector, %.2f ns/point, %.2f ns/matrix, same as one by one: %s\n", GetIntegratorBackendName(backend),
+                    vectorTime, pointTime, matrixTime, same ? "yes" : "NO");
+        passed = passed && same;
+    }
+    return passed;
+}
+
+// Draws rings and dots of different colors on a black image, like particles and cannonballs. Calls setPixel(x, y, rgb) for each lit pixel.
+template<typename SetPixel>
+static void DrawTestRings(const int& width, const int& height, const SetPixel& setPixel)
+{
+    Random rng(1);
+    for (int i = 0; i < 64; i++)
+    {
+        const float cx = rng.Range(0.f, (float)width), cy = rng.Range(0.f, (float)height);
+        const float radius = rng.Range(1.f, width / 64.f);
+        const float color[3] = { rng.Range(0.2f, 1.f), rng.Range(0.2f, 1.f), rng.Range(0.2f, 1.f) };
+        for (int y = (int)max(0.f, cy - radius - 1); y < min((float)height, cy + radius + 1); y++)
+            for (int x = (int)max(0.f, cx - radius - 1); x < min((float)width, cx + radius + 1); x++)
+                if (std::abs(std::sqrt((x - cx) * (x - cx) + (y - cy) * (y - cy)) - radius) < 1)
+                    setPixel(x, y, color);
+    }
+}
+
+// Runs the CPU reference of both bloom modes on an image of lit particles and cannonballs, and compares their glow and cost.
+// Checks that the glow stays within the source brightness (times the mip chain intensity), keeps the lit pixels, is centered on them, and is reproducible.
+static bool RunBloomComparison(const HeadlessParams& params)
+{
+    BloomImage source;
+    source.Resize(params.bloomWidth, params.bloomHeight);
+    DrawTestRings(source.width, source.height, [&](const int& x, const int& y, const float* color) { std::copy(color, color + 3, source.GetPixel(x, y)); });
+    double litX = 0, litY = 0, litSum = 0;
+    for (int y = 0; y < source.height; y++) {
+        for (int x = 0; x < source.width; x++) {
+            const float* pixel = source.GetPixel(x, y);
+            litX += x * (double)pixel[0]; litY += y * (double)pixel[0]; litSum += pixel[0];
+        }
+    }
+
+    bool ok = true;
+    BloomImage glows[2], composed;
+    for (const BloomModes mode : { BloomModes::BLUR_PASSES, BloomModes::MIP_CHAIN })
+    {
+        BloomSettings settings = GetDefaultBloomSettings(source.width);
+        settings.mode = mode;
+        const char* name = mode == BloomModes::BLUR_PASSES ? "Blur passes" : "Mip chain";
+
+        BloomReference reference;
+        const steady_clock::time_point start = steady_clock::now();
+        for (size_t step = 0; step < params.stepCount; step++)
+            reference.Apply(source, settings);
+        const double seconds = duration<double>(steady_clock::now() - start).count() / max((float)params.stepCount, 1.f);
+        BloomImage& glow = glows[mode == BloomModes::MIP_CHAIN];
+        glow = reference.Apply(source, settings);
+        ComposeBloom(source, glow, composed);
+
+        // Glow energy, centroid and the distance at which it fades out, compared with the lit pixels.
+        double glowX = 0, glowY = 0, glowSum = 0, maxValue = 0;
+        bool keepsLitPixels = true;
+        for (int y = 0; y < source.height; y++) {
+            for (int x = 0; x < source.width; x++) {
+                const float* pixel = glow.GetPixel(x, y);
+                glowX += x * (double)pixel[0]; glowY += y * (double)pixel[0]; glowSum += pixel[0];
+                maxValue = std::max(maxValue, (double)std::max({ pixel[0], pixel[1], pixel[2] }));
+                const float* lit = source.GetPixel(x, y);
+                if (lit[0] != 0 || lit[1] != 0 || lit[2] != 0)
+                    keepsLitPixels = keepsLitPixels && std::equal(lit, lit + 3, composed.GetPixel(x, y));
+            }
+        }
+        const double centroidError = std::sqrt(std::pow(glowX / glowSum - litX / litSum, 2) + std::pow(glowY / glowSum - litY / litSum, 2));
+        const bool inRange     = maxValue <= (mode == BloomModes::BLUR_PASSES ? 1 : settings.mipIntensity) + 1e-4;
+        const bool centered    = centroidError < source.width / 100.f;
+        const bool reproducible = BloomReference().Apply(source, settings).pixels == glow.pixels;
+
+        const BloomCost cost = GetBloomCost(settings, source.width, source.height);
+        std::printf("%-11s (%2d %s): %3d passes | %7.1f Mpx written | %8.1f M texel fetches | %8.2f ms/frame on the CPU\n",
+                    name, mode == BloomModes::BLUR_PASSES ? settings.blurPasses : GetBloomMipLevelCount(settings, source.width, source.height),
+                    mode == BloomModes::BLUR_PASSES ? "passes" : "levels", cost.passes, cost.pixelsWritten / 1e6, cost.texelFetches / 1e6, seconds * 1e3);
+        std::printf("             Glow energy: %.2f x lit | Max: %.3f | Centroid error: %.2f px | Keeps lit pixels: %s | Reproducible: %s\n",
+                    glowSum / litSum, maxValue, centroidError, keepsLitPixels ? "yes" : "NO", reproducible ? "yes" : "NO");
+        ok = ok && inRange && centered && keepsLitPixels && reproducible;
+    }
+
+    // Average difference between both glows, relative to the average glow.
+    double difference = 0, total = 0;
+    for (size_t i = 0; i < glows[0].pixels.size(); i++) {
+        difference += std::abs(glows[0].pixels[i] - glows[1].pixels[i]);
+        total      += glows[0].pixels[i];
+    }
+    const BloomCost blurCost = GetBloomCost({ BloomModes::BLUR_PASSES, GetDefaultBloomSettings(source.width).blurPasses, 0 }, source.width, source.height);
+    const BloomCost mipCost  = GetBloomCost({ BloomModes::MIP_CHAIN,   0, GetDefaultBloomSettings(source.width).mipLevels }, source.width, source.height);
+    const bool cheaper = mipCost.texelFetches < blurCost.texelFetches && mipCost.pixelsWritten < blurCost.pixelsWritten;
+    std::printf("Glow difference: %.1f%% | Mip chain fill cost: %.1f%% of the blur passes\n",
+                total > 0 ? difference / total * 100 : 0.0, (double)mipCost.pixelsWritten / blurCost.pixelsWritten * 100);
+    return ok && cheaper;
+}
+
+// FNV-1a hash of a frame, to compare frames between runs.
+static uint64_t HashFrame(const FrameImage& frame)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (const uint8_t& byte : frame.pixels)
+        hash = (hash ^ byte) * 1099511628211ull;
+    return hash;
+}
+
+// Post-processes a frame of rings on the CPU with each backend, on one thread and on every thread, and makes a thumbnail of it.
+// Checks that every backend and thread count gives the same bytes, and prints their hash so that frames can be compared between versions.
+static bool RunPostProcessBenchmark(const HeadlessParams& params)
+{
+    FrameImage source, result, reference, thumbnail;
+    source.Resize(params.frameWidth, params.frameHeight);
+    DrawTestRings(source.width, source.height, [&](const int& x, const int& y, const float* color) {
+        uint8_t* pixel = source.GetPixel(x, y);
+        for (int c = 0; c < 3; c++)
+            pixel[c] = (uint8_t)(color[c] * 255 + 0.5f);
+    });
+
+    Physics::JobSystem jobs(params.threadCount > 0 ? params.threadCount - 1 : Physics::JobSystem::GetDefaultWorkerCount());
+    Physics::JobSystem singleThread(0);
+    PostProcess postProcess;
+    postProcess.backend = PostProcessBackend::SCALAR;
+    postProcess.Apply(source, reference, singleThread);
+
+    bool sameBytes = true;
+    for (const PostProcessBackend backend : { PostProcessBackend::SCALAR, PostProcessBackend::SSE, PostProcessBackend::AVX2 })
+    {
+        if (!IsPostProcessBackendSupported(backend))
+            continue;
+        postProcess.backend = backend;
+        for (Physics::JobSystem* threads : { &singleThread, &jobs })
+        {
+            const steady_clock::time_point start = steady_clock::now();
+            for (size_t step = 0; step < params.stepCount; step++)
+                postProcess.Apply(source, result, *threads);
+            const double seconds = duration<double>(steady_clock::now() - start).count() / max((float)params.stepCount, 1.f);
+            const bool same = result.pixels == reference.pixels;
+            sameBytes = sameBytes && same;
+            std::printf("%-6s on %2zu threads: %8.2f ms/frame | Same as scalar: %s\n",
+                        GetPostProcessBackendName(backend), threads->GetWorkerCount() + 1, seconds * 1e3, same ? "yes" : "NO");
+        }
+    }
+
+    DownscaleFrame(reference, thumbnail, 8);
+    std::printf("Frame %dx%d hash: %016llx | Thumbnail %dx%d hash: %016llx\n", reference.width, reference.height, (unsigned long long)HashFrame(reference),
+                thumbnail.width, thumbnail.height, (unsigned long long)HashFrame(thumbnail));
+    return sameBytes;
+}
+
+// Writes the profiling zones still in the ring buffers as a Chrome trace, if asked to.
+static bool WriteProfile(const HeadlessParams& params)
+{
+    if (params.profilePath.empty())
+        return true;
+    if (!PROFILING)
+        std::fprintf(stderr, "Profiling zones are compiled out of this build, configure with -DCANNON_WARFARE_PROFILING=ON to keep them\n");
+    if (!Profiler::WriteChromeTrace(params.profilePath)) {
+        std::fprintf(stderr, "Can't write the profile to %s\n", params.profilePath.c_str());
+        return false;
+    }
+    std::fprintf(stderr, "Profile written to %s\n", params.profilePath.c_str());
+    return true;
+}
+
+// Simulates the scene at a fixed timestep, draws every frame on the CPU and streams them to a file while the next ones are drawn.
+// The cannon shoots at fixed simulated times, so the frames only depend on the parameters and the seed.
+// Messages are written to stderr, since the frames can be written to stdout.
+static bool RunRender(const HeadlessParams& params)
+{
+    // A replay gives the scene's size and commands.
+    Replay replay;
+    const bool replaying = !params.replayPath.empty();
+    if (replaying && !replay.Load(params.replayPath)) {
+        std::fprintf(stderr, "Can't load the replay %s\n", params.replayPath.c_str());
+        return false;
+    }
+    ReplayPlayer player(replay);
+    const int    width  = replaying ? (int)replay.header.screenSize.x : params.renderWidth;
+    const int    height = replaying ? (int)replay.header.screenSize.y : params.renderHeight;
+    const size_t frameCount = params.renderFrames > 0 ? params.renderFrames : replaying ? SIZE_MAX : 600;
+
+    const FrameFormats format = GetFrameFormat(params.renderPath);
+    FrameWriter writer;
+    if (!writer.Open(params.renderPath, format, width, height, params.renderFPS))
+    {
+        std::fprintf(stderr, "Can't write frames to %s%s\n", params.renderPath.c_str(),
+                     format == FrameFormats::PNG ? " (PNG sequences need a single frame number format, e.g. frames/%05d.png, and other percent signs written as %%)" : "");
+        return false;
+    }
+
+    Physics::JobSystem jobs(params.threadCount > 0 ? params.threadCount - 1 : Physics::JobSystem::GetDefaultWorkerCount());
+    const uint64_t seed = replaying ? replay.header.seed : params.seed;
+    Scene scene(seed);
+    scene.Init({ (float)width, (float)height });
+
+    // Same simulation rate as the app, with enough substeps to never drop time.
+    Physics::FixedTimestep timestep = { replaying ? player.GetStepRate() : 120, ceilInt(240.f / params.renderFPS) + 1 };
+
+    // Everything given to the scene goes through commands, so that the session can be recorded.
+    ReplayRecorder recorder;
+    if (!params.recordPath.empty() && !recorder.Open(params.recordPath, { seed, { (float)width, (float)height }, timestep.GetStepRate() })) {
+        std::fprintf(stderr, "Can't record the replay to %s\n", params.recordPath.c_str());
+        return false;
+    }
+    uint64_t step = 0; // The timestep counts the steps of a frame before they run.
+    const auto execute = [&](const SceneCommand& command)
+    {
+        recorder.RecordCommand(step, command);
+        scene.Execute(command);
+    };
+    if (!replaying)
+    {
+        if (params.applyDrag)       execute({ SceneCommandType::SET_APPLY_DRAG,       1 });
+        if (params.applyCollisions) execute({ SceneCommandType::SET_APPLY_COLLISIONS, 1 });
+    }
+
+    PostProcess postProcess;
+    FrameImage  drawn; // Drawn before the post-processing when there is glow.
+    if (params.glow)
+        drawn.Resize(width, height);
+    double simulatedTime = 0, nextShotTime = 0;
+    uint64_t lastFrameHash = 0;
+    uint64_t nextCheckpointStep = REPLAY_CHECKPOINT_INTERVAL;
+
+    // Keeps every frame of the run up to a limit, for the percentiles.
+    FrameTimeRecorder frameTimes(std::min(frameCount, (size_t)1 << 16));
+
+    // Frames should only allocate when a pool or arena grows, which stops once the scene reaches its steady state.
+    size_t   allocatingFrames     = 0;
+    size_t   lateAllocatingFrames = 0; // Allocating frames after the warm-up.
+    uint64_t maxFrameAllocations  = 0;
+    const uint64_t startAllocations = AllocationCounter::GetCount();
+
+    double drawSeconds = 0;
+    size_t frame = 0;
+    const steady_clock::time_point start = steady_clock::now();
+    for (; frame < frameCount && !(replaying && player.IsFinished()); frame++)
+    {
+        Profiler::MarkFrame();
+        FrameTimeSample frameSample;
+        const steady_clock::time_point frameStart = steady_clock::now();
+        const uint64_t frameAllocStart = AllocationCounter::GetCount();
+        // Step rate changes of the replay apply from the next frame.
+        if (replaying)
+            timestep.SetStepRate(player.GetStepRate());
+        const int steps = timestep.Advance(1.0 / params.renderFPS);
+        for (int i = 0; i < steps; i++)
+        {
+            if (replaying) {
+                player.Step(scene, jobs);
+            }
+            else {
+                if (params.shootInterval > 0 && simulatedTime >= nextShotTime) {
+                    execute({ SceneCommandType::SHOOT });
+                    nextShotTime += params.shootInterval;
+                }
+                scene.Update(timestep.GetStep(), jobs);
+                simulatedTime += timestep.GetStep();
+            }
+            step++;
+        }
+        frameSample[FrameParts::UPDATE] = duration<float, std::milli>(steady_clock::now() - frameStart).count();
+        if (recorder.IsOpen() && step >= nextCheckpointStep) {
+            recorder.RecordCheckpoint(step, scene.GetChecksum());
+            nextCheckpointStep = step + REPLAY_CHECKPOINT_INTERVAL;
+        }
+
+        PROFILE_ZONE("Draw frame");
+        const steady_clock::time_point drawStart = steady_clock::now();
+        const float alpha = timestep.GetAlpha();
+        scene.BuildDrawLists(alpha, jobs);
+        SoftwareCanvas canvas(params.glow ? drawn : writer.GetFrame());
+        canvas.Clear(CANVAS_BLACK);
+        scene.DrawBackground(canvas);
+        scene.DrawForeground(canvas, alpha);
+        const steady_clock::time_point postProcessStart = steady_clock::now();
+        frameSample[FrameParts::DRAW] = duration<float, std::milli>(postProcessStart - drawStart).count();
+        if (params.glow)
+            postProcess.Apply(drawn, writer.GetFrame(), jobs);
+        frameSample[FrameParts::POST_PROCESS] = duration<float, std::milli>(steady_clock::now() - postProcessStart).count();
+        lastFrameHash = HashFrame(writer.GetFrame());
+        drawSeconds += duration<double>(steady_clock::now() - drawStart).count();
+
+        // The total also contains the wait for the writer thread.
+        const bool submitted = writer.Submit();
+        frameSample[FrameParts::TOTAL] = duration<float, std::milli>(steady_clock::now() - frameStart).count();
+        frameTimes.Record(frameSample);
+        const uint64_t frameAllocations = AllocationCounter::GetCount() - frameAllocStart;
+        allocatingFrames     += frameAllocations > 0;
+        lateAllocatingFrames += frameAllocations > 0 && params.warmUpFrames > 0 && frame >= params.warmUpFrames;
+        maxFrameAllocations = std::max(maxFrameAllocations, frameAllocations);
+        if (!submitted)
+            break;
+    }
+    if (replaying)
+        player.ApplyEntries(scene);
+    if (recorder.IsOpen())
+        recorder.RecordCheckpoint(step, scene.GetChecksum());
+    const uint64_t allocations = AllocationCounter::GetCount() - startAllocations;
+    const bool written = writer.Close();
+    const double seconds = duration<double>(steady_clock::now() - start).count();
+
+    std::fprintf(stderr, "Rendered %zu / %zu frames of %dx%d at %d fps to %s (%s) in %.2f s (%.1f frames/s, %.2f ms/frame drawing, %zu threads)\n",
+                 writer.GetWrittenCount(), frame, width, height, params.renderFPS, params.renderPath.c_str(),
+                 GetFrameFormatName(format), seconds, seconds > 0 ? writer.GetWrittenCount() / seconds : 0.0,
+                 drawSeconds * 1e3 / max((float)frame, 1.f), jobs.GetWorkerCount() + 1);
+    std::fprintf(stderr, "Cannonballs: %zu | Particles: %zu | Trajectory predictions: %zu | Glow: %s | Last frame hash: %016llx\n", scene.cannon.GetProjectiles().Size(),
+                 scene.particleManager.GetParticleCount(), scene.cannon.GetPredictionCount(), params.glow ? "on" : "off", (unsigned long long)lastFrameHash);
+    std::fprintf(stderr, "Heap allocations: %llu (%zu / %zu frames allocated, at most %llu) | Frame arena: %zu / %zu bytes\n",
+                 (unsigned long long)allocations, allocatingFrames, frame, (unsigned long long)maxFrameAllocations,
+                 scene.GetFrameArena().GetHighWater(), scene.GetFrameArena().GetCapacity());
+    for (const FrameParts part : { FrameParts::TOTAL, FrameParts::UPDATE, FrameParts::DRAW, FrameParts::POST_PROCESS })
+    {
+        const FrameTimePercentiles percentiles = frameTimes.GetPercentiles(part);
+        std::fprintf(stderr, "%-12s: p50 %.2f ms | p95 %.2f ms | p99 %.2f ms | max %.2f ms\n", GetFramePartName(part),
+                     percentiles.p50, percentiles.p95, percentiles.p99, percentiles.max);
+    }
+    if (recorder.IsOpen())
+        std::fprintf(stderr, "Recorded %zu replay entries to %s\n", recorder.GetEntryCount(), params.recordPath.c_str());
+    bool frameTimesWritten = true;
+    if (!params.frameTimesPath.empty())
+    {
+        frameTimesWritten = frameTimes.WriteCsv(params.frameTimesPath);
+        if (frameTimesWritten)
+            std::fprintf(stderr, "Frame times written to %s\n", params.frameTimesPath.c_str());
+        else
+            std::fprintf(stderr, "Can't write the frame times to %s\n", params.frameTimesPath.c_str());
+    }
+    if (replaying && player.GetMismatchCount() > 0)
+        std::fprintf(stderr, "Replay checkpoints: %zu / %zu mismatched, first at step %llu\n", player.GetMismatchCount(),
+                     player.GetCheckpointCount(), (unsigned long long)player.GetFirstMismatchStep());
+    if (lateAllocatingFrames > 0)
+        std::fprintf(stderr, "%zu frames allocated after the %zu warm-up frames\n", lateAllocatingFrames, params.warmUpFrames);
+    if (!written)
+        std::fprintf(stderr, "Failed to write the frames to %s\n", params.renderPath.c_str());
+    return WriteProfile(params) && written && frameTimesWritten && player.GetMismatchCount() == 0 && lateAllocatingFrames == 0;
+}
+
+// Plays a replay back as fast as possible without drawing, and checks the scene's checksum at every checkpoint.
+static bool RunReplay(const HeadlessParams& params)
+{
+    Replay replay;
+    if (!replay.Load(params.replayPath)) {
+        std::fprintf(stderr, "Can't load the replay %s\n", params.replayPath.c_str());
+        return false;
+    }
+
+    Physics::JobSystem jobs(params.threadCount > 0 ? params.threadCount - 1 : Physics::JobSystem::GetDefaultWorkerCount());
+    Scene scene(replay.header.seed);
+    scene.Init(replay.header.screenSize);
+    ReplayPlayer player(replay);
+
+    const steady_clock::time_point start = steady_clock::now();
+    while (!player.IsFinished())
+        player.Step(scene, jobs);
+    player.ApplyEntries(scene);
+    const double seconds = duration<double>(steady_clock::now() - start).count();
+
+    std::printf("Replayed %llu steps (%zu commands, seed %llu, %.0fx%.0f) in %.3f s (%.0f steps/s, %zu threads)\n",
+                (unsigned long long)player.GetStep(), player.GetCommandCount(), (unsigned long long)replay.header.seed,
+                replay.header.screenSize.x, replay.header.screenSize.y, seconds, seconds > 0 ? player.GetStep() / seconds : 0.0, jobs.GetWorkerCount() + 1);
+    std::printf("Checkpoints: %zu | Mismatches: %zu", player.GetCheckpointCount(), player.GetMismatchCount());
+    if (player.GetMismatchCount() > 0)
+        std::printf(" (first at step %llu)", (unsigned long long)player.GetFirstMismatchStep());
+    std::printf("\n");
+    return WriteProfile(params) && player.GetMismatchCount() == 0;
+}
+
+// Computes a firing table and writes it to a file.
+static bool RunFiringTable(const HeadlessParams& params)
+{
+    const steady_clock::time_point start = steady_clock::now();
+    const Physics::FiringTable table = Physics::FiringTable::Compute(params.firingTable);
+    const double seconds = duration<double>(steady_clock::now() - start).count();
+
+    const std::string& path = params.firingTablePath;
+    const bool binary  = path.size() >= 4 && path.compare(path.size() - 4, 4, ".bin") == 0;
+    const bool written = binary ? table.WriteBinary(path) : table.WriteCSV(path);
+    if (!written) {
+        std::fprintf(stderr, "Couldn't write the firing table to %s\n", path.c_str());
+        return false;
+    }
+    std::printf("Computed %zu firing table entries in %.3f s (%.1f us/entry), written to %s\n",
+                table.entries.size(), seconds, seconds * 1e6 / max((float)table.entries.size(), 1.f), path.c_str());
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    Profiler::SetThreadName("Main");
+    HeadlessParams params;
+    if (!ParseArgs(argc, argv, params)) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+    if (params.transformCount > 0) {
+        RunTransformBenchmark(params);
+        return 0;
+    }
+    if (params.predictionCount > 0) {
+        RunPredictionBenchmark(params);
+        return 0;
+    }
+    if (params.aimCount > 0) {
+        RunAimBenchmark(params);
+        return 0;
+    }
+    if (params.particleCount > 0)
+        return RunParticleGeometryBenchmark(params) ? 0 : 1;
+    if (params.randomCount > 0)
+        return RunRandomBenchmark(params) ? 0 : 1;
+    if (params.matrixCount > 0)
+        return RunMatrixCheck(params) ? 0 : 1;
+    if (params.bloomWidth > 0)
+        return RunBloomComparison(params) ? 0 : 1;
+    if (params.frameWidth > 0)
+        return RunPostProcessBenchmark(params) ? 0 : 1;
+    if (!params.firingTablePath.empty())
+        return RunFiringTable(params) ? 0 : 1;
+    if (!params.renderPath.empty())
+        return RunRender(params) ? 0 : 1;
+    if (!params.replayPath.empty())
+        return RunReplay(params) ? 0 : 1;
+
+    // Same layout as the default 1728x972 window.
+    const float groundHeight = 972 - 100;
+    Physics::CannonProperties properties;
+    properties.anchorPos = { 90, 972 - 150 };
+    const float muzzleVelocity = Physics::ComputeMuzzleVelocity(properties);
+
+    // Shoot every projectile at a different angle in the cannon's automatic rotation range.
+    // Start positions are laid out on a grid going up from the cannon so that they don't overlap.
+    Physics::ProjectilePool projectiles;
+    projectiles.Reserve(params.projectileCount);
+    const size_t columns = (size_t)ceilInt(sqrtf((float)params.projectileCount));
+    for (size_t i = 0; i < params.projectileCount; i++)
+    {
+        const float t        = params.projectileCount > 1 ? (float)i / (params.projectileCount - 1) : 0.5f;
+        const float rotation = t * (-PI/3) - PI/8;
+        const Maths::Vector2 startPos = properties.anchorPos + Maths::Vector2((float)(i % columns), -(float)(i / columns)) * params.spacing;
+        Physics::Projectile projectile(startPos, Maths::Vector2(rotation, muzzleVelocity, true));
+        projectile.applyDrag = params.applyDrag;
+        projectile.radius    = properties.projectileRadius;
+        projectile.mass      = properties.projectileMass;
+        projectiles.Add(projectile);
+    }
+
+    // Step all the projectiles, in parallel chunks if there are several threads.
+    size_t landingCount = 0, collisionCount = 0;
+    std::vector<Physics::ProjectileEvent> events;
+    Physics::SpatialGrid grid;
+    Physics::JobSystem jobs(params.threadCount > 0 ? params.threadCount - 1 : Physics::JobSystem::GetDefaultWorkerCount());
+    const steady_clock::time_point start = steady_clock::now();
+    for (size_t step = 0; step < params.stepCount; step++)
+    {
+        events.clear();
+        if (params.applyCollisions && params.bruteForce)
+            projectiles.Collide(&events);
+        else if (params.applyCollisions)
+            projectiles.Collide(grid, &events);
+        projectiles.Step(params.deltaTime, groundHeight, jobs, &events);
+
+        for (const Physics::ProjectileEvent& event : events)
+        {
+            landingCount   += event.type == Physics::ProjectileEventType::LANDED;
+            collisionCount += event.type == Physics::ProjectileEventType::COLLIDED;
+        }
+    }
+    const double seconds = duration<double>(steady_clock::now() - start).count();
+
+    // Report throughput and a few values to check the simulation against the predictor.
+    const double projectileSteps = (double)params.projectileCount * params.stepCount;
+    std::printf("Stepped %zu projectiles x %zu steps in %.3f s (%.2f M projectile-steps/s, %zu threads)\n",
+                params.projectileCount, params.stepCount, seconds, seconds > 0 ? projectileSteps / seconds / 1e6 : 0.0, jobs.GetWorkerCount() + 1);
+    std::printf("Landed: %zu | Collisions: %zu (%s) | Drag: %s\n", landingCount, collisionCount,
+                !params.applyCollisions ? "off" : params.bruteForce ? "brute force" : "spatial grid", params.applyDrag ? "on" : "off");
+
+    // Sum the final positions, which should be the same whatever the number of threads.
+    double checksum = 0;
+    for (size_t i = 0; i < projectiles.Size(); i++)
+        checksum += (double)projectiles.posX[i] * (i % 7 + 1) + projectiles.posY[i];
+    std::printf("Position checksum: %.6f\n", checksum);
+    if (projectiles.Size() > 0 && projectiles.IsLanded(0))
+    {
+        const Physics::Projectile first = projectiles.Get(0);
+        const float rotation = -PI/8;
+        const Physics::TrajectoryPrediction prediction = params.applyDrag
+            ? Physics::PredictTrajectoryWithDrag(first.startPos, rotation, properties, groundHeight)
+            : Physics::PredictTrajectory        (first.startPos, rotation, properties, groundHeight);
+        std::printf("First projectile: air time %.2f s (predicted %.2f s), landing distance %.0f px (predicted %.0f px)\n",
+                    first.airTime, prediction.airTime, first.endPos.x - first.startPos.x, prediction.landingDistance);
+    }
+    return 0;
+}
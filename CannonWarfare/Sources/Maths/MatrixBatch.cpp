@@ -0,0 +1,214 @@
+#include "MatrixBatch.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define MATHS_X86 1
+    #include <immintrin.h>
+#endif
+
+// GCC and Clang need AVX2 enabled per function so that the rest of the program still runs on older CPUs.
+#if defined(MATHS_X86) && (defined(__GNUC__) || defined(__clang__))
+    #define MATHS_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+    #define MATHS_TARGET_AVX2
+#endif
+
+using namespace Maths;
+
+
+// ---------- SCALAR ---------- //
+
+static void TransformVectorsScalar(const Mat4& matrix, const Vector4* vectors, Vector4* results, const size_t& begin, const size_t& end)
+{
+    for (size_t i = begin; i < end; i++)
+        results[i] = vectors[i] * matrix;
+}
+
+static void TransformPointsScalar(const Mat4& matrix, const Vector3* points, Vector3* results, const size_t& begin, const size_t& end)
+{
+    for (size_t i = begin; i < end; i++)
+        results[i] = points[i] * matrix;
+}
+
+static void MultiplyMatricesScalar(const Mat4* matrices, const Mat4& matrix, Mat4* results, const size_t& begin, const size_t& end)
+{
+    for (size_t i = begin; i < end; i++)
+        results[i] = MatrixGeneric::Multiply(matrices[i], matrix);
+}
+
+#ifdef MATHS_X86
+
+// ---------- SSE ---------- //
+
+// Each result is the sum of the matrix's rows weighted by the coordinates, added in the same order as Vector4::operator*.
+#define MATHS_SPLAT(vec, lane) _mm_shuffle_ps(vec, vec, _MM_SHUFFLE(lane, lane, lane, lane))
+
+static void TransformVectorsSSE(const Mat4& matrix, const Vector4* vectors, Vector4* results, const size_t& begin, const size_t& end)
+{
+    const __m128 r0 = _mm_loadu_ps(matrix.m[0]), r1 = _mm_loadu_ps(matrix.m[1]), r2 = _mm_loadu_ps(matrix.m[2]), r3 = _mm_loadu_ps(matrix.m[3]);
+    for (size_t i = begin; i < end; i++)
+    {
+        const __m128 v = _mm_loadu_ps(&vectors[i].x);
+        __m128 result = _mm_mul_ps(MATHS_SPLAT(v, 0), r0);
+        result = _mm_add_ps(result, _mm_mul_ps(MATHS_SPLAT(v, 1), r1));
+        result = _mm_add_ps(result, _mm_mul_ps(MATHS_SPLAT(v, 2), r2));
+        result = _mm_add_ps(result, _mm_mul_ps(MATHS_SPLAT(v, 3), r3));
+        _mm_storeu_ps(&results[i].x, result);
+    }
+}
+
+static void TransformPointsSSE(const Mat4& matrix, const Vector3* points, Vector3* results, const size_t& begin, const size_t& end)
+{
+    const __m128 r0 = _mm_loadu_ps(matrix.m[0]), r1 = _mm_loadu_ps(matrix.m[1]), r2 = _mm_loadu_ps(matrix.m[2]), r3 = _mm_loadu_ps(matrix.m[3]);
+    for (size_t i = begin; i < end; i++)
+    {
+        // The points' w is 1, so the last row is added as is.
+        __m128 result = _mm_mul_ps(_mm_set1_ps(points[i].x), r0);
+        result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(points[i].y), r1));
+        result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(points[i].z), r2));
+        result = _mm_add_ps(result, r3);
+        result = _mm_div_ps(result, MATHS_SPLAT(result, 3));
+        _mm_storel_pi((__m64*)&results[i].x, result);
+        _mm_store_ss(&results[i].z, _mm_movehl_ps(result, result));
+    }
+}
+
+static void MultiplyMatricesSSE(const Mat4* matrices, const Mat4& matrix, Mat4* results, const size_t& begin, const size_t& end)
+{
+    const __m128 r0 = _mm_loadu_ps(matrix.m[0]), r1 = _mm_loadu_ps(matrix.m[1]), r2 = _mm_loadu_ps(matrix.m[2]), r3 = _mm_loadu_ps(matrix.m[3]);
+    for (size_t i = begin; i < end; i++)
+    {
+        for (int row = 0; row < 4; row++)
+        {
+            const __m128 a = _mm_loadu_ps(matrices[i].m[row]);
+            __m128 result = _mm_mul_ps(MATHS_SPLAT(a, 0), r0);
+            result = _mm_add_ps(result, _mm_mul_ps(MATHS_SPLAT(a, 1), r1));
+            result = _mm_add_ps(result, _mm_mul_ps(MATHS_SPLAT(a, 2), r2));
+            result = _mm_add_ps(result, _mm_mul_ps(MATHS_SPLAT(a, 3), r3));
+            _mm_storeu_ps(results[i].m[row], result);
+        }
+    }
+}
+
+
+// ---------- AVX2 ---------- //
+
+// Two vectors, points or matrix rows per register, with the matrix's rows repeated in both halves.
+MATHS_TARGET_AVX2 static __m256 LoadRowTwice(const float* row)
+{
+    const __m128 half = _mm_loadu_ps(row);
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(half), half, 1);
+}
+
+MATHS_TARGET_AVX2 static __m256 SplatTwice(const float& low, const float& high)
+{
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_set1_ps(low)), _mm_set1_ps(high), 1);
+}
+
+#define MATHS_SPLAT_256(vec, lane) _mm256_shuffle_ps(vec, vec, _MM_SHUFFLE(lane, lane, lane, lane))
+
+MATHS_TARGET_AVX2 static void TransformVectorsAVX2(const Mat4& matrix, const Vector4* vectors, Vector4* results, const size_t& begin, const size_t& end)
+{
+    const __m256 r0 = LoadRowTwice(matrix.m[0]), r1 = LoadRowTwice(matrix.m[1]), r2 = LoadRowTwice(matrix.m[2]), r3 = LoadRowTwice(matrix.m[3]);
+    const size_t simdEnd = end - (end - begin) % 2;
+    for (size_t i = begin; i < simdEnd; i += 2)
+    {
+        const __m256 v = _mm256_loadu_ps(&vectors[i].x);
+        __m256 result = _mm256_mul_ps(MATHS_SPLAT_256(v, 0), r0);
+        result = _mm256_add_ps(result, _mm256_mul_ps(MATHS_SPLAT_256(v, 1), r1));
+        result = _mm256_add_ps(result, _mm256_mul_ps(MATHS_SPLAT_256(v, 2), r2));
+        result = _mm256_add_ps(result, _mm256_mul_ps(MATHS_SPLAT_256(v, 3), r3));
+        _mm256_storeu_ps(&results[i].x, result);
+    }
+    TransformVectorsScalar(matrix, vectors, results, simdEnd, end);
+}
+
+MATHS_TARGET_AVX2 static void TransformPointsAVX2(const Mat4& matrix, const Vector3* points, Vector3* results, const size_t& begin, const size_t& end)
+{
+    const __m256 r0 = LoadRowTwice(matrix.m[0]), r1 = LoadRowTwice(matrix.m[1]), r2 = LoadRowTwice(matrix.m[2]), r3 = LoadRowTwice(matrix.m[3]);
+    const size_t simdEnd = end - (end - begin) % 2;
+    for (size_t i = begin; i < simdEnd; i += 2)
+    {
+        __m256 result = _mm256_mul_ps(SplatTwice(points[i].x, points[i + 1].x), r0);
+        result = _mm256_add_ps(result, _mm256_mul_ps(SplatTwice(points[i].y, points[i + 1].y), r1));
+        result = _mm256_add_ps(result, _mm256_mul_ps(SplatTwice(points[i].z, points[i + 1].z), r2));
+        result = _mm256_add_ps(result, r3);
+        result = _mm256_div_ps(result, MATHS_SPLAT_256(result, 3));
+
+        const __m128 low = _mm256_castps256_ps128(result), high = _mm256_extractf128_ps(result, 1);
+        _mm_storel_pi((__m64*)&results[i].x, low);
+        _mm_store_ss(&results[i].z, _mm_movehl_ps(low, low));
+        _mm_storel_pi((__m64*)&results[i + 1].x, high);
+        _mm_store_ss(&results[i + 1].z, _mm_movehl_ps(high, high));
+    }
+    TransformPointsScalar(matrix, points, results, simdEnd, end);
+}
+
+MATHS_TARGET_AVX2 static void MultiplyMatricesAVX2(const Mat4* matrices, const Mat4& matrix, Mat4* results, const size_t& begin, const size_t& end)
+{
+    const __m256 r0 = LoadRowTwice(matrix.m[0]), r1 = LoadRowTwice(matrix.m[1]), r2 = LoadRowTwice(matrix.m[2]), r3 = LoadRowTwice(matrix.m[3]);
+    for (size_t i = begin; i < end; i++)
+    {
+        for (int row = 0; row < 4; row += 2)
+        {
+            const __m256 a = _mm256_loadu_ps(matrices[i].m[row]);
+            __m256 result = _mm256_mul_ps(MATHS_SPLAT_256(a, 0), r0);
+            result = _mm256_add_ps(result, _mm256_mul_ps(MATHS_SPLAT_256(a, 1), r1));
+            result = _mm256_add_ps(result, _mm256_mul_ps(MATHS_SPLAT_256(a, 2), r2));
+            result = _mm256_add_ps(result, _mm256_mul_ps(MATHS_SPLAT_256(a, 3), r3));
+            _mm256_storeu_ps(results[i].m[row], result);
+        }
+    }
+}
+
+#else
+
+static void TransformVectorsSSE (const Mat4& matrix, const Vector4* vectors, Vector4* results, const size_t& begin, const size_t& end) { TransformVectorsScalar(matrix, vectors, results, begin, end); }
+static void TransformVectorsAVX2(const Mat4& matrix, const Vector4* vectors, Vector4* results, const size_t& begin, const size_t& end) { TransformVectorsScalar(matrix, vectors, results, begin, end); }
+static void TransformPointsSSE  (const Mat4& matrix, const Vector3* points,  Vector3* results, const size_t& begin, const size_t& end) { TransformPointsScalar (matrix, points,  results, begin, end); }
+static void TransformPointsAVX2 (const Mat4& matrix, const Vector3* points,  Vector3* results, const size_t& begin, const size_t& end) { TransformPointsScalar (matrix, points,  results, begin, end); }
+static void MultiplyMatricesSSE (const Mat4* matrices, const Mat4& matrix, Mat4* results, const size_t& begin, const size_t& end) { MultiplyMatricesScalar(matrices, matrix, results, begin, end); }
+static void MultiplyMatricesAVX2(const Mat4* matrices, const Mat4& matrix, Mat4* results, const size_t& begin, const size_t& end) { MultiplyMatricesScalar(matrices, matrix, results, begin, end); }
+
+#endif
+
+
+// ---------- DISPATCH ---------- //
+
+void Maths::TransformVectors(const Mat4& matrix, const Vector4* vectors, Vector4* results, const size_t& count, IntegratorBackend backend)
+{
+    if (!IsIntegratorBackendSupported(backend))
+        backend = GetBestIntegratorBackend();
+
+    switch (backend)
+    {
+    case IntegratorBackend::SSE:  TransformVectorsSSE (matrix, vectors, results, 0, count); break;
+    case IntegratorBackend::AVX2: TransformVectorsAVX2(matrix, vectors, results, 0, count); break;
+    default:                      TransformVectorsScalar(matrix, vectors, results, 0, count); break;
+    }
+}
+
+void Maths::TransformPoints(const Mat4& matrix, const Vector3* points, Vector3* results, const size_t& count, IntegratorBackend backend)
+{
+    if (!IsIntegratorBackendSupported(backend))
+        backend = GetBestIntegratorBackend();
+
+    switch (backend)
+    {
+    case IntegratorBackend::SSE:  TransformPointsSSE (matrix, points, results, 0, count); break;
+    case IntegratorBackend::AVX2: TransformPointsAVX2(matrix, points, results, 0, count); break;
+    default:                      TransformPointsScalar(matrix, points, results, 0, count); break;
+    }
+}
+
+void Maths::MultiplyMatrices(const Mat4* matrices, const Mat4& matrix, Mat4* results, const size_t& count, IntegratorBackend backend)
+{
+    if (!IsIntegratorBackendSupported(backend))
+        backend = GetBestIntegratorBackend();
+
+    switch (backend)
+    {
+    case IntegratorBackend::SSE:  MultiplyMatricesSSE (matrices, matrix, results, 0, count); break;
+    case IntegratorBackend::AVX2: MultiplyMatricesAVX2(matrices, matrix, results, 0, count); break;
+    default:                      MultiplyMatricesScalar(matrices, matrix, results, 0, count); break;
+    }
+}
@@ -0,0 +1,166 @@
+#include "Random.h"
+#include <chrono>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define MATHS_X86 1
+    #include <emmintrin.h>
+#endif
+
+using namespace Maths;
+
+
+// Scrambles a 64-bit state to seed the generators (splitmix64).
+static uint64_t SplitMix64(uint64_t& x)
+{
+    uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static uint32_t RotateLeft(const uint32_t& x, const int& k)
+{
+    return (x << k) | (x >> (32 - k));
+}
+
+// Steps a xoshiro128+ state and returns its output.
+static uint32_t Xoshiro128Plus(uint32_t& s0, uint32_t& s1, uint32_t& s2, uint32_t& s3)
+{
+    const uint32_t result = s0 + s3;
+    const uint32_t t = s1 << 9;
+    s2 ^= s0;
+    s3 ^= s1;
+    s1 ^= s2;
+    s0 ^= s3;
+    s2 ^= t;
+    s3 = RotateLeft(s3, 11);
+    return result;
+}
+
+// Converts the 24 high bits of a random number to a float in [0, 1). The low bits of xoshiro128+ are weaker.
+static float ToUnitFloat(const uint32_t& x)
+{
+    return (float)(x >> 8) * (1.f / 16777216.f);
+}
+
+Random::Random(const uint64_t& seed, const uint64_t& stream)
+{
+    Seed(seed, stream);
+}
+
+void Random::Seed(const uint64_t& seed, const uint64_t& stream)
+{
+    // Mix the stream into the seed, then fill every state word with splitmix64 as recommended for xoshiro.
+    uint64_t streamState = stream;
+    uint64_t x = seed ^ SplitMix64(streamState);
+    for (int i = 0; i < 4; i += 2)
+    {
+        const uint64_t value = SplitMix64(x);
+        state[i]     = (uint32_t)value;
+        state[i + 1] = (uint32_t)(value >> 32);
+    }
+    for (int lane = 0; lane < 4; lane++)
+    {
+        for (int word = 0; word < 4; word += 2)
+        {
+            const uint64_t value = SplitMix64(x);
+            lanes[word]    [lane] = (uint32_t)value;
+            lanes[word + 1][lane] = (uint32_t)(value >> 32);
+        }
+    }
+}
+
+uint32_t Random::NextU32()
+{
+    return Xoshiro128Plus(state[0], state[1], state[2], state[3]);
+}
+
+float Random::NextFloat()
+{
+    return ToUnitFloat(NextU32());
+}
+
+float Random::Range(const float& min, const float& max)
+{
+    return min + NextFloat() * (max - min);
+}
+
+int Random::RangeInt(const int& min, const int& max)
+{
+    // Scale with a multiplication instead of a modulo, which uses the high bits and has no division.
+    if (max <= min) return min;
+    return min + (int)(((uint64_t)NextU32() * (uint32_t)(max - min)) >> 32);
+}
+
+void Random::FillFloatsScalar(float* out, const size_t& count, const float& min, const float& max)
+{
+    const float range = max - min;
+    for (size_t i = 0; i < count; i += 4)
+    {
+        for (size_t lane = 0; lane < 4; lane++)
+        {
+            const float value = min + ToUnitFloat(Xoshiro128Plus(lanes[0][lane], lanes[1][lane], lanes[2][lane], lanes[3][lane])) * range;
+            if (i + lane < count)
+                out[i + lane] = value;
+        }
+    }
+}
+
+#ifdef MATHS_X86
+
+void Random::FillFloats(float* out, const size_t& count, const float& min, const float& max)
+{
+    __m128i s0 = _mm_load_si128((const __m128i*)lanes[0]);
+    __m128i s1 = _mm_load_si128((const __m128i*)lanes[1]);
+    __m128i s2 = _mm_load_si128((const __m128i*)lanes[2]);
+    __m128i s3 = _mm_load_si128((const __m128i*)lanes[3]);
+    const __m128 minimum = _mm_set1_ps(min);
+    const __m128 range   = _mm_set1_ps(max - min);
+    const __m128 scale   = _mm_set1_ps(1.f / 16777216.f);
+
+    for (size_t i = 0; i < count; i += 4)
+    {
+        // Same steps as Xoshiro128Plus, for the 4 generators at once.
+        const __m128i result = _mm_add_epi32(s0, s3);
+        const __m128i t      = _mm_slli_epi32(s1, 9);
+        s2 = _mm_xor_si128(s2, s0);
+        s3 = _mm_xor_si128(s3, s1);
+        s1 = _mm_xor_si128(s1, s2);
+        s0 = _mm_xor_si128(s0, s3);
+        s2 = _mm_xor_si128(s2, t);
+        s3 = _mm_or_si128(_mm_slli_epi32(s3, 11), _mm_srli_epi32(s3, 21));
+
+        const __m128 unit  = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(result, 8)), scale);
+        const __m128 value = _mm_add_ps(minimum, _mm_mul_ps(unit, range));
+        if (i + 4 <= count)
+            _mm_storeu_ps(out + i, value);
+        else
+        {
+            alignas(16) float last[4];
+            _mm_store_ps(last, value);
+            for (size_t lane = 0; i + lane < count; lane++)
+                out[i + lane] = last[lane];
+        }
+    }
+
+    _mm_store_si128((__m128i*)lanes[0], s0);
+    _mm_store_si128((__m128i*)lanes[1], s1);
+    _mm_store_si128((__m128i*)lanes[2], s2);
+    _mm_store_si128((__m128i*)lanes[3], s3);
+}
+
+#else
+
+void Random::FillFloats(float* out, const size_t& count, const float& min, const float& max)
+{
+    FillFloatsScalar(out, count, min, max);
+}
+
+#endif
+
+uint64_t Maths::MakeRandomSeed()
+{
+    int local = 0;
+    uint64_t x = (uint64_t)std::chrono::high_resolution_clock::now().time_since_epoch().count() ^ (uint64_t)(uintptr_t)&local;
+    return SplitMix64(x);
+}
@@ -0,0 +1,205 @@
+#include "Transform2DBatch.h"
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define MATHS_X86 1
+    #include <immintrin.h>
+    #ifdef _MSC_VER
+        #include <intrin.h>
+    #endif
+#endif
+
+// GCC and Clang need AVX2 enabled per function so that the rest of the program still runs on older CPUs.
+#if defined(MATHS_X86) && (defined(__GNUC__) || defined(__clang__))
+    #define MATHS_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+    #define MATHS_TARGET_AVX2
+#endif
+
+using namespace Maths;
+
+
+// ---------- BACKEND SELECTION ---------- //
+
+const char* Maths::GetIntegratorBackendName(const IntegratorBackend& backend)
+{
+    switch (backend)
+    {
+    case IntegratorBackend::SCALAR: return "Scalar";
+    case IntegratorBackend::SSE:    return "SSE";
+    case IntegratorBackend::AVX2:   return "AVX2";
+    default:                        return "Unknown";
+    }
+}
+
+bool Maths::IsIntegratorBackendSupported(const IntegratorBackend& backend)
+{
+    switch (backend)
+    {
+    case IntegratorBackend::SCALAR:
+        return true;
+#ifdef MATHS_X86
+    case IntegratorBackend::SSE:
+        return true; // SSE2 is part of every x86-64 CPU and of every x86 CPU this program targets.
+    case IntegratorBackend::AVX2:
+    {
+    #ifdef _MSC_VER
+        // AVX2 support is bit 5 of EBX for leaf 7, and the OS must save the YMM registers (XCR0 bits 1 and 2).
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) return false;
+        __cpuid(info, 1);
+        if (!(info[2] & (1 << 27))) return false; // OSXSAVE.
+        if ((_xgetbv(0) & 6) != 6)  return false;
+        __cpuidex(info, 7, 0);
+        return info[1] & (1 << 5);
+    #else
+        return __builtin_cpu_supports("avx2");
+    #endif
+    }
+#endif
+    default:
+        return false;
+    }
+}
+
+IntegratorBackend Maths::GetBestIntegratorBackend()
+{
+    static const IntegratorBackend best = IsIntegratorBackendSupported(IntegratorBackend::AVX2) ? IntegratorBackend::AVX2
+                                        : IsIntegratorBackendSupported(IntegratorBackend::SSE)  ? IntegratorBackend::SSE
+                                        :                                                         IntegratorBackend::SCALAR;
+    return best;
+}
+
+
+// ---------- STORAGE ---------- //
+
+size_t Transform2DBatch::Add(const Transform2D& transform)
+{
+    posX.push_back(transform.position.x);     posY.push_back(transform.position.y);
+    velX.push_back(transform.velocity.x);     velY.push_back(transform.velocity.y);
+    accX.push_back(transform.acceleration.x); accY.push_back(transform.acceleration.y);
+    rotation       .push_back(transform.rotation);
+    angularVelocity.push_back(transform.angularVelocity);
+    rotateForwards .push_back(transform.rotateForwards);
+    return Size() - 1;
+}
+
+void Transform2DBatch::Clear()
+{
+    for (std::vector<float>* array : { &posX, &posY, &velX, &velY, &accX, &accY, &rotation, &angularVelocity })
+        array->clear();
+    rotateForwards.clear();
+}
+
+void Transform2DBatch::Reserve(const size_t& capacity)
+{
+    for (std::vector<float>* array : { &posX, &posY, &velX, &velY, &accX, &accY, &rotation, &angularVelocity })
+        array->reserve(capacity);
+    rotateForwards.reserve(capacity);
+}
+
+void Transform2DBatch::RemoveSwap(const size_t& i)
+{
+    for (std::vector<float>* array : { &posX, &posY, &velX, &velY, &accX, &accY, &rotation, &angularVelocity }) {
+        (*array)[i] = array->back();
+        array->pop_back();
+    }
+    rotateForwards[i] = rotateForwards.back();
+    rotateForwards.pop_back();
+}
+
+float Transform2DBatch::GetRotation(const size_t& i) const
+{
+    return rotateForwards[i] ? atan2f(velY[i], velX[i]) : rotation[i];
+}
+
+Transform2D Transform2DBatch::Get(const size_t& i) const
+{
+    Transform2D transform;
+    transform.position        = GetPosition(i);
+    transform.velocity        = GetVelocity(i);
+    transform.acceleration    = { accX[i], accY[i] };
+    transform.rotation        = GetRotation(i);
+    transform.angularVelocity = angularVelocity[i];
+    transform.rotateForwards  = rotateForwards[i];
+    return transform;
+}
+
+
+// ---------- INTEGRATION ---------- //
+
+void Transform2DBatch::Update(const float& deltaTime, IntegratorBackend backend)
+{
+    Update(deltaTime, backend, 0, Size());
+}
+
+void Transform2DBatch::Update(const float& deltaTime, IntegratorBackend backend, const size_t& begin, const size_t& end)
+{
+    if (!IsIntegratorBackendSupported(backend))
+        backend = GetBestIntegratorBackend();
+
+    switch (backend)
+    {
+    case IntegratorBackend::SSE:  UpdateSSE (deltaTime, begin, end); break;
+    case IntegratorBackend::AVX2: UpdateAVX2(deltaTime, begin, end); break;
+    default:                      UpdateScalar(deltaTime, begin, end); break;
+    }
+}
+
+// The rotation of transforms that rotate forwards is also incremented, but it is never read.
+// All backends do the same operations in the same order so that they give the same results.
+void Transform2DBatch::UpdateScalar(const float& deltaTime, const size_t& begin, const size_t& end)
+{
+    for (size_t i = begin; i < end; i++)
+    {
+        velX[i]     += accX[i] * deltaTime;
+        velY[i]     += accY[i] * deltaTime;
+        posX[i]     += velX[i] * deltaTime;
+        posY[i]     += velY[i] * deltaTime;
+        rotation[i] += angularVelocity[i] * deltaTime;
+    }
+}
+
+#ifdef MATHS_X86
+
+void Transform2DBatch::UpdateSSE(const float& deltaTime, const size_t& begin, const size_t& end)
+{
+    const size_t simdEnd = end - (end - begin) % 4;
+    const __m128 dt = _mm_set1_ps(deltaTime);
+    for (size_t i = begin; i < simdEnd; i += 4)
+    {
+        const __m128 vx = _mm_add_ps(_mm_loadu_ps(&velX[i]), _mm_mul_ps(_mm_loadu_ps(&accX[i]), dt));
+        const __m128 vy = _mm_add_ps(_mm_loadu_ps(&velY[i]), _mm_mul_ps(_mm_loadu_ps(&accY[i]), dt));
+        _mm_storeu_ps(&velX[i], vx);
+        _mm_storeu_ps(&velY[i], vy);
+        _mm_storeu_ps(&posX[i],     _mm_add_ps(_mm_loadu_ps(&posX[i]),     _mm_mul_ps(vx, dt)));
+        _mm_storeu_ps(&posY[i],     _mm_add_ps(_mm_loadu_ps(&posY[i]),     _mm_mul_ps(vy, dt)));
+        _mm_storeu_ps(&rotation[i], _mm_add_ps(_mm_loadu_ps(&rotation[i]), _mm_mul_ps(_mm_loadu_ps(&angularVelocity[i]), dt)));
+    }
+    UpdateScalar(deltaTime, simdEnd, end);
+}
+
+MATHS_TARGET_AVX2 void Transform2DBatch::UpdateAVX2(const float& deltaTime, const size_t& begin, const size_t& end)
+{
+    const size_t simdEnd = end - (end - begin) % 8;
+    const __m256 dt = _mm256_set1_ps(deltaTime);
+    for (size_t i = begin; i < simdEnd; i += 8)
+    {
+        const __m256 vx = _mm256_add_ps(_mm256_loadu_ps(&velX[i]), _mm256_mul_ps(_mm256_loadu_ps(&accX[i]), dt));
+        const __m256 vy = _mm256_add_ps(_mm256_loadu_ps(&velY[i]), _mm256_mul_ps(_mm256_loadu_ps(&accY[i]), dt));
+        _mm256_storeu_ps(&velX[i], vx);
+        _mm256_storeu_ps(&velY[i], vy);
+        _mm256_storeu_ps(&posX[i],     _mm256_add_ps(_mm256_loadu_ps(&posX[i]),     _mm256_mul_ps(vx, dt)));
+        _mm256_storeu_ps(&posY[i],     _mm256_add_ps(_mm256_loadu_ps(&posY[i]),     _mm256_mul_ps(vy, dt)));
+        _mm256_storeu_ps(&rotation[i], _mm256_add_ps(_mm256_loadu_ps(&rotation[i]), _mm256_mul_ps(_mm256_loadu_ps(&angularVelocity[i]), dt)));
+    }
+    UpdateScalar(deltaTime, simdEnd, end);
+}
+
+#else
+
+void Transform2DBatch::UpdateSSE (const float& deltaTime, const size_t& begin, const size_t& end) { UpdateScalar(deltaTime, begin, end); }
+void Transform2DBatch::UpdateAVX2(const float& deltaTime, const size_t& begin, const size_t& end) { UpdateScalar(deltaTime, begin, end); }
+
+#endif
@@ -0,0 +1,55 @@
+#include "NumberLabel.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+
+bool NumberLabel::Set(const float& value, const int& _precision, const char* _unit)
+{
+    static constexpr int64_t POWERS_OF_TEN[] = { 1, 10, 100, 1000, 10000, 100000, 1000000 };
+    const int     decimals = std::clamp(_precision, 0, 6);
+    const double  scaled   = (double)value * POWERS_OF_TEN[decimals];
+    const int64_t shown    = std::isfinite(scaled) && std::abs(scaled) < 1e15 ? (int64_t)std::nearbyint(scaled) : 0; // Ties to even, like printf.
+    if (shown == shownValue && decimals == precision && _unit == unit)
+        return false;
+    shownValue = shown;
+    precision  = decimals;
+    unit       = _unit;
+
+    // Write the integer part and the decimals from the rounded value, so that the text only depends on it.
+    char* const    last      = text + LABEL_CAPACITY - 1;
+    const uint64_t magnitude = shown < 0 ? (uint64_t)-shown : (uint64_t)shown;
+    char* cursor = text;
+    if (shown < 0)
+        *cursor++ = '-';
+    cursor = std::to_chars(cursor, last, magnitude / POWERS_OF_TEN[decimals]).ptr;
+    if (decimals > 0 && last - cursor > decimals)
+    {
+        *cursor++ = '.';
+        const uint64_t fraction = magnitude % POWERS_OF_TEN[decimals];
+        char digits[8];
+        const char* digitsEnd = std::to_chars(digits, digits + sizeof(digits), fraction).ptr;
+        const int   padding   = decimals - (int)(digitsEnd - digits);
+        std::memset(cursor, '0', padding);
+        std::memcpy(cursor + padding, digits, digitsEnd - digits);
+        cursor += decimals;
+    }
+    const size_t unitLength = std::min(unit ? std::strlen(unit) : 0, (size_t)(last - cursor));
+    if (unitLength > 0)
+        std::memcpy(cursor, unit, unitLength);
+    cursor[unitLength] = '\0';
+
+    widthFontSize = -1;
+    return true;
+}
+
+int NumberLabel::GetWidth(const Canvas& canvas, const int& fontSize)
+{
+    if (widthFontSize != fontSize)
+    {
+        width         = canvas.MeasureText(text, fontSize);
+        widthFontSize = fontSize;
+    }
+    return width;
+}
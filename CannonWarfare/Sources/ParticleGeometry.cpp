@@ -0,0 +1,109 @@
+#include "ParticleGeometry.h"
+#include "MathConstants.h"
+#include <cmath>
+using namespace Maths;
+
+
+// Cosines and sines of the corners of a shape with the given number of sides, starting at angle 0.
+template<int Sides>
+static const std::array<Maths::Vector2, Sides>& GetUnitCorners()
+{
+    static const std::array<Maths::Vector2, Sides> corners = []()
+    {
+        std::array<Maths::Vector2, Sides> result;
+        for (int i = 0; i < Sides; i++)
+            result[i] = { cosf(2 * PI * i / Sides), sinf(2 * PI * i / Sides) };
+        return result;
+    }();
+    return corners;
+}
+
+// Writes the 2 triangles of a quad going from the side a0-a1 to the side b0-b1.
+static void WriteQuad(ParticleVertex*& out, const Maths::Vector2& a0, const Maths::Vector2& a1, const Maths::Vector2& b0, const Maths::Vector2& b1, const ParticleInstance& particle)
+{
+    for (const Maths::Vector2* point : { &a0, &a1, &b0, &b0, &a1, &b1 })
+        *out++ = { point->x, point->y, particle.r, particle.g, particle.b, particle.a };
+}
+
+// Writes the outline of a regular shape as one quad per side, between the radius minus and plus half the line thickness.
+template<int Sides>
+static void WriteRing(ParticleVertex*& out, const ParticleInstance& particle, const float& rotation)
+{
+    const std::array<Maths::Vector2, Sides>& corners = GetUnitCorners<Sides>();
+    const float cosRotation = cosf(rotation), sinRotation = sinf(rotation);
+    const float inner = particle.size - PARTICLE_LINE_THICKNESS / 2;
+    const float outer = particle.size + PARTICLE_LINE_THICKNESS / 2;
+
+    const auto corner = [&](const int& i)
+    {
+        const Maths::Vector2& c = corners[i % Sides];
+        return Maths::Vector2(c.x * cosRotation - c.y * sinRotation, c.x * sinRotation + c.y * cosRotation);
+    };
+    Maths::Vector2 previous = corner(0);
+    for (int i = 1; i <= Sides; i++)
+    {
+        const Maths::Vector2 next = corner(i);
+        WriteQuad(out, particle.position + previous * outer, particle.position + previous * inner,
+                       particle.position + next     * outer, particle.position + next     * inner, particle);
+        previous = next;
+    }
+}
+
+// Writes a line centered on the particle along its velocity.
+static void WriteLine(ParticleVertex*& out, const ParticleInstance& particle)
+{
+    const float speed = sqrtf(particle.velocity.x * particle.velocity.x + particle.velocity.y * particle.velocity.y);
+    const Maths::Vector2 direction = speed > 0 ? particle.velocity * (1 / speed) : Maths::Vector2(1, 0);
+    const Maths::Vector2 halfLength = direction * (particle.size / 2);
+    const Maths::Vector2 halfWidth  = Maths::Vector2(-direction.y, direction.x) * (PARTICLE_LINE_THICKNESS / 2);
+    WriteQuad(out, particle.position + halfLength + halfWidth, particle.position + halfLength - halfWidth,
+                   particle.position - halfLength + halfWidth, particle.position - halfLength - halfWidth, particle);
+}
+
+void ParticleGeometry::Build(const std::vector<ParticleInstance>& particles, Physics::JobSystem& jobs)
+{
+    // Count the particles of each shape in each chunk.
+    const size_t chunkCount = Physics::JobSystem::GetChunkCount(particles.size(), CHUNK_SIZE);
+    chunkOffsets.resize(chunkCount);
+    jobs.ParallelFor(particles.size(), CHUNK_SIZE, [&](const size_t& chunk, const size_t& begin, const size_t& end)
+    {
+        chunkOffsets[chunk] = {};
+        for (size_t i = begin; i < end; i++)
+            chunkOffsets[chunk][(int)particles[i].shape]++;
+    });
+
+    // Place the groups one after the other, and the chunks one after the other inside each group.
+    size_t vertexCount = 0;
+    for (size_t shape = 0; shape < PARTICLE_SHAPE_COUNT; shape++)
+    {
+        const size_t shapeVertexCount = GetParticleVertexCount((ParticleShapes)shape);
+        groupBegin[shape] = vertexCount;
+        for (std::array<size_t, PARTICLE_SHAPE_COUNT>& offsets : chunkOffsets)
+        {
+            const size_t particleCount = offsets[shape];
+            offsets[shape] = vertexCount;
+            vertexCount   += particleCount * shapeVertexCount;
+        }
+        groupSize[shape] = vertexCount - groupBegin[shape];
+    }
+    vertices.resize(vertexCount);
+
+    // Write the vertices of each particle where its chunk's part of its group is.
+    jobs.ParallelFor(particles.size(), CHUNK_SIZE, [&](const size_t& chunk, const size_t& begin, const size_t& end)
+    {
+        std::array<ParticleVertex*, PARTICLE_SHAPE_COUNT> out;
+        for (size_t shape = 0; shape < PARTICLE_SHAPE_COUNT; shape++)
+            out[shape] = vertices.data() + chunkOffsets[chunk][shape];
+
+        for (size_t i = begin; i < end; i++)
+        {
+            const ParticleInstance& particle = particles[i];
+            switch (particle.shape)
+            {
+            case ParticleShapes::LINE:    WriteLine(out[(int)ParticleShapes::LINE], particle); break;
+            case ParticleShapes::CIRCLE:  WriteRing<PARTICLE_CIRCLE_SIDES> (out[(int)ParticleShapes::CIRCLE],  particle, 0); break;
+            case ParticleShapes::POLYGON: WriteRing<PARTICLE_POLYGON_SIDES>(out[(int)ParticleShapes::POLYGON], particle, particle.rotation); break;
+            }
+        }
+    });
+}
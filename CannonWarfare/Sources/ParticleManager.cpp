@@ -1,54 +1,161 @@
 #include "ParticleManager.h"
-#include "RaylibConversions.h"
+#include "Arithmetic.h"
+#include "Profiler.h"
+#include <algorithm>
 using namespace Maths;
 
-ParticleManager::~ParticleManager()
+ParticleManager::ParticleManager(const uint64_t& _seed)
 {
-    for (const Particle* particle : particles)
-        delete particle;
+    Seed(_seed);
+    particleSpawners.reserve(MAX_PARTICLE_SPAWNERS);
+    transforms.Reserve(MAX_PARTICLES);
+    prevX     .reserve(MAX_PARTICLES);
+    prevY     .reserve(MAX_PARTICLES);
+    shapes    .reserve(MAX_PARTICLES);
+    sizes     .reserve(MAX_PARTICLES);
+    frictions .reserve(MAX_PARTICLES);
+    colors    .reserve(MAX_PARTICLES);
+    drawList  .reserve(MAX_PARTICLES);
+    drawGeometry.Reserve(MAX_PARTICLES * GetParticleVertexCount(ParticleShapes::POLYGON));
 }
 
-void ParticleManager::Update(const float& deltaTime)
+void ParticleManager::Seed(const uint64_t& _seed)
 {
-    // Update particle spawners.
-    for(size_t i = 0; i < particleSpawners.size(); i++)
+    seed          = _seed;
+    spawnerStream = 0;
+    rng.Seed(seed, spawnerStream);
+}
+
+void ParticleManager::Update(const float& deltaTime, Physics::JobSystem& jobs)
+{
+    PROFILE_ZONE("ParticleManager::Update");
+    // Update particle spawners, each chunk keeping the particles it spawns in its own list.
+    const size_t spawnerChunkCount = Physics::JobSystem::GetChunkCount(particleSpawners.size(), SPAWNER_CHUNK_SIZE);
+    if (spawnedParticles.size() < spawnerChunkCount)
+        spawnedParticles.resize(spawnerChunkCount);
+    jobs.ParallelFor(particleSpawners.size(), SPAWNER_CHUNK_SIZE, [&](const size_t& chunk, const size_t& begin, const size_t& end)
+    {
+        spawnedParticles[chunk].clear();
+        for (size_t i = begin; i < end; i++)
+            particleSpawners[i].Update(spawnedParticles[chunk], deltaTime);
+    });
+
+    // Add the spawned particles in the spawners' order.
+    for (size_t chunk = 0; chunk < spawnerChunkCount; chunk++)
+        for (const Particle& particle : spawnedParticles[chunk])
+            AddParticle(particle);
+
+    // Replace any outdated spawner with the last one, which is checked next.
+    for (size_t i = 0; i < particleSpawners.size();)
     {
-        particleSpawners[i]->Update(deltaTime);
+        if (particleSpawners[i].IsOutdated())
+        {
+            particleSpawners[i] = particleSpawners.back();
+            particleSpawners.pop_back();
+        }
+        else i++;
+    }
 
-        // Erase any outdated spawner.
-        if(particleSpawners[i]->IsOutdated())
+    // Slow the particles down, move them and shrink them.
+    jobs.ParallelFor(transforms.Size(), PARTICLE_CHUNK_SIZE, [&](const size_t&, const size_t& begin, const size_t& end)
+    {
+        for (size_t i = begin; i < end; i++)
         {
-            particleSpawners.erase(particleSpawners.begin() + i);
-            i--;
+            transforms.accX[i] -= transforms.velX[i] * frictions[i] * deltaTime;
+            transforms.accY[i] -= transforms.velY[i] * frictions[i] * deltaTime;
         }
+        std::copy(transforms.posX.begin() + begin, transforms.posX.begin() + end, prevX.begin() + begin);
+        std::copy(transforms.posY.begin() + begin, transforms.posY.begin() + end, prevY.begin() + begin);
+        transforms.Update(deltaTime, integratorBackend, begin, end);
+        for (size_t i = begin; i < end; i++)
+            sizes[i] -= 100 * deltaTime;
+    });
+
+    // Remove outdated particles, the last particle takes their place and is checked next.
+    for (size_t i = 0; i < transforms.Size();)
+    {
+        if (sizes[i] <= 0)
+            RemoveParticle(i);
+        else i++;
     }
+}
 
-    // Update particles.
-    for (size_t i = 0; i < particles.size(); i++)
+void ParticleManager::BuildDrawList(const float& alpha, Physics::JobSystem& jobs)
+{
+    PROFILE_ZONE("ParticleManager::BuildDrawList");
+    drawList.resize(transforms.Size());
+    jobs.ParallelFor(transforms.Size(), PARTICLE_CHUNK_SIZE, [&](const size_t&, const size_t& begin, const size_t& end)
     {
-        particles[i]->Update(deltaTime);
+        for (size_t i = begin; i < end; i++)
+        {
+            const CanvasColor& color = colors[i];
+            drawList[i] = {
+                shapes[i],
+                { lerp(prevX[i], transforms.posX[i], alpha), lerp(prevY[i], transforms.posY[i], alpha) },
+                transforms.GetVelocity(i),
+                shapes[i] == ParticleShapes::POLYGON ? transforms.GetRotation(i) : 0,
+                sizes[i],
+                color.r, color.g, color.b, color.a,
+            };
+        }
+    });
+    drawGeometry.Build(drawList, jobs);
+}
+
+void ParticleManager::CreateSpawner(const int& spawnRate, const float& spawnDuration, const SpawnerParticleParams& params)
+{
+    if (particleSpawners.size() >= MAX_PARTICLE_SPAWNERS)
+        return;
+    particleSpawners.emplace_back(spawnRate, spawnDuration, params, seed, ++spawnerStream);
+    spawnerHighWater = std::max(spawnerHighWater, particleSpawners.size());
+}
 
-        // Erase any outdated particle
-        if (particles[i]->IsOutdated())
+void ParticleManager::SpawnParticles(const int& count, const SpawnerParticleParams& params)
+{
+    spawnScratch.clear();
+    CreateRandomParticles(params, count, rng, spawnScratch);
+    for (size_t i = 0; i < spawnScratch.size(); i++)
+    {
+        if (!AddParticle(spawnScratch[i]))
         {
-            particles.erase(particles.begin() + i);
-            i--;
+            droppedParticles += spawnScratch.size() - i - 1;
+            return;
         }
     }
 }
 
-void ParticleManager::Draw() const
+bool ParticleManager::AddParticle(const Particle& particle)
 {
-    for (const Particle* particle : particles)
-        particle->Draw();
+    if (transforms.Size() >= MAX_PARTICLES)
+    {
+        droppedParticles++;
+        return false;
+    }
+    transforms.Add(particle.transform);
+    prevX     .push_back(particle.transform.position.x);
+    prevY     .push_back(particle.transform.position.y);
+    shapes    .push_back(particle.shape);
+    sizes     .push_back(particle.size);
+    frictions .push_back(particle.friction);
+    colors    .push_back(particle.color);
+    particleHighWater = std::max(particleHighWater, transforms.Size());
+    return true;
 }
 
-void ParticleManager::CreateSpawner(const int& spawnRate, const float& spawnDuration, const SpawnerParticleParams& params, const Transform2D* parentTransform)
+void ParticleManager::RemoveParticle(const size_t& i)
 {
-    particleSpawners.push_back(new ParticleSpawner(*this, spawnRate, spawnDuration, params, parentTransform));
+    transforms.RemoveSwap(i);
+    prevX    [i] = prevX    .back(); prevX    .pop_back();
+    prevY    [i] = prevY    .back(); prevY    .pop_back();
+    shapes   [i] = shapes   .back(); shapes   .pop_back();
+    sizes    [i] = sizes    .back(); sizes    .pop_back();
+    frictions[i] = frictions.back(); frictions.pop_back();
+    colors   [i] = colors   .back(); colors   .pop_back();
 }
 
-void ParticleManager::AddParticle(Particle* particle)
+Particle ParticleManager::GetParticle(const size_t& i, const float& alpha) const
 {
-    particles.push_back(particle);
+    Transform2D transform = transforms.Get(i);
+    transform.position = { lerp(prevX[i], transform.position.x, alpha), lerp(prevY[i], transform.position.y, alpha) };
+    return Particle(shapes[i], transform, sizes[i], frictions[i], colors[i]);
 }
@@ -0,0 +1,97 @@
+#include "ParticleRenderer.h"
+#include "raylib.h"
+#include "rlgl.h"
+#include "Profiler.h"
+#include <cstddef>
+
+// Same as the modelview-projection matrix raylib sends to its default shader.
+static Matrix MultiplyMatrices(const Matrix& left, const Matrix& right)
+{
+    const float l[16] = { left .m0, left .m1, left .m2, left .m3, left .m4, left .m5, left .m6, left .m7, left .m8, left .m9, left .m10, left .m11, left .m12, left .m13, left .m14, left .m15 };
+    const float r[16] = { right.m0, right.m1, right.m2, right.m3, right.m4, right.m5, right.m6, right.m7, right.m8, right.m9, right.m10, right.m11, right.m12, right.m13, right.m14, right.m15 };
+    float m[16];
+    for (int i = 0; i < 4; i++)
+        for (int j = 0; j < 4; j++)
+            m[i*4 + j] = l[i*4 + 0] * r[0*4 + j] + l[i*4 + 1] * r[1*4 + j] + l[i*4 + 2] * r[2*4 + j] + l[i*4 + 3] * r[3*4 + j];
+    return { m[0], m[4], m[8], m[12], m[1], m[5], m[9], m[13], m[2], m[6], m[10], m[14], m[3], m[7], m[11], m[15] };
+}
+
+void ParticleRenderer::Unload()
+{
+    if (vertexArray)  rlUnloadVertexArray (vertexArray);
+    if (vertexBuffer) rlUnloadVertexBuffer(vertexBuffer);
+    vertexArray = vertexBuffer = 0;
+    bufferCapacity = 0;
+}
+
+void ParticleRenderer::Draw(const ParticleGeometry& geometry)
+{
+    PROFILE_ZONE("ParticleRenderer::Draw");
+    lastDrawCalls = 0;
+    const size_t vertexCount = geometry.GetVertexCount();
+    if (vertexCount == 0)
+        return;
+
+    // Draw what raylib has batched until now so that the particles are drawn over it.
+    rlDrawRenderBatchActive();
+
+    // Grow the vertex buffer if the geometry doesn't fit, then upload the vertices.
+    if (vertexCount > bufferCapacity)
+    {
+        Unload();
+        bufferCapacity = vertexCount + vertexCount / 2;
+        vertexArray    = rlLoadVertexArray();
+        rlEnableVertexArray(vertexArray);
+        vertexBuffer   = rlLoadVertexBuffer(nullptr, (int)(bufferCapacity * sizeof(ParticleVertex)), true);
+        rlDisableVertexArray();
+    }
+    if (!vertexBuffer) {
+        DrawImmediate(geometry);
+        return;
+    }
+    rlUpdateVertexBuffer(vertexBuffer, geometry.GetVertices().data(), (int)(vertexCount * sizeof(ParticleVertex)), 0);
+
+    // Set the default shader up like raylib does for its batches, with its white texture.
+    const int* locs = rlGetShaderLocsDefault();
+    const float white[4] = { 1, 1, 1, 1 };
+    const int   textureSlot = 0;
+    rlEnableShader(rlGetShaderIdDefault());
+    rlSetUniformMatrix(locs[RL_SHADER_LOC_MATRIX_MVP], MultiplyMatrices(rlGetMatrixModelview(), rlGetMatrixProjection()));
+    rlSetUniform(locs[RL_SHADER_LOC_COLOR_DIFFUSE], white, RL_SHADER_UNIFORM_VEC4, 1);
+    rlSetUniform(locs[RL_SHADER_LOC_MAP_DIFFUSE], &textureSlot, RL_SHADER_UNIFORM_SAMPLER2D, 1);
+    rlActiveTextureSlot(0);
+    rlEnableTexture(rlGetTextureIdDefault());
+
+    // Bind the positions and colors, the texture coordinates aren't used.
+    rlEnableVertexArray(vertexArray);
+    rlEnableVertexBuffer(vertexBuffer);
+    rlSetVertexAttribute(locs[RL_SHADER_LOC_VERTEX_POSITION], 2, RL_FLOAT,         false, sizeof(ParticleVertex), (void*)offsetof(ParticleVertex, x));
+    rlSetVertexAttribute(locs[RL_SHADER_LOC_VERTEX_COLOR],    4, RL_UNSIGNED_BYTE, true,  sizeof(ParticleVertex), (void*)offsetof(ParticleVertex, r));
+    rlEnableVertexAttribute (locs[RL_SHADER_LOC_VERTEX_POSITION]);
+    rlEnableVertexAttribute (locs[RL_SHADER_LOC_VERTEX_COLOR]);
+    rlDisableVertexAttribute(locs[RL_SHADER_LOC_VERTEX_TEXCOORD01]);
+
+    rlDrawVertexArray(0, (int)vertexCount);
+    lastDrawCalls = 1;
+
+    rlDisableVertexArray();
+    rlDisableVertexBuffer();
+    rlDisableTexture();
+    rlDisableShader();
+}
+
+void ParticleRenderer::DrawImmediate(const ParticleGeometry& geometry)
+{
+    const std::vector<ParticleVertex>& vertices = geometry.GetVertices();
+    rlBegin(RL_TRIANGLES);
+    for (size_t i = 0; i < vertices.size(); i++)
+    {
+        // Raylib draws its batch when it is full, which must happen between triangles.
+        if (i % 3 == 0 && rlCheckRenderBatchLimit(3))
+            lastDrawCalls++;
+        rlColor4ub(vertices[i].r, vertices[i].g, vertices[i].b, vertices[i].a);
+        rlVertex2f(vertices[i].x, vertices[i].y);
+    }
+    rlEnd();
+    lastDrawCalls++;
+}
@@ -1,51 +1,44 @@
 ﻿#include "ParticleSpawner.h"
 #include "Arithmetic.h"
-#include "ParticleManager.h"
-#include <iostream>
+#include "MathConstants.h"
+#include <algorithm>
 using namespace Maths;
 
-static float RandFloatInBounds(const float& min, const float& max)
+void CreateRandomParticles(const SpawnerParticleParams& params, const int& count, Maths::Random& rng, std::vector<Particle>& out)
 {
-    if (max - min <= 0.001f) return min;
-    return (float)(rand() % (int)clampAbove(max * 100 - min * 100, 1.f) + (int)(min * 100)) / 100.f;
+    constexpr int BLOCK_SIZE = 64;
+    float angles[BLOCK_SIZE], velocities[BLOCK_SIZE], rotations[BLOCK_SIZE], angularVs[BLOCK_SIZE], sizes[BLOCK_SIZE], frictions[BLOCK_SIZE];
+
+    for (int begin = 0; begin < count; begin += BLOCK_SIZE)
+    {
+        // Generate each property of the block at once.
+        const size_t blockCount = (size_t)std::min(BLOCK_SIZE, count - begin);
+        rng.FillFloats(angles,     blockCount, params.minDirection, params.maxDirection);
+        rng.FillFloats(velocities, blockCount, params.minVelocity,  params.maxVelocity);
+        rng.FillFloats(rotations,  blockCount, 0, 2 * PI);
+        rng.FillFloats(angularVs,  blockCount, params.minAngularV,  params.maxAngularV);
+        rng.FillFloats(sizes,      blockCount, params.minSize,      params.maxSize);
+        rng.FillFloats(frictions,  blockCount, params.minFriction,  params.maxFriction);
+
+        for (size_t i = 0; i < blockCount; i++)
+        {
+            const Maths::Vector2 velocity  = { angles[i], velocities[i], true };
+            const Transform2D    transform = { params.position, velocity, {}, rotations[i], angularVs[i] };
+            out.emplace_back(params.shape, transform, sizes[i], frictions[i], params.color);
+        }
+    }
 }
 
-ParticleSpawner::ParticleSpawner(ParticleManager& _particleManager, const int& _spawnRate, const float& _spawnDuration, const SpawnerParticleParams& _params, const Transform2D* _parentTransform)
-    : particleManager(_particleManager), spawnRate(_spawnRate), spawnDuration(_spawnDuration), params(_params), parentTransform(_parentTransform)
+ParticleSpawner::ParticleSpawner(const int& _spawnRate, const float& _spawnDuration, const SpawnerParticleParams& _params, const uint64_t& _seed, const uint64_t& _stream)
+    : spawnRate(_spawnRate), spawnDuration(_spawnDuration), rng(_seed, _stream), params(_params)
 {
 }
 
-void ParticleSpawner::Update(const float& deltaTime)
+void ParticleSpawner::Update(std::vector<Particle>& spawned, const float& deltaTime)
 {
     if(!IsOutdated())
     {
-        for (int i = 0; i < spawnRate; i++)
-        {
-            float minDir = params.minDirection;
-            float maxDir = params.maxDirection;
-
-            if (parentTransform)
-            {
-                minDir += parentTransform->rotation;
-                maxDir += parentTransform->rotation;
-            }
-            
-            const float          randAngle     = RandFloatInBounds(minDir, maxDir);
-            const Maths::Vector2 randVelocity  = { randAngle, RandFloatInBounds(params.minVelocity, params.maxVelocity), true };
-            const float          randRotation  = degToRad(rand() % 360);
-            const float          randAngularV  = RandFloatInBounds(params.minAngularV, params.maxAngularV);
-            const float          randSize      = RandFloatInBounds(params.minSize,     params.maxSize);
-            const float          randFriction  = RandFloatInBounds(params.minFriction, params.maxFriction);
-                  Transform2D    randTransform = { params.position, randVelocity, {}, randRotation, randAngularV };
-
-            if (parentTransform)
-            {
-                randTransform.position = parentTransform->position;
-            }
-        
-            particleManager.AddParticle(new Particle(params.shape, randTransform, randSize, randFriction, params.color));
-        }
-        
+        CreateRandomParticles(params, spawnRate, rng, spawned);
         spawnDuration -= deltaTime;
     }
 }
@@ -0,0 +1,121 @@
+#include "Physics/Ballistics.h"
+#include "Maths/Maths.h"
+#include "Maths/Transform2D.h"
+#include <cmath>
+using namespace Maths;
+
+
+float Physics::ComputeMuzzleVelocity(const CannonProperties& properties)
+{
+    // See this link for more info: https://www.arc.id.au/CannonBallistics.html
+    const float d = properties.projectileRadius * 2; // Barrel diameter (px)
+    const float m = properties.projectileMass; // (kg)
+    const float p = properties.powderCharge; // (kg)
+    const float L = properties.barrelLength; // (px)
+    const float eta = 881    / PIXEL_SCALE;  // Density of powder (kg/m^3 -> kg/px^3)
+    const float atm = 1.225f / PIXEL_SCALE;  // Atmospheric pressure (kg/m^3 -> kg/px^3)
+    const float R   = 1600;                  // Gunpowder gas pressure to atm ratio
+    const float c   = p*4/(PI*sqpow(d)*eta); // Length of charge
+
+    const float v = sqrt(2*R*atm/eta) * sqrt(p/(m+p/3) * log(L/c));
+    return v * 130;
+}
+
+float Physics::ComputeRecoilVelocity(const CannonProperties& properties)
+{
+    // See this link for more info: https://www.omnicalculator.com/physics/recoil-energy
+    return (sqpow(properties.projectileMass) * ComputeMuzzleVelocity(properties) + properties.powderCharge * properties.chargeVelocity) / properties.mass;
+}
+
+float Physics::ComputeDragCoefficient(const float& radius)
+{
+    return 0.5f * AIR_DENSITY * SPHERE_DRAG_COEFF * PI * sqpow(radius / PIXEL_SCALE);
+}
+
+Maths::Vector2 Physics::ComputeDrag(const Maths::Vector2& velocity, const float& dragCoeff, const float& deltaTime)
+{
+    return -velocity * velocity.GetLength() * dragCoeff * deltaTime * 0.1f;
+}
+
+Physics::TrajectoryPrediction Physics::PredictTrajectory(const Maths::Vector2& shootingPoint, const float& rotation, const CannonProperties& properties, const float& groundHeight)
+{
+    TrajectoryPrediction prediction;
+
+    // Find the time (t) at which a cannonball would hit the ground.
+    // This is done by finding when the cannonball's vertical movement equation (a.y*0.5*t^2 + v0.y*t + p0.y) is equal to groundHeight
+    // It's the same as solving the following equation by finding its roots: a.y*0.5*t^2 + v0.y*t + p0.y - groundHeight
+    const Maths::Vector2 v0 = Maths::Vector2(rotation, ComputeMuzzleVelocity(properties), true);
+
+    // The three coefficients of the equation: a*t^2 + b*t + c
+    const float a = GRAVITY * 0.5f;
+    const float b = v0.y;
+    const float c = shootingPoint.y - (groundHeight - properties.projectileRadius);
+
+    // Find the value for delta's square root.
+    const float sqrtDelta = sqrt(sqpow(b) - 4*a*c);
+
+    // Compute the equation's roots t1 and t2 and choose the highest one.
+    const float t1 = (-b - sqrtDelta) / (2*a);
+    const float t2 = (-b + sqrtDelta) / (2*a);
+    const float t  = (t1 >= t2 ? t1 : t2);
+
+    // Find the landing velocity using the cannonball's velocity equation: (v0.x, v0.y * g * t)
+    prediction.landingVelocity = { v0.x, v0.y + GRAVITY * t };
+
+    // Find the landing position using the cannonball's movement equation: (v0.x * t + p0.x, g * 0.5f * t^2 + v0.y * t + p0.y)
+    prediction.landingPosition = { v0.x*t + shootingPoint.x, GRAVITY*0.5f*sqpow(t) + v0.y*t + shootingPoint.y };
+
+    // Find the control point of the bezier curve linked to the cannonball's movement equation.
+    // This is done by finding the intersection between the line following lines:
+    // - line that passes through the start position in the direction of the start velocity
+    // - line that passes through the landing point in the direction of the landing velocity
+    prediction.controlPoint = LineIntersection(shootingPoint, v0, prediction.landingPosition, -prediction.landingVelocity);
+
+    // Save the trajectory's general parameters.
+    const Maths::Vector2& landingPosition = prediction.landingPosition;
+    const Maths::Vector2& controlPoint    = prediction.controlPoint;
+    prediction.airTime = t;
+    prediction.landingDistance = landingPosition.x - shootingPoint.x;
+    const float highestPointT = clamp((shootingPoint.y - controlPoint.y) / (shootingPoint.y + landingPosition.y - 2*controlPoint.y), 0, 1);
+    prediction.highestPoint = shootingPoint * sqpow(1-highestPointT) + controlPoint * 2*(1-highestPointT)*highestPointT + landingPosition * sqpow(highestPointT);
+    prediction.maxHeight = clampAbove(shootingPoint.y - prediction.highestPoint.y, 0);
+    return prediction;
+}
+
+Physics::TrajectoryPrediction Physics::PredictTrajectoryWithDrag(const Maths::Vector2& shootingPoint, const float& rotation, const CannonProperties& properties, const float& groundHeight, std::vector<Maths::Vector2>* points)
+{
+    TrajectoryPrediction prediction;
+    const float timeStep  = 0.01f; prediction.highestPoint.y = groundHeight;
+    const float dragCoeff = ComputeDragCoefficient(properties.projectileRadius);
+    Transform2D projectileTransform = { shootingPoint, { rotation, ComputeMuzzleVelocity(properties), true }, { 0, GRAVITY }, 0, 0, true };
+    if (points) { points->clear(); points->push_back(projectileTransform.position); }
+
+    // Simulate a projectile with drag until it hits the ground.
+    while (projectileTransform.position.y < groundHeight - properties.projectileRadius)
+    {
+        // Increment air time.
+        prediction.airTime += timeStep;
+
+        // Apply drag.
+        projectileTransform.acceleration += ComputeDrag(projectileTransform.velocity, dragCoeff, timeStep);
+
+        // Update apply acceleration to velocity and velocity to acceleration.
+        projectileTransform.Update(timeStep);
+
+        // Save cannonball positions.
+        if (points && Maths::Vector2(points->back(), projectileTransform.position).GetLengthSquared() > 500.f)
+            points->push_back(projectileTransform.position);
+
+        // Save the highest point reached by the cannonball.
+        if (projectileTransform.position.y < prediction.highestPoint.y)
+            prediction.highestPoint = projectileTransform.position;
+    }
+
+    // Save its final velocity, position, and maximum height.
+    prediction.landingVelocity = projectileTransform.velocity;
+    prediction.landingPosition = { projectileTransform.position.x, groundHeight - properties.projectileRadius };
+    prediction.landingDistance = prediction.landingPosition.x - shootingPoint.x;
+    prediction.maxHeight = clampAbove(shootingPoint.y - prediction.highestPoint.y, 0);
+    if (points) points->push_back(prediction.landingPosition);
+    return prediction;
+}
@@ -0,0 +1,144 @@
+#include "Physics/FiringTable.h"
+#include "Physics/TrajectoryPredictor.h"
+#include "Maths/Maths.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <thread>
+using namespace Physics;
+
+
+// Converts a trajectory prediction to a firing solution.
+static FiringSolution ToSolution(const TrajectoryPrediction& prediction)
+{
+    return { prediction.airTime, prediction.landingDistance, prediction.maxHeight, prediction.landingVelocity };
+}
+
+// Computes the entries from begin to end.
+static void ComputeEntries(const FiringTableParams& params, std::vector<FiringTableEntry>& entries, const size_t& begin, const size_t& end)
+{
+    const size_t elevationCount = params.elevation.count;
+    const size_t radiusCount    = params.projectileRadius.count;
+    const size_t massCount      = params.projectileMass.count;
+    const size_t barrelCount    = params.barrelLength.count;
+
+    for (size_t i = begin; i < end; i++)
+    {
+        // Find the index of the entry's value on each axis.
+        size_t index = i;
+        const size_t elevationIndex = index % elevationCount; index /= elevationCount;
+        const size_t radiusIndex    = index % radiusCount;    index /= radiusCount;
+        const size_t massIndex      = index % massCount;      index /= massCount;
+        const size_t barrelIndex    = index % barrelCount;    index /= barrelCount;
+        const size_t chargeIndex    = index;
+
+        FiringTableEntry& entry = entries[i];
+        entry.powderCharge     = params.powderCharge    .Get(chargeIndex);
+        entry.barrelLength     = params.barrelLength    .Get(barrelIndex);
+        entry.projectileMass   = params.projectileMass  .Get(massIndex);
+        entry.projectileRadius = params.projectileRadius.Get(radiusIndex);
+        entry.elevation        = params.elevation       .Get(elevationIndex);
+
+        CannonProperties properties;
+        properties.powderCharge     = entry.powderCharge;
+        properties.barrelLength     = entry.barrelLength;
+        properties.projectileMass   = entry.projectileMass;
+        properties.projectileRadius = entry.projectileRadius;
+        entry.muzzleVelocity        = ComputeMuzzleVelocity(properties);
+
+        // The muzzle velocity model has no solution if the powder charge is longer than the barrel.
+        if (!(entry.muzzleVelocity > 0)) {
+            entry.muzzleVelocity = std::numeric_limits<float>::quiet_NaN();
+            entry.noDrag = entry.drag = {};
+            continue;
+        }
+
+        // Shoot from (0, 0) with the landing point launchHeight pixels lower.
+        const float rotation     = -Maths::degToRad(entry.elevation);
+        const float groundHeight = params.launchHeight + entry.projectileRadius;
+        entry.noDrag = ToSolution(PredictTrajectory    ({ 0, 0 }, rotation, properties, groundHeight));
+        entry.drag   = ToSolution(PredictTrajectoryRK45({ 0, 0 }, rotation, properties, groundHeight));
+    }
+}
+
+FiringTable FiringTable::Compute(const FiringTableParams& params)
+{
+    FiringTable table;
+    table.params = params;
+    const size_t entryCount = params.powderCharge.count * params.barrelLength.count * params.projectileMass.count * params.projectileRadius.count * params.elevation.count;
+    table.entries.resize(entryCount);
+    if (entryCount == 0)
+        return table;
+
+    // Give each thread a contiguous range of entries.
+    const size_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    const size_t threadCount     = std::min(entryCount, params.threadCount > 0 ? params.threadCount : hardwareThreads);
+    std::vector<std::thread> threads;
+    for (size_t t = 1; t < threadCount; t++)
+        threads.emplace_back(ComputeEntries, std::cref(params), std::ref(table.entries), entryCount * t / threadCount, entryCount * (t + 1) / threadCount);
+    ComputeEntries(params, table.entries, 0, entryCount / threadCount);
+    for (std::thread& thread : threads)
+        thread.join();
+    return table;
+}
+
+// Returns the values of an entry in the order of the CSV columns and binary fields.
+static std::array<float, FiringTable::BINARY_FIELD_COUNT> GetFields(const FiringTableEntry& e)
+{
+    return {
+        e.powderCharge, e.barrelLength, e.projectileMass, e.projectileRadius, e.elevation, e.muzzleVelocity,
+        e.noDrag.airTime, e.noDrag.landingDistance, e.noDrag.maxHeight, e.noDrag.landingVelocity.x, e.noDrag.landingVelocity.y,
+        e.drag  .airTime, e.drag  .landingDistance, e.drag  .maxHeight, e.drag  .landingVelocity.x, e.drag  .landingVelocity.y,
+    };
+}
+
+bool FiringTable::WriteCSV(const std::string& path) const
+{
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (!file)
+        return false;
+
+    std::fprintf(file, "powder_charge_kg,barrel_length_px,projectile_mass_kg,projectile_radius_px,elevation_deg,muzzle_velocity_px_s,"
+                       "air_time_s,landing_distance_px,max_height_px,landing_vx_px_s,landing_vy_px_s,"
+                       "drag_air_time_s,drag_landing_distance_px,drag_max_height_px,drag_landing_vx_px_s,drag_landing_vy_px_s\n");
+    for (const FiringTableEntry& entry : entries)
+    {
+        const std::array<float, BINARY_FIELD_COUNT> fields = GetFields(entry);
+        // 9 significant digits are enough for every float to be read back exactly.
+        for (size_t i = 0; i < fields.size(); i++)
+            std::fprintf(file, i + 1 < fields.size() ? "%.9g," : "%.9g\n", fields[i]);
+    }
+    return std::fclose(file) == 0;
+}
+
+bool FiringTable::WriteBinary(const std::string& path) const
+{
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file)
+        return false;
+
+    // Write every value in little-endian order, whatever the platform's order is.
+    const auto writeU32 = [file](const uint32_t& value)
+    {
+        const unsigned char bytes[4] = { (unsigned char)value, (unsigned char)(value >> 8), (unsigned char)(value >> 16), (unsigned char)(value >> 24) };
+        return std::fwrite(bytes, 1, 4, file) == 4;
+    };
+
+    bool ok = std::fwrite("CWFT", 1, 4, file) == 4
+           && writeU32(BINARY_VERSION)
+           && writeU32((uint32_t)entries.size())
+           && writeU32(BINARY_FIELD_COUNT);
+    for (size_t i = 0; ok && i < entries.size(); i++)
+    {
+        for (const float& field : GetFields(entries[i]))
+        {
+            uint32_t bits;
+            std::memcpy(&bits, &field, sizeof(bits));
+            ok = ok && writeU32(bits);
+        }
+    }
+    return std::fclose(file) == 0 && ok;
+}
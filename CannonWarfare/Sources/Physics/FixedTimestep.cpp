@@ -0,0 +1,30 @@
+#include "Physics/FixedTimestep.h"
+#include <cmath>
+using namespace Physics;
+
+
+FixedTimestep::FixedTimestep(const float& _stepRate, const int& _maxSubsteps)
+{
+    SetStepRate(_stepRate);
+    SetMaxSubsteps(_maxSubsteps);
+}
+
+int FixedTimestep::Advance(const double& frameTime)
+{
+    if (frameTime > 0)
+        accumulator += frameTime;
+
+    // Run as many steps as fit in the accumulated time.
+    const double step  = 1.0 / stepRate;
+    int          steps = (int)std::floor(accumulator / step);
+
+    // Drop the steps that don't fit in a frame, otherwise slow frames would make the next ones even slower.
+    if (steps > maxSubsteps)
+    {
+        droppedTime += (steps - maxSubsteps) * step;
+        steps        = maxSubsteps;
+    }
+    accumulator = std::fmod(accumulator, step);
+    stepCount  += steps;
+    return steps;
+}
@@ -0,0 +1,114 @@
+#include "Physics/InverseBallistics.h"
+#include "Physics/TrajectoryPredictor.h"
+#include "Maths/Maths.h"
+#include <cmath>
+using namespace Maths;
+using namespace Physics;
+
+
+// Converts an elevation above the horizon to a rotation shooting right (direction > 0) or left (direction < 0).
+static float ElevationToRotation(const float& elevation, const float& direction)
+{
+    return direction >= 0 ? -elevation : elevation - PI;
+}
+
+FiringAngles Physics::SolveFiringAngles(const Maths::Vector2& shootingPoint, const Maths::Vector2& target, const CannonProperties& properties)
+{
+    // Solve the projectile's movement equations for the elevation (theta) with the target at (x, y) from the shooting point, y going up:
+    // x = v*cos(theta)*t and y = v*sin(theta)*t - g*0.5*t^2, which gives a quadratic equation in tan(theta):
+    // g*x^2/(2*v^2) * tan^2(theta) - x*tan(theta) + y + g*x^2/(2*v^2) = 0
+    const float direction = target.x - shootingPoint.x;
+    const float x = fabsf(direction);
+    const float y = shootingPoint.y - target.y;
+    const float v = ComputeMuzzleVelocity(properties);
+    const float g = GRAVITY;
+    const float delta = sqpow(sqpow(v)) - g * (g * sqpow(x) + 2 * y * sqpow(v));
+
+    FiringAngles angles;
+    if (delta >= 0)
+    {
+        // The two roots give the low and high elevations.
+        angles.reachable = true;
+        angles.low  = ElevationToRotation(atan2(sqpow(v) - sqrt(delta), g * x), direction);
+        angles.high = ElevationToRotation(atan2(sqpow(v) + sqrt(delta), g * x), direction);
+    }
+    else
+    {
+        // Out of range: use the elevation that shoots the furthest at the target's height.
+        const float furthest = v * v - 2 * g * y > 0 ? atan(v / sqrt(v * v - 2 * g * y)) : PI / 2;
+        angles.low = angles.high = ElevationToRotation(furthest, direction);
+    }
+    return angles;
+}
+
+FiringAngles Physics::SolveFiringAnglesWithDrag(const Maths::Vector2& shootingPoint, const Maths::Vector2& target, const CannonProperties& properties,
+                                                TrajectoryPredictor& predictor, const int& maxIterations)
+{
+    static constexpr float MIN_ELEVATION = -80 * PI / 180;
+    static constexpr float MAX_ELEVATION =  89 * PI / 180;
+
+    FiringAngles angles;
+    const float direction    = target.x - shootingPoint.x;
+    const float distance     = fabsf(direction);
+    const float groundHeight = target.y + properties.projectileRadius; // Predictions land at groundHeight - radius.
+
+    // Returns how far towards the target a projectile shot at the given elevation lands.
+    const auto landingDistance = [&](const float& elevation)
+    {
+        angles.predictions++;
+        const float rotation = ElevationToRotation(elevation, direction);
+        return predictor.Predict(shootingPoint, rotation, properties, groundHeight).landingDistance * (direction >= 0 ? 1 : -1);
+    };
+
+    // The predictors only handle projectiles that land lower than where they are shot from.
+    if (target.y <= shootingPoint.y) {
+        angles.low = angles.high = ElevationToRotation(PI / 4, direction);
+        return angles;
+    }
+
+    // The landing distance goes up then down with the elevation: find the elevation that shoots the furthest with a golden-section search.
+    static constexpr float INV_PHI = 0.6180339887f;
+    float a = MIN_ELEVATION, b = MAX_ELEVATION;
+    float c = b - (b - a) * INV_PHI, fc = landingDistance(c);
+    float d = a + (b - a) * INV_PHI, fd = landingDistance(d);
+    for (int i = 2; i < maxIterations && b - a > 1e-4f; i++)
+    {
+        if (fc > fd) { b = d; d = c; fd = fc; c = b - (b - a) * INV_PHI; fc = landingDistance(c); }
+        else         { a = c; c = d; fc = fd; d = a + (b - a) * INV_PHI; fd = landingDistance(d); }
+    }
+    const float furthest         = fc > fd ? c  : d;
+    const float furthestDistance = fc > fd ? fc : fd;
+    if (furthestDistance < distance) {
+        angles.low = angles.high = ElevationToRotation(furthest, direction);
+        return angles;
+    }
+
+    // Finds the elevation between lo and hi that lands on the target with the Illinois variant of the regula falsi method.
+    // The landing distance minus the target distance must have a different sign at each end.
+    const auto findRoot = [&](float lo, float hi, float flo, float fhi)
+    {
+        float x = lo;
+        int   side = 0;
+        for (int i = 0; i < maxIterations; i++)
+        {
+            x = (lo * fhi - hi * flo) / (fhi - flo);
+            const float fx = landingDistance(x) - distance;
+            if (fabsf(fx) < FIRING_ANGLE_TOLERANCE)
+                break;
+
+            // Keep the root bracketed, halving the value of an end that stays twice in a row so that it converges from both sides.
+            if ((fx < 0) == (flo < 0)) { lo = x; flo = fx; if (side == -1) fhi /= 2; side = -1; }
+            else                       { hi = x; fhi = fx; if (side == +1) flo /= 2; side = +1; }
+        }
+        return x;
+    };
+
+    // The low angle is between the lowest elevation and the furthest one, the high angle between the furthest one and the highest elevation.
+    const float furthestError = furthestDistance - distance;
+    const float lowError      = landingDistance(MIN_ELEVATION) - distance;
+    const float highError     = landingDistance(MAX_ELEVATION) - distance;
+    angles.reachable = true;
+    angles.low  = ElevationToRotation(lowError  < 0 ? findRoot(MIN_ELEVATION, furthest, lowError, furthestError) : MIN_ELEVATION, direction);
+    angles.high = ElevationToRotation(highError < 0 ? findRoot(furthest, MAX_ELEVATION, furthestError, highError) : MAX_ELEVATION, direction);
+    return angles;
+}
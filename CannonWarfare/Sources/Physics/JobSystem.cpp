@@ -0,0 +1,170 @@
+#include "Physics/JobSystem.h"
+#include "Profiler.h"
+#include <algorithm>
+using namespace Physics;
+
+
+// Job system and queue of the current thread, if it is a worker.
+static thread_local const JobSystem* currentSystem = nullptr;
+static thread_local size_t           currentQueue  = 0;
+
+void JobSystem::JobQueue::PushBack(const QueuedJob& job)
+{
+    // Unroll the ring into a buffer twice as big when it is full.
+    if (count == jobs.size())
+    {
+        std::vector<QueuedJob> grown(jobs.size() * 2);
+        for (size_t i = 0; i < count; i++)
+            grown[i] = jobs[(first + i) % jobs.size()];
+        jobs.swap(grown);
+        first = 0;
+    }
+    jobs[(first + count++) % jobs.size()] = job;
+}
+
+JobSystem::QueuedJob JobSystem::JobQueue::PopBack()
+{
+    return jobs[(first + --count) % jobs.size()];
+}
+
+JobSystem::QueuedJob JobSystem::JobQueue::PopFront()
+{
+    const QueuedJob job = jobs[first];
+    first = (first + 1) % jobs.size();
+    count--;
+    return job;
+}
+
+size_t JobSystem::GetDefaultWorkerCount()
+{
+    return std::max(1u, std::thread::hardware_concurrency()) - 1;
+}
+
+JobSystem::JobSystem(const size_t& workerCount)
+{
+    StartWorkers(workerCount);
+}
+
+JobSystem::~JobSystem()
+{
+    StopWorkers();
+}
+
+void JobSystem::SetWorkerCount(const size_t& workerCount)
+{
+    if (workerCount == workers.size())
+        return;
+    StopWorkers();
+    StartWorkers(workerCount);
+}
+
+void JobSystem::StartWorkers(const size_t& workerCount)
+{
+    stopping = false;
+    queues.clear();
+    for (size_t i = 0; i < workerCount + 1; i++)
+        queues.push_back(std::make_unique<JobQueue>());
+    for (size_t i = 1; i < workerCount + 1; i++)
+        workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+}
+
+void JobSystem::StopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+    for (std::thread& worker : workers)
+        worker.join();
+    workers.clear();
+}
+
+size_t JobSystem::GetCurrentQueue() const
+{
+    return currentSystem == this ? currentQueue : 0;
+}
+
+void JobSystem::Run(JobCounter& counter, const Job& job)
+{
+    counter.pending.fetch_add(1, std::memory_order_relaxed);
+
+    // Count the job before queuing it so that the count can't go below zero when it is taken right away.
+    // The count is changed under the lock so that a worker can't miss it between checking it and sleeping.
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        queuedJobs.fetch_add(1, std::memory_order_relaxed);
+    }
+    {
+        JobQueue& queue = *queues[GetCurrentQueue()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.PushBack({ job, &counter });
+    }
+    wakeUp.notify_one();
+}
+
+void JobSystem::Wait(JobCounter& counter)
+{
+    const size_t queueIndex = GetCurrentQueue();
+    while (!counter.IsDone())
+    {
+        // Help with the queued jobs. If there are none, the remaining ones are running on other threads.
+        if (!TryRunJob(queueIndex))
+            std::this_thread::yield();
+    }
+}
+
+bool JobSystem::TryRunJob(const size_t& queueIndex)
+{
+    QueuedJob job;
+    bool found = false;
+
+    // Take the newest job of this thread's queue, it is the most likely to still be in cache.
+    {
+        JobQueue& queue = *queues[queueIndex];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.count > 0) {
+            job   = queue.PopBack();
+            found = true;
+        }
+    }
+
+    // Otherwise steal the oldest job of another queue.
+    for (size_t i = 1; !found && i < queues.size(); i++)
+    {
+        JobQueue& queue = *queues[(queueIndex + i) % queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.count > 0) {
+            job   = queue.PopFront();
+            found = true;
+        }
+    }
+    if (!found)
+        return false;
+
+    queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+    {
+        PROFILE_ZONE("Job");
+        job.job();
+    }
+    job.counter->pending.fetch_sub(1, std::memory_order_release);
+    return true;
+}
+
+void JobSystem::WorkerLoop(const size_t& queueIndex)
+{
+    currentSystem = this;
+    currentQueue  = queueIndex;
+    Profiler::SetThreadName("Worker " + std::to_string(queueIndex));
+    while (true)
+    {
+        if (TryRunJob(queueIndex))
+            continue;
+
+        // Sleep until a job is queued.
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wakeUp.wait(lock, [this]() { return stopping || queuedJobs.load(std::memory_order_relaxed) > 0; });
+        if (stopping)
+            return;
+    }
+}
@@ -0,0 +1,9 @@
+#include "Physics/Projectile.h"
+#include "Physics/PhysicsConstants.h"
+
+
+Physics::Projectile::Projectile(const Maths::Vector2& startPosition, const Maths::Vector2& startVelocity)
+    : position(startPosition), velocity(startVelocity), acceleration(0, GRAVITY),
+      startPos(startPosition), startV(startVelocity), endPos(startPosition), endV(startVelocity)
+{
+}
@@ -0,0 +1,418 @@
+#include "Physics/ProjectilePool.h"
+#include "Physics/Ballistics.h"
+#include "Physics/SpatialGrid.h"
+#include "Physics/JobSystem.h"
+#include "Maths/Maths.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+using namespace Maths;
+using namespace Physics;
+
+
+size_t ProjectilePool::Add(const Projectile& projectile)
+{
+    const size_t i = Size();
+    Resize(i + 1);
+
+    posX[i] = projectile.position.x;     posY[i] = projectile.position.y;
+    prevX[i] = posX[i];                  prevY[i] = posY[i];
+    velX[i] = projectile.velocity.x;     velY[i] = projectile.velocity.y;
+    accX[i] = projectile.acceleration.x; accY[i] = projectile.acceleration.y;
+    radius[i]       = projectile.radius;
+    mass[i]         = projectile.mass;
+    elasticity[i]   = projectile.elasticity;
+    dragCoeff[i]    = projectile.applyDrag && !projectile.landed ? ComputeDragCoefficient(projectile.radius) : 0.f;
+    airTime[i]      = projectile.airTime;
+    age[i]          = 0;
+    destroyTimer[i] = DESTROY_DURATION + 0.1f;
+    flags[i]        = (projectile.landed    ? ProjectileFlags::LANDED   : 0)
+                    | (projectile.collided  ? ProjectileFlags::COLLIDED : 0)
+                    | (projectile.applyDrag ? ProjectileFlags::DRAG     : 0);
+
+    startPos[i] = projectile.startPos;
+    startV  [i] = projectile.startV;
+    endPos  [i] = projectile.endPos;
+    endV    [i] = projectile.endV;
+    trails  [i] = ProjectileTrail();
+    if (projectile.applyDrag)
+    {
+        if (!freeTrailBlocks.empty()) {
+            trails[i].block = freeTrailBlocks.back();
+            freeTrailBlocks.pop_back();
+        }
+        else {
+            trails[i].block = (uint32_t)(trailPoints.size() / TRAIL_CAPACITY);
+            trailPoints.resize(trailPoints.size() + TRAIL_CAPACITY);
+        }
+        KeepTrailPoint(i, projectile.position);
+    }
+    return i;
+}
+
+void ProjectilePool::Reserve(const size_t& capacity)
+{
+    for (std::vector<float>* array : { &posX, &posY, &prevX, &prevY, &velX, &velY, &accX, &accY, &radius, &mass, &elasticity, &dragCoeff, &airTime, &age, &destroyTimer })
+        array->reserve(capacity);
+    for (std::vector<Maths::Vector2>* array : { &startPos, &startV, &endPos, &endV })
+        array->reserve(capacity);
+    flags          .reserve(capacity);
+    trails         .reserve(capacity);
+    trailPoints    .reserve(capacity * TRAIL_CAPACITY);
+    freeTrailBlocks.reserve(capacity);
+}
+
+void ProjectilePool::Resize(const size_t& size)
+{
+    for (std::vector<float>* array : { &posX, &posY, &prevX, &prevY, &velX, &velY, &accX, &accY, &radius, &mass, &elasticity, &dragCoeff, &airTime, &age, &destroyTimer })
+        array->resize(size);
+    for (std::vector<Maths::Vector2>* array : { &startPos, &startV, &endPos, &endV })
+        array->resize(size);
+    for (size_t i = size; i < trails.size(); i++)
+        if (trails[i].block != ProjectileTrail::NO_BLOCK)
+            freeTrailBlocks.push_back(trails[i].block);
+    flags .resize(size);
+    trails.resize(size);
+}
+
+void ProjectilePool::MoveSlot(const size_t& from, const size_t& to)
+{
+    for (std::vector<float>* array : { &posX, &posY, &prevX, &prevY, &velX, &velY, &accX, &accY, &radius, &mass, &elasticity, &dragCoeff, &airTime, &age, &destroyTimer })
+        (*array)[to] = (*array)[from];
+    for (std::vector<Maths::Vector2>* array : { &startPos, &startV, &endPos, &endV })
+        (*array)[to] = (*array)[from];
+    flags[to] = flags[from];
+    std::swap(trails[to], trails[from]); // The removed projectile's block ends up past the kept ones, where Resize frees it.
+}
+
+void ProjectilePool::Step(const float& deltaTime, const float& groundHeight, std::vector<ProjectileEvent>* events)
+{
+    ReserveStepChunks(1, posX.capacity());
+    StepRange(deltaTime, groundHeight, 0, Size(), stepChunks[0].bouncing, events);
+}
+
+void ProjectilePool::Step(const float& deltaTime, const float& groundHeight, JobSystem& jobs, std::vector<ProjectileEvent>* events)
+{
+    // Each chunk writes its events to its own list, then the lists are appended in order so that events keep the same order as when stepping on one thread.
+    ReserveStepChunks(JobSystem::GetChunkCount(Size(), STEP_CHUNK_SIZE), std::min(posX.capacity(), STEP_CHUNK_SIZE));
+    jobs.ParallelFor(Size(), STEP_CHUNK_SIZE, [&](const size_t& chunk, const size_t& begin, const size_t& end)
+    {
+        stepChunks[chunk].events.clear();
+        StepRange(deltaTime, groundHeight, begin, end, stepChunks[chunk].bouncing, events ? &stepChunks[chunk].events : nullptr);
+    });
+    if (events)
+        for (size_t chunk = 0; chunk < JobSystem::GetChunkCount(Size(), STEP_CHUNK_SIZE); chunk++)
+            events->insert(events->end(), stepChunks[chunk].events.begin(), stepChunks[chunk].events.end());
+}
+
+void ProjectilePool::ReserveStepChunks(const size_t& count, const size_t& capacity)
+{
+    // The lists of a chunk can hold as many projectiles as the pool, so that they only grow when it does.
+    stepChunks.resize(std::max(stepChunks.size(), count));
+    for (StepChunk& chunk : stepChunks)
+    {
+        chunk.bouncing.reserve(capacity);
+        chunk.events  .reserve(capacity);
+    }
+}
+
+void ProjectilePool::StepRange(const float& deltaTime, const float& groundHeight, const size_t& begin, const size_t& end,
+                               std::vector<uint32_t>& bouncing, std::vector<ProjectileEvent>* events)
+{
+    std::copy(posX.begin() + begin, posX.begin() + end, prevX.begin() + begin);
+    std::copy(posY.begin() + begin, posY.begin() + end, prevY.begin() + begin);
+
+    // Tick the destroy timers down if they have started.
+    for (size_t i = begin; i < end; i++)
+        if (0.f <= destroyTimer[i] && destroyTimer[i] <= DESTROY_DURATION)
+            destroyTimer[i] -= deltaTime;
+
+    // Find the projectiles that went under the ground during the last step, they bounce instead of moving.
+    bouncing.clear();
+    for (size_t i = begin; i < end; i++)
+        if (posY[i] > groundHeight - radius[i])
+            bouncing.push_back((uint32_t)i);
+
+    // Apply drag, then acceleration to velocity and velocity to position for all projectiles above the ground.
+    for (size_t i = begin; i < end; i++)
+    {
+        age[i] += deltaTime;
+        if (posY[i] >= groundHeight - radius[i])
+            continue;
+
+        const float drag = dragCoeff[i] * sqrtf(velX[i]*velX[i] + velY[i]*velY[i]) * deltaTime * 0.1f;
+        accX[i] -= velX[i] * drag;
+        accY[i] -= velY[i] * drag;
+        velX[i] += accX[i] * deltaTime;
+        velY[i] += accY[i] * deltaTime;
+        posX[i] += velX[i] * deltaTime;
+        posY[i] += velY[i] * deltaTime;
+        if (!(flags[i] & ProjectileFlags::LANDED))
+            airTime[i] += deltaTime;
+    }
+
+    // Make the projectiles under the ground bounce.
+    for (const uint32_t& i : bouncing)
+        Bounce(i, groundHeight, events);
+
+    // Sample the positions of projectiles with drag until they land.
+    for (size_t i = begin; i < end; i++)
+        if ((flags[i] & (ProjectileFlags::DRAG | ProjectileFlags::LANDED)) == ProjectileFlags::DRAG)
+            AddTrailSample(i, GetPosition(i));
+}
+
+void ProjectilePool::AddTrailSample(const size_t& i, const Maths::Vector2& position)
+{
+    ProjectileTrail& trail = trails[i];
+    const Maths::Vector2 offset(trail.lastKept, position);
+    const float distance = offset.GetLength();
+
+    // Keep the last sample if the line from the last kept point to this one would stray from the samples in between, or if it turned back.
+    const bool strays = trail.hasWedge && (distance < trail.farthest - trail.tolerance
+                     || (distance > 0 && (trail.wedgeMin.Cross(offset) < 0 || offset.Cross(trail.wedgeMax) < 0)));
+    if (strays)
+    {
+        KeepTrailPoint(i, trail.lastSample);
+        AddTrailSample(i, position);
+        return;
+    }
+
+    // Narrow the wedge to the lines that also pass within tolerance of this sample.
+    if (distance > trail.tolerance)
+    {
+        const Maths::Vector2 direction = offset / distance;
+        const float sine = trail.tolerance / distance, cosine = sqrtf(1 - sine * sine);
+        const Maths::Vector2 lower = { direction.x * cosine + direction.y * sine, direction.y * cosine - direction.x * sine };
+        const Maths::Vector2 upper = { direction.x * cosine - direction.y * sine, direction.y * cosine + direction.x * sine };
+        if (!trail.hasWedge || trail.wedgeMin.Cross(lower) > 0) trail.wedgeMin = lower;
+        if (!trail.hasWedge || upper.Cross(trail.wedgeMax) > 0) trail.wedgeMax = upper;
+        trail.hasWedge = true;
+        trail.farthest = std::max(trail.farthest, distance);
+    }
+    trail.lastSample = position;
+}
+
+// Distance from a point to the segment [a, b].
+static float GetSegmentDistance(const Maths::Vector2& point, const Maths::Vector2& a, const Maths::Vector2& b)
+{
+    const Maths::Vector2 segment(a, b), offset(a, point);
+    const float lengthSquared = segment.GetLengthSquared();
+    const float t = lengthSquared > 0 ? clamp(offset.Dot(segment) / lengthSquared, 0, 1) : 0.f;
+    return (offset - segment * t).GetLength();
+}
+
+// Douglas-Peucker: marks the points between first and last to keep so that the lines between kept points stay within tolerance of the others.
+static void MarkKeptPoints(const Maths::Vector2* points, const size_t& first, const size_t& last, const float& tolerance, bool* kept)
+{
+    size_t farthest = first;
+    float  farthestDistance = 0;
+    for (size_t j = first + 1; j < last; j++)
+    {
+        const float distance = GetSegmentDistance(points[j], points[first], points[last]);
+        if (distance > farthestDistance) {
+            farthest         = j;
+            farthestDistance = distance;
+        }
+    }
+    if (farthestDistance <= tolerance)
+        return;
+    kept[farthest] = true;
+    MarkKeptPoints(points, first, farthest, tolerance, kept);
+    MarkKeptPoints(points, farthest, last, tolerance, kept);
+}
+
+void ProjectilePool::KeepTrailPoint(const size_t& i, const Maths::Vector2& position)
+{
+    ProjectileTrail& trail  = trails[i];
+    Maths::Vector2*  points = &trailPoints[trail.block * TRAIL_CAPACITY];
+    const Maths::Vector2 point = position; // May be the trail's last sample.
+
+    // When the block is full, simplify the kept points with twice the tolerance until some are dropped. The first and last ones stay.
+    while (trail.keptCount == TRAIL_CAPACITY)
+    {
+        trail.tolerance *= 2;
+        bool kept[TRAIL_CAPACITY] = {};
+        kept[0] = kept[trail.keptCount - 1] = true;
+        MarkKeptPoints(points, 0, trail.keptCount - 1, trail.tolerance, kept);
+
+        uint32_t keptCount = 0;
+        for (uint32_t j = 0; j < trail.keptCount; j++)
+            if (kept[j])
+                points[keptCount++] = points[j];
+        trail.keptCount = keptCount;
+    }
+
+    points[trail.keptCount++] = point;
+    trail.lastKept   = point;
+    trail.lastSample = point;
+    trail.hasWedge   = false;
+    trail.farthest   = 0;
+}
+
+void ProjectilePool::Bounce(const uint32_t& i, const float& groundHeight, std::vector<ProjectileEvent>* events)
+{
+    const float restHeight = groundHeight - radius[i];
+    ProjectileEventType type = ProjectileEventType::BOUNCED;
+    accX[i] = 0; accY[i] = GRAVITY;
+
+    // If it's the first time it touches the ground, finalize the trajectory values.
+    if (!(flags[i] & ProjectileFlags::LANDED))
+    {
+        posY[i]      = restHeight;
+        endPos[i]    = GetPosition(i);
+        endV  [i]    = GetVelocity(i);
+        dragCoeff[i] = 0;
+        flags[i]    |= ProjectileFlags::LANDED;
+        if (flags[i] & ProjectileFlags::DRAG) {
+            AddTrailSample(i, endPos[i]);
+            KeepTrailPoint(i, endPos[i]);
+        }
+        type = ProjectileEventType::LANDED;
+    }
+
+    // If it still has some velocity, make it bounce.
+    if (velX[i]*velX[i] + velY[i]*velY[i] > 10*10)
+    {
+        posY[i]  = restHeight - 0.01f;
+        velX[i] *=  elasticity[i];
+        velY[i] *= -elasticity[i];
+    }
+
+    // If it has very little velocity, stop all its movement.
+    else
+    {
+        posY[i] = restHeight;
+        velX[i] = velY[i] = 0;
+        accX[i] = accY[i] = 0;
+    }
+
+    if (events)
+        events->push_back({ type, i, i, GetPosition(i), GetVelocity(i).GetLength() });
+}
+
+void ProjectilePool::Collide(std::vector<ProjectileEvent>* events)
+{
+    PROFILE_ZONE("ProjectilePool::Collide");
+    const uint32_t count = (uint32_t)Size();
+    for (uint32_t a = 0; a < count; a++)
+        for (uint32_t b = a + 1; b < count; b++)
+            ResolveCollision(a, b, events);
+}
+
+void ProjectilePool::Collide(SpatialGrid& grid, std::vector<ProjectileEvent>* events)
+{
+    PROFILE_ZONE("ProjectilePool::Collide");
+    grid.Build(*this);
+
+    // Resolve the pairs in the same order as the brute-force version, skipping the projectiles that are too far to overlap.
+    // Collisions move both projectiles, so their cells are updated. The other candidates of a only change if it moves
+    // to another cell, then they are searched again after the last tested one.
+    const uint32_t count = (uint32_t)Size();
+    for (uint32_t a = 0; a < count; a++)
+    {
+        const std::vector<uint32_t>* neighbours = &grid.FindNeighbours(a, a + 1);
+        size_t n = 0;
+        while (n < neighbours->size())
+        {
+            const uint32_t b = (*neighbours)[n++];
+            if (!ResolveCollision(a, b, events))
+                continue;
+            grid.Update(*this, b);
+            if (grid.Update(*this, a)) {
+                neighbours = &grid.FindNeighbours(a, b + 1);
+                n = 0;
+            }
+        }
+    }
+}
+
+bool ProjectilePool::ResolveCollision(const uint32_t& a, const uint32_t& b, std::vector<ProjectileEvent>* events)
+{
+    const float dx      = posX[b] - posX[a];
+    const float dy      = posY[b] - posY[a];
+    const float minDist = radius[a] + radius[b];
+    const float sqDist  = dx*dx + dy*dy;
+    if (sqDist > minDist*minDist || sqDist <= 0.f) // Overlapping centers have no contact normal.
+        return false;
+    const float          distToB = sqrtf(sqDist);
+    const Maths::Vector2 dirToB  = Maths::Vector2(dx, dy) / distToB;
+
+    // Get the masses of the projectiles.
+    const float m1 = mass[a];
+    const float m2 = mass[b];
+
+    // Get the initial velocities of the projectiles.
+    const Maths::Vector2 v1i = GetVelocity(a);
+    const Maths::Vector2 v2i = GetVelocity(b);
+
+    // Compute the final velocities of the projectiles.
+    const Maths::Vector2 v1f = (v1i * (m1-m2) + v2i * (m2*2)) / (m1+m2);
+    const Maths::Vector2 v2f = (v2i * (m2-m1) + v1i * (m1*2)) / (m1+m2);
+
+    // Reset the projectiles' acceleration and set their velocities to the final velocities.
+    accX[a] = accX[b] = 0;
+    accY[a] = accY[b] = GRAVITY;
+    velX[a] = v1f.x; velY[a] = v1f.y;
+    velX[b] = v2f.x; velY[b] = v2f.y;
+
+    // Move the projectiles out of each other.
+    const Maths::Vector2 offset = dirToB * (distToB - minDist) / 2;
+    posX[a] += offset.x; posY[a] += offset.y;
+    posX[b] -= offset.x; posY[b] -= offset.y;
+
+    // Tell the projectiles they have collided and should stop drawing their trajectory.
+    if (!IsLanded(a)) flags[a] |= ProjectileFlags::COLLIDED;
+    if (!IsLanded(b)) flags[b] |= ProjectileFlags::COLLIDED;
+
+    if (events)
+        events->push_back({ ProjectileEventType::COLLIDED, a, b, GetPosition(a) + dirToB * radius[a], (v1f.GetLength() + v2f.GetLength()) / 2 });
+    return true;
+}
+
+size_t ProjectilePool::RemoveDestroyed()
+{
+    // Compact the arrays in a single pass so that the oldest projectiles stay first.
+    const size_t count = Size();
+    size_t kept = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (IsDestroyed(i))
+            continue;
+        if (kept != i)
+            MoveSlot(i, kept);
+        kept++;
+    }
+    Resize(kept);
+    return count - kept;
+}
+
+Maths::Vector2 ProjectilePool::GetControlPoint(const size_t& i) const
+{
+    return LineIntersection(startPos[i], startV[i], GetEndPos(i), -GetEndV(i));
+}
+
+float ProjectilePool::GetAlpha(const size_t& i) const
+{
+    return destroyTimer[i] <= DESTROY_DURATION ? clamp(destroyTimer[i] / DESTROY_DURATION, 0, 1) : 1.f;
+}
+
+Projectile ProjectilePool::Get(const size_t& i) const
+{
+    Projectile projectile;
+    projectile.position     = GetPosition(i);
+    projectile.velocity     = GetVelocity(i);
+    projectile.acceleration = { accX[i], accY[i] };
+    projectile.radius       = radius[i];
+    projectile.mass         = mass[i];
+    projectile.elasticity   = elasticity[i];
+    projectile.applyDrag    = HasDrag(i);
+    projectile.landed       = IsLanded(i);
+    projectile.collided     = HasCollided(i);
+    projectile.airTime      = airTime[i];
+    projectile.startPos     = startPos[i];
+    projectile.startV       = startV[i];
+    projectile.endPos       = GetEndPos(i);
+    projectile.endV         = GetEndV(i);
+    return projectile;
+}
@@ -0,0 +1,92 @@
+#include "Physics/SpatialGrid.h"
+#include "Physics/ProjectilePool.h"
+#include <algorithm>
+#include <cmath>
+using namespace Physics;
+
+
+uint32_t SpatialGrid::GetBucket(const int32_t& x, const int32_t& y) const
+{
+    return ((uint32_t)x * 73856093u ^ (uint32_t)y * 19349663u) & tableMask;
+}
+
+void SpatialGrid::Link(const uint32_t& i)
+{
+    const uint32_t bucket = bucketOf[i];
+    prev[i] = NONE;
+    next[i] = bucketHead[bucket];
+    if (next[i] != NONE)
+        prev[next[i]] = i;
+    bucketHead[bucket] = i;
+}
+
+void SpatialGrid::Unlink(const uint32_t& i)
+{
+    if (prev[i] != NONE) next[prev[i]] = next[i];
+    else                 bucketHead[bucketOf[i]] = next[i];
+    if (next[i] != NONE) prev[next[i]] = prev[i];
+}
+
+void SpatialGrid::Build(const ProjectilePool& pool)
+{
+    const uint32_t count = (uint32_t)pool.Size();
+    if (count == 0)
+        return;
+
+    // Make the cells a bit wider than the biggest projectile so that overlapping projectiles are always in neighbouring cells,
+    // even when the division by the cell size rounds up.
+    const float maxRadius = *std::max_element(pool.radius.begin(), pool.radius.end());
+    cellSize = std::max(maxRadius * 2.f, 1.f) * 1.001f;
+
+    // Use a power of two table with at least twice as many buckets as projectiles.
+    uint32_t tableSize = 1;
+    while (tableSize < count * 2)
+        tableSize <<= 1;
+    tableMask = tableSize - 1;
+
+    cellX   .resize(count);
+    cellY   .resize(count);
+    bucketOf.resize(count);
+    next    .resize(count);
+    prev    .resize(count);
+    bucketHead.assign(tableSize, NONE);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        cellX[i]    = (int32_t)floorf(pool.posX[i] / cellSize);
+        cellY[i]    = (int32_t)floorf(pool.posY[i] / cellSize);
+        bucketOf[i] = GetBucket(cellX[i], cellY[i]);
+        Link(i);
+    }
+}
+
+bool SpatialGrid::Update(const ProjectilePool& pool, const uint32_t& i)
+{
+    const int32_t x = (int32_t)floorf(pool.posX[i] / cellSize);
+    const int32_t y = (int32_t)floorf(pool.posY[i] / cellSize);
+    if (x == cellX[i] && y == cellY[i])
+        return false;
+    Unlink(i);
+    cellX[i]    = x;
+    cellY[i]    = y;
+    bucketOf[i] = GetBucket(x, y);
+    Link(i);
+    return true;
+}
+
+const std::vector<uint32_t>& SpatialGrid::FindNeighbours(const uint32_t& i, const uint32_t& first)
+{
+    neighbours.clear();
+    for (int32_t y = cellY[i] - 1; y <= cellY[i] + 1; y++)
+    {
+        for (int32_t x = cellX[i] - 1; x <= cellX[i] + 1; x++)
+        {
+            // Skip projectiles from other cells that share the same bucket.
+            // Neighbouring cells can share a bucket too, the cell check also keeps them from being added twice.
+            for (uint32_t j = bucketHead[GetBucket(x, y)]; j != NONE; j = next[j])
+                if (j >= first && cellX[j] == x && cellY[j] == y)
+                    neighbours.push_back(j);
+        }
+    }
+    std::sort(neighbours.begin(), neighbours.end());
+    return neighbours;
+}
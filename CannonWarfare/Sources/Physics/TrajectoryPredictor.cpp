@@ -0,0 +1,318 @@
+#include "Physics/TrajectoryPredictor.h"
+#include "Maths/Maths.h"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+using namespace Maths;
+using namespace Physics;
+
+
+const char* Physics::GetDragPredictionModeName(const DragPredictionMode& mode)
+{
+    switch (mode)
+    {
+    case DragPredictionMode::EULER:  return "Euler";
+    case DragPredictionMode::RK45:   return "RK45";
+    case DragPredictionMode::CACHED: return "Cached";
+    default:                         return "Unknown";
+    }
+}
+
+
+// ---------- ADAPTIVE INTEGRATOR ---------- //
+
+namespace
+{
+    DragState Derivative(const DragState& s, const double& k)
+    {
+        const double speed = std::sqrt(s.vx*s.vx + s.vy*s.vy);
+        return { s.vx, s.vy, s.ax, s.ay, -k * s.vx * speed, -k * s.vy * speed };
+    }
+
+    // Returns s + sum(weights[i] * derivatives[i]) * h.
+    template<size_t N>
+    DragState Combine(const DragState& s, const double& h, const double (&weights)[N], const DragState (&derivatives)[N])
+    {
+        DragState result = s;
+        for (size_t i = 0; i < N; i++)
+        {
+            const double w = weights[i] * h;
+            result.px += w * derivatives[i].px; result.py += w * derivatives[i].py;
+            result.vx += w * derivatives[i].vx; result.vy += w * derivatives[i].vy;
+            result.ax += w * derivatives[i].ax; result.ay += w * derivatives[i].ay;
+        }
+        return result;
+    }
+
+    // Quintic Hermite interpolation of the position between two nodes (matches position, velocity and acceleration at both ends).
+    void InterpolatePosition(const DragNode& n0, const DragNode& n1, const double& s, double& x, double& y)
+    {
+        const double h  = n1.time - n0.time;
+        const double s2 = s*s, s3 = s2*s, s4 = s3*s, s5 = s4*s;
+        const double h0 = 1 - 10*s3 + 15*s4 - 6*s5;
+        const double h1 = (s - 6*s3 + 8*s4 - 3*s5) * h;
+        const double h2 = (0.5*s2 - 1.5*s3 + 1.5*s4 - 0.5*s5) * h*h;
+        const double h3 = (0.5*s3 - s4 + 0.5*s5) * h*h;
+        const double h4 = (-4*s3 + 7*s4 - 3*s5) * h;
+        const double h5 = 10*s3 - 15*s4 + 6*s5;
+        x = h0*n0.state.px + h1*n0.state.vx + h2*n0.state.ax + h3*n1.state.ax + h4*n1.state.vx + h5*n1.state.px;
+        y = h0*n0.state.py + h1*n0.state.vy + h2*n0.state.ay + h3*n1.state.ay + h4*n1.state.vy + h5*n1.state.py;
+    }
+
+    // Cubic Hermite interpolation of the velocity between two nodes (matches velocity and acceleration at both ends).
+    void InterpolateVelocity(const DragNode& n0, const DragNode& n1, const double& s, double& x, double& y)
+    {
+        const double h   = n1.time - n0.time;
+        const double s2  = s*s, s3 = s2*s;
+        const double h00 = 2*s3 - 3*s2 + 1;
+        const double h10 = (s3 - 2*s2 + s) * h;
+        const double h01 = -2*s3 + 3*s2;
+        const double h11 = (s3 - s2) * h;
+        x = h00*n0.state.vx + h10*n0.state.ax + h01*n1.state.vx + h11*n1.state.ax;
+        y = h00*n0.state.vy + h10*n0.state.ay + h01*n1.state.vy + h11*n1.state.ay;
+    }
+
+    // Finds the s in [0, 1] at which f(s) crosses 0, f(0) and f(1) having different signs.
+    template<typename Function>
+    double Bisect(const Function& f)
+    {
+        double lo = 0, hi = 1;
+        const bool rising = f(0.0) < 0;
+        for (int i = 0; i < 50; i++)
+        {
+            const double mid = (lo + hi) / 2;
+            if ((f(mid) < 0) == rising) lo = mid;
+            else                        hi = mid;
+        }
+        return (lo + hi) / 2;
+    }
+}
+
+TrajectoryPrediction Physics::PredictTrajectoryRK45(const Maths::Vector2& shootingPoint, const float& rotation, const CannonProperties& properties, const float& groundHeight,
+                                                    std::vector<Maths::Vector2>* points, const double& tolerance, std::vector<DragNode>* scratch)
+{
+    // Dormand-Prince 5(4) coefficients.
+    static constexpr double A2[1] = { 1./5 };
+    static constexpr double A3[2] = { 3./40, 9./40 };
+    static constexpr double A4[3] = { 44./45, -56./15, 32./9 };
+    static constexpr double A5[4] = { 19372./6561, -25360./2187, 64448./6561, -212./729 };
+    static constexpr double A6[5] = { 9017./3168, -355./33, 46732./5247, 49./176, -5103./18656 };
+    static constexpr double B [6] = { 35./384, 0, 500./1113, 125./192, -2187./6784, 11./84 };
+    static constexpr double E [7] = { 71./57600, 0, -71./16695, 71./1920, -17253./339200, 22./525, -1./40 }; // 5th order minus 4th order weights.
+    static constexpr double MAX_AIR_TIME = 120;
+
+    TrajectoryPrediction prediction;
+    const double    k         = ComputeDragCoefficient(properties.projectileRadius) * 0.1; // Same factor as ComputeDrag.
+    const double    landingY  = groundHeight - properties.projectileRadius;
+    const Vector2   v0        = { rotation, ComputeMuzzleVelocity(properties), true };
+    prediction.highestPoint   = shootingPoint;
+
+    // The accepted steps go in the given buffer, which keeps its capacity between predictions, or in a local one.
+    std::vector<DragNode> localNodes;
+    std::vector<DragNode>& nodes = scratch ? *scratch : localNodes;
+    nodes.clear();
+    nodes.push_back({ 0, { shootingPoint.x, shootingPoint.y, v0.x, v0.y, 0, GRAVITY } });
+
+    // Integrate until the projectile goes under the landing height, adapting the step size to the local error.
+    double h = 0.01;
+    double airTime = 0, landingX = shootingPoint.x, landingVX = v0.x, landingVY = v0.y;
+    bool landed = shootingPoint.y >= landingY;
+    DragState k1 = Derivative(nodes.back().state, k);
+    while (!landed && nodes.back().time < MAX_AIR_TIME)
+    {
+        const DragNode& node = nodes.back();
+        const DragState& s   = node.state;
+        const DragState k2   = Derivative(Combine(s, h, A2, { k1 }), k);
+        const DragState k3   = Derivative(Combine(s, h, A3, { k1, k2 }), k);
+        const DragState k4   = Derivative(Combine(s, h, A4, { k1, k2, k3 }), k);
+        const DragState k5   = Derivative(Combine(s, h, A5, { k1, k2, k3, k4 }), k);
+        const DragState k6   = Derivative(Combine(s, h, A6, { k1, k2, k3, k4, k5 }), k);
+        const DragState next = Combine(s, h, B, { k1, k2, k3, k4, k5, k6 });
+        const DragState k7   = Derivative(next, k);
+        const DragState diff = Combine(DragState{}, h, E, { k1, k2, k3, k4, k5, k6, k7 });
+
+        // Root mean square of the error, scaled by the tolerance and the size of the values.
+        const double errors[6][3] = {
+            { diff.px, s.px, next.px }, { diff.py, s.py, next.py },
+            { diff.vx, s.vx, next.vx }, { diff.vy, s.vy, next.vy },
+            { diff.ax, s.ax, next.ax }, { diff.ay, s.ay, next.ay },
+        };
+        double error = 0;
+        for (const auto& e : errors)
+            error += std::pow(e[0] / (tolerance * (1 + std::max(std::abs(e[1]), std::abs(e[2])))), 2);
+        error = std::sqrt(error / 6);
+
+        // Shrink the step and try again if the error is too big, otherwise accept it and grow the next one.
+        const double factor = std::min(5.0, std::max(0.2, 0.9 * std::pow(std::max(error, 1e-10), -0.2)));
+        if (error > 1) {
+            h *= factor;
+            continue;
+        }
+        nodes.push_back({ node.time + h, next });
+        k1 = k7; // The last stage is the derivative at the start of the next step.
+        h *= factor;
+
+        const DragNode& n0 = nodes[nodes.size() - 2];
+        const DragNode& n1 = nodes.back();
+
+        // If the projectile started going down during this step, save its highest point.
+        if (n0.state.vy < 0 && n1.state.vy >= 0)
+        {
+            double vx, vy, x, y;
+            const double apex = Bisect([&](const double& t) { InterpolateVelocity(n0, n1, t, vx, vy); return vy; });
+            InterpolatePosition(n0, n1, apex, x, y);
+            if (y < prediction.highestPoint.y)
+                prediction.highestPoint = { (float)x, (float)y };
+        }
+
+        // If the projectile went under the landing height, find exactly when.
+        if (n1.state.py >= landingY)
+        {
+            double y;
+            const double landing = Bisect([&](const double& t) { InterpolatePosition(n0, n1, t, landingX, y); return y - landingY; });
+            InterpolatePosition(n0, n1, landing, landingX, y);
+            InterpolateVelocity(n0, n1, landing, landingVX, landingVY);
+            airTime = n0.time + (n1.time - n0.time) * landing;
+            landed  = true;
+        }
+    }
+
+    // Save the landing values.
+    prediction.airTime         = (float)airTime;
+    prediction.landingPosition = { (float)landingX,  (float)landingY  };
+    prediction.landingVelocity = { (float)landingVX, (float)landingVY };
+    prediction.landingDistance = prediction.landingPosition.x - shootingPoint.x;
+    prediction.maxHeight       = clampAbove(shootingPoint.y - prediction.highestPoint.y, 0);
+    prediction.controlPoint    = LineIntersection(shootingPoint, v0, prediction.landingPosition, -prediction.landingVelocity);
+
+    // Sample positions evenly spaced in time along the trajectory.
+    if (points)
+    {
+        points->resize(PREDICTION_POINT_COUNT);
+        size_t node = 0;
+        for (size_t i = 0; i < PREDICTION_POINT_COUNT; i++)
+        {
+            const double t = airTime * i / (PREDICTION_POINT_COUNT - 1);
+            while (node + 2 < nodes.size() && nodes[node + 1].time < t)
+                node++;
+            if (nodes.size() < 2) {
+                (*points)[i] = shootingPoint;
+                continue;
+            }
+            const DragNode& n0 = nodes[node];
+            const DragNode& n1 = nodes[node + 1];
+            double x, y;
+            InterpolatePosition(n0, n1, std::min(1.0, std::max(0.0, (t - n0.time) / (n1.time - n0.time))), x, y);
+            (*points)[i] = { (float)x, (float)y };
+        }
+        points->back() = prediction.landingPosition;
+    }
+    return prediction;
+}
+
+
+// ---------- CACHE ---------- //
+
+// Returns the value between a and b at the given interpolation factor.
+static TrajectoryPrediction Lerp(const TrajectoryPrediction& a, const TrajectoryPrediction& b, const float& t)
+{
+    TrajectoryPrediction result;
+    result.landingVelocity = a.landingVelocity + (b.landingVelocity - a.landingVelocity) * t;
+    result.landingPosition = a.landingPosition + (b.landingPosition - a.landingPosition) * t;
+    result.controlPoint    = a.controlPoint    + (b.controlPoint    - a.controlPoint)    * t;
+    result.highestPoint    = a.highestPoint    + (b.highestPoint    - a.highestPoint)    * t;
+    result.airTime         = lerp(a.airTime,         b.airTime,         t);
+    result.maxHeight       = lerp(a.maxHeight,       b.maxHeight,       t);
+    result.landingDistance = lerp(a.landingDistance, b.landingDistance, t);
+    return result;
+}
+
+const TrajectoryPredictor::Sample& TrajectoryPredictor::GetSample(const int32_t& angleIndex, const int32_t& dropIndex, const CannonProperties& properties)
+{
+    // Probe the slots from the key's hash until the sample or an empty slot is found.
+    const uint64_t key  = (uint64_t)(uint32_t)angleIndex << 32 | (uint32_t)dropIndex;
+    uint32_t       slot = ((uint32_t)angleIndex * 73856093u ^ (uint32_t)dropIndex * 19349663u) & (SLOT_COUNT - 1);
+    for (; slots[slot] != EMPTY_SLOT; slot = (slot + 1) & (SLOT_COUNT - 1))
+    {
+        if (samples[slots[slot]].key == key) {
+            hitCount++;
+            return samples[slots[slot]];
+        }
+    }
+
+    // Predict the trajectory of a projectile shot from (0, 0), with the ground placed so that it lands at the sample's height.
+    missCount++;
+    slots[slot] = (uint32_t)samples.size();
+    Sample& sample = samples.emplace_back();
+    sample.key = key;
+    sample.prediction = PredictTrajectoryRK45({ 0, 0 }, angleIndex * ANGLE_STEP, properties, dropIndex * DROP_STEP + properties.projectileRadius,
+                                              &scratchPoints, RK45_TOLERANCE, &scratchNodes);
+    std::copy(scratchPoints.begin(), scratchPoints.end(), sample.points.begin());
+    return sample;
+}
+
+TrajectoryPrediction TrajectoryPredictor::Predict(const Maths::Vector2& shootingPoint, const float& rotation, const CannonProperties& properties, const float& groundHeight,
+                                                  std::vector<Maths::Vector2>* points)
+{
+    if (mode == DragPredictionMode::EULER)
+        return PredictTrajectoryWithDrag(shootingPoint, rotation, properties, groundHeight, points);
+    if (mode == DragPredictionMode::RK45)
+        return PredictTrajectoryRK45(shootingPoint, rotation, properties, groundHeight, points, RK45_TOLERANCE, &scratchNodes);
+
+    // Clear the cache if the samples were computed with other properties, or if it is full.
+    const float velocity = ComputeMuzzleVelocity(properties);
+    if (velocity != muzzleVelocity || properties.projectileRadius != projectileRadius || samples.size() + 4 > MAX_SAMPLES)
+    {
+        Clear();
+        muzzleVelocity   = velocity;
+        projectileRadius = properties.projectileRadius;
+    }
+
+    // Find the 4 samples around the shooting angle and the height above the landing point.
+    const float   angle      = rotation / ANGLE_STEP;
+    const float   drop       = (groundHeight - properties.projectileRadius - shootingPoint.y) / DROP_STEP;
+    const int32_t angleIndex = (int32_t)floorf(angle);
+    const int32_t dropIndex  = (int32_t)floorf(drop);
+    const float   angleT     = angle - angleIndex;
+    const float   dropT      = drop  - dropIndex;
+    // While the cannon rotates smoothly they are usually the same as for the last prediction, and only the weights change.
+    if (!cell[0] || angleIndex != cellAngleIndex || dropIndex != cellDropIndex)
+    {
+        cell[0] = &GetSample(angleIndex,     dropIndex,     properties);
+        cell[1] = &GetSample(angleIndex + 1, dropIndex,     properties);
+        cell[2] = &GetSample(angleIndex,     dropIndex + 1, properties);
+        cell[3] = &GetSample(angleIndex + 1, dropIndex + 1, properties);
+        cellAngleIndex = angleIndex;
+        cellDropIndex  = dropIndex;
+    }
+    const Sample& s00 = *cell[0];
+    const Sample& s10 = *cell[1];
+    const Sample& s01 = *cell[2];
+    const Sample& s11 = *cell[3];
+
+    // Interpolate between them and move the result to the shooting point.
+    TrajectoryPrediction prediction = Lerp(Lerp(s00.prediction, s10.prediction, angleT), Lerp(s01.prediction, s11.prediction, angleT), dropT);
+    prediction.landingPosition += shootingPoint;
+    prediction.controlPoint    += shootingPoint;
+    prediction.highestPoint    += shootingPoint;
+    prediction.landingPosition.y = groundHeight - properties.projectileRadius;
+    if (points)
+    {
+        points->resize(PREDICTION_POINT_COUNT);
+        for (size_t i = 0; i < PREDICTION_POINT_COUNT; i++)
+        {
+            const Maths::Vector2 p0 = s00.points[i] + (s10.points[i] - s00.points[i]) * angleT;
+            const Maths::Vector2 p1 = s01.points[i] + (s11.points[i] - s01.points[i]) * angleT;
+            (*points)[i] = shootingPoint + p0 + (p1 - p0) * dropT;
+        }
+    }
+    return prediction;
+}
+
+void TrajectoryPredictor::Clear()
+{
+    samples.reserve(MAX_SAMPLES);
+    samples.clear();
+    slots.assign(SLOT_COUNT, EMPTY_SLOT);
+    std::fill(std::begin(cell), std::end(cell), nullptr);
+}
@@ -0,0 +1,348 @@
+#include "PostProcess.h"
+#include "Maths/Transform2DBatch.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define POST_PROCESS_X86 1
+    #include <immintrin.h>
+#endif
+
+// GCC and Clang need AVX2 enabled per function so that the rest of the program still runs on older CPUs.
+#if defined(POST_PROCESS_X86) && (defined(__GNUC__) || defined(__clang__))
+    #define POST_PROCESS_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+    #define POST_PROCESS_TARGET_AVX2
+#endif
+
+// Taps of the blur shader (GaussianBlur.fs): offsets from -4 to 3 weighted by 5 - |offset|, which add up to 24.
+constexpr int BLUR_FIRST_TAP = -4;
+constexpr int BLUR_TAP_COUNT = 8;
+constexpr int BLUR_WEIGHTS[BLUR_TAP_COUNT] = { 1, 2, 3, 4, 5, 4, 3, 2 };
+
+
+// ---------- BACKEND SELECTION ---------- //
+
+const char* GetPostProcessBackendName(const PostProcessBackend& backend)
+{
+    switch (backend)
+    {
+    case PostProcessBackend::SCALAR: return "Scalar";
+    case PostProcessBackend::SSE:    return "SSE";
+    case PostProcessBackend::AVX2:   return "AVX2";
+    default:                         return "Unknown";
+    }
+}
+
+bool IsPostProcessBackendSupported(const PostProcessBackend& backend)
+{
+    // Same instruction sets as the transform integrator.
+    switch (backend)
+    {
+    case PostProcessBackend::SCALAR: return true;
+    case PostProcessBackend::SSE:    return Maths::IsIntegratorBackendSupported(Maths::IntegratorBackend::SSE);
+    case PostProcessBackend::AVX2:   return Maths::IsIntegratorBackendSupported(Maths::IntegratorBackend::AVX2);
+    default:                         return false;
+    }
+}
+
+PostProcessBackend GetBestPostProcessBackend()
+{
+    static const PostProcessBackend best = IsPostProcessBackendSupported(PostProcessBackend::AVX2) ? PostProcessBackend::AVX2
+                                         : IsPostProcessBackendSupported(PostProcessBackend::SSE)  ? PostProcessBackend::SSE
+                                         :                                                           PostProcessBackend::SCALAR;
+    return best;
+}
+
+
+// ---------- IMAGES ---------- //
+
+void FrameImage::Resize(const int& _width, const int& _height)
+{
+    width  = _width;
+    height = _height;
+    pixels.assign((size_t)width * height * 4, 0);
+    for (size_t i = 3; i < pixels.size(); i += 4)
+        pixels[i] = 255;
+}
+
+void DownscaleFrame(const FrameImage& source, FrameImage& result, const int& factor)
+{
+    result.Resize(std::max(source.width / factor, 1), std::max(source.height / factor, 1));
+    const int blockWidth  = std::min(factor, source.width);
+    const int blockHeight = std::min(factor, source.height);
+    const int blockSize   = blockWidth * blockHeight;
+    for (int y = 0; y < result.height; y++)
+    {
+        for (int x = 0; x < result.width; x++)
+        {
+            int sum[4] = { 0, 0, 0, 0 };
+            for (int j = 0; j < blockHeight; j++)
+            {
+                const uint8_t* pixel = source.GetPixel(x * blockWidth, y * blockHeight + j);
+                for (int i = 0; i < blockWidth * 4; i++)
+                    sum[i % 4] += pixel[i];
+            }
+            uint8_t* pixel = result.GetPixel(x, y);
+            for (int c = 0; c < 4; c++)
+                pixel[c] = (uint8_t)((sum[c] + blockSize / 2) / blockSize);
+        }
+    }
+}
+
+
+// ---------- PASSES ---------- //
+
+static int WrapCoordinate(const int& value, const int& size)
+{
+    const int wrapped = value % size;
+    return wrapped < 0 ? wrapped + size : wrapped;
+}
+
+static bool IsLit(const uint8_t* pixel)
+{
+    return pixel[0] != 0 || pixel[1] != 0 || pixel[2] != 0;
+}
+
+// Alpha blends a color over another one like the GPU, in 8 bits.
+static uint8_t BlendChannel(const int& source, const int& destination, const int& alpha)
+{
+    return (uint8_t)((source * alpha + destination * (255 - alpha) + 127) / 255);
+}
+
+// The weighted sum is divided by 24 with rounding. Dividing by 8 and then by 3 can be done exactly with 16 bit SIMD multiplications.
+static uint8_t GetBlurredChannel(const int& weightedSum)
+{
+    return (uint8_t)(((weightedSum + 12) >> 3) / 3);
+}
+
+// Blurs count bytes: each tap points to the bytes read for that tap. Alpha bytes are set to 255, like the blur shader does.
+static void BlurSpanScalar(const uint8_t* const* taps, uint8_t* out, const size_t& count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        int sum = 0;
+        for (int tap = 0; tap < BLUR_TAP_COUNT; tap++)
+            sum += taps[tap][i] * BLUR_WEIGHTS[tap];
+        out[i] = i % 4 == 3 ? 255 : GetBlurredChannel(sum);
+    }
+}
+
+#ifdef POST_PROCESS_X86
+
+static void BlurSpanSSE(const uint8_t* const* taps, uint8_t* out, const size_t& count)
+{
+    const size_t  simdEnd   = count - count % 16;
+    const __m128i zero      = _mm_setzero_si128();
+    const __m128i rounding  = _mm_set1_epi16(12);
+    const __m128i third     = _mm_set1_epi16(21846); // (x * 21846) >> 16 is x / 3 for every x that can be reached here.
+    const __m128i alphaMask = _mm_set1_epi32((int)0xFF000000);
+    for (size_t i = 0; i < simdEnd; i += 16)
+    {
+        __m128i low = rounding, high = rounding;
+        for (int tap = 0; tap < BLUR_TAP_COUNT; tap++)
+        {
+            const __m128i bytes  = _mm_loadu_si128((const __m128i*)(taps[tap] + i));
+            const __m128i weight = _mm_set1_epi16((short)BLUR_WEIGHTS[tap]);
+            low  = _mm_add_epi16(low,  _mm_mullo_epi16(_mm_unpacklo_epi8(bytes, zero), weight));
+            high = _mm_add_epi16(high, _mm_mullo_epi16(_mm_unpackhi_epi8(bytes, zero), weight));
+        }
+        low  = _mm_mulhi_epu16(_mm_srli_epi16(low,  3), third);
+        high = _mm_mulhi_epu16(_mm_srli_epi16(high, 3), third);
+        _mm_storeu_si128((__m128i*)(out + i), _mm_or_si128(_mm_packus_epi16(low, high), alphaMask));
+    }
+    const uint8_t* remainingTaps[BLUR_TAP_COUNT];
+    for (int tap = 0; tap < BLUR_TAP_COUNT; tap++)
+        remainingTaps[tap] = taps[tap] + simdEnd;
+    BlurSpanScalar(remainingTaps, out + simdEnd, count - simdEnd);
+}
+
+POST_PROCESS_TARGET_AVX2 static void BlurSpanAVX2(const uint8_t* const* taps, uint8_t* out, const size_t& count)
+{
+    const size_t  simdEnd   = count - count % 16;
+    const __m256i rounding  = _mm256_set1_epi16(12);
+    const __m256i third     = _mm256_set1_epi16(21846);
+    const __m128i alphaMask = _mm_set1_epi32((int)0xFF000000);
+    for (size_t i = 0; i < simdEnd; i += 16)
+    {
+        __m256i sum = rounding;
+        for (int tap = 0; tap < BLUR_TAP_COUNT; tap++)
+        {
+            const __m256i words = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(taps[tap] + i)));
+            sum = _mm256_add_epi16(sum, _mm256_mullo_epi16(words, _mm256_set1_epi16((short)BLUR_WEIGHTS[tap])));
+        }
+        sum = _mm256_mulhi_epu16(_mm256_srli_epi16(sum, 3), third);
+
+        // Packing works on each 128 bit lane, so the low 64 bits of both lanes are gathered afterwards.
+        const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(sum, sum), 0x08);
+        _mm_storeu_si128((__m128i*)(out + i), _mm_or_si128(_mm256_castsi256_si128(packed), alphaMask));
+    }
+    const uint8_t* remainingTaps[BLUR_TAP_COUNT];
+    for (int tap = 0; tap < BLUR_TAP_COUNT; tap++)
+        remainingTaps[tap] = taps[tap] + simdEnd;
+    BlurSpanScalar(remainingTaps, out + simdEnd, count - simdEnd);
+}
+
+#else
+
+static void BlurSpanSSE (const uint8_t* const* taps, uint8_t* out, const size_t& count) { BlurSpanScalar(taps, out, count); }
+static void BlurSpanAVX2(const uint8_t* const* taps, uint8_t* out, const size_t& count) { BlurSpanScalar(taps, out, count); }
+
+#endif
+
+static void BlurSpan(const PostProcessBackend& backend, const uint8_t* const* taps, uint8_t* out, const size_t& count)
+{
+    switch (backend)
+    {
+    case PostProcessBackend::SSE:  BlurSpanSSE (taps, out, count); break;
+    case PostProcessBackend::AVX2: BlurSpanAVX2(taps, out, count); break;
+    default:                       BlurSpanScalar(taps, out, count); break;
+    }
+}
+
+// Same as NonBlackPixels.fs drawn with alpha blending: the lit pixels of the source are blended over the destination.
+void PostProcess::MaskRows(const FrameImage& source, FrameImage& destination, const int& rowBegin, const int& rowEnd) const
+{
+    for (int y = rowBegin; y < rowEnd; y++)
+    {
+        for (int x = 0; x < source.width; x++)
+        {
+            const uint8_t* pixel = source.GetPixel(x, y);
+            if (!IsLit(pixel))
+                continue;
+            uint8_t* out = destination.GetPixel(x, y);
+            for (int c = 0; c < 3; c++)
+                out[c] = BlendChannel(pixel[c], out[c], pixel[3]);
+        }
+    }
+}
+
+// Same as GaussianBlur.fs in one direction.
+void PostProcess::BlurRows(const FrameImage& source, FrameImage& destination, const bool& vertical, const PostProcessBackend& usedBackend, const int& rowBegin, const int& rowEnd) const
+{
+    const uint8_t* taps[BLUR_TAP_COUNT];
+    for (int y = rowBegin; y < rowEnd; y++)
+    {
+        uint8_t* out = destination.GetRow(y);
+
+        // Vertical taps read whole rows, so the whole row can be done at once.
+        if (vertical)
+        {
+            for (int tap = 0; tap < BLUR_TAP_COUNT; tap++)
+                taps[tap] = source.GetRow(WrapCoordinate(y + BLUR_FIRST_TAP + tap, source.height));
+            BlurSpan(usedBackend, taps, out, (size_t)source.width * 4);
+            continue;
+        }
+
+        // Horizontal taps read neighbour pixels of the same row: the pixels whose taps don't wrap around are done at once, the others one by one.
+        const int interiorBegin = std::min(-BLUR_FIRST_TAP, source.width);
+        const int interiorEnd   = std::max(source.width - (BLUR_TAP_COUNT + BLUR_FIRST_TAP - 1), interiorBegin);
+        for (int tap = 0; tap < BLUR_TAP_COUNT; tap++)
+            taps[tap] = source.GetPixel(interiorBegin + BLUR_FIRST_TAP + tap, y);
+        if (interiorEnd > interiorBegin)
+            BlurSpan(usedBackend, taps, out + interiorBegin * 4, (size_t)(interiorEnd - interiorBegin) * 4);
+
+        for (int x = 0; x < source.width; x++)
+        {
+            if (x == interiorBegin)
+                x = interiorEnd;
+            if (x >= source.width)
+                break;
+            for (int tap = 0; tap < BLUR_TAP_COUNT; tap++)
+                taps[tap] = source.GetPixel(WrapCoordinate(x + BLUR_FIRST_TAP + tap, source.width), y);
+            BlurSpanScalar(taps, out + x * 4, 4);
+        }
+    }
+}
+
+// Same as ChromaticAberration.fs on the glow, then the lit pixels of the source are blended over it like in Graphics::EndDrawing.
+void PostProcess::AberrationRows(const FrameImage& source, const FrameImage& glow, FrameImage& result, const PostProcessBackend& usedBackend, const int& rowBegin, const int& rowEnd) const
+{
+    const int   width      = glow.width;
+    const int   height     = glow.height;
+    const int   redOffset  = (int)std::floor(0.5f + aberrationIntensity); // Texel read by the shader with nearest filtering.
+    const int   blueOffset = (int)std::floor(0.5f - aberrationIntensity);
+    const float vignetteX  = vignetteSize / width;
+    const float vignetteY  = vignetteSize / height;
+
+    for (int y = rowBegin; y < rowEnd; y++)
+    {
+        const float distanceY = std::abs(0.5f - (y + 0.5f) / height);
+        for (int x = 0; x < width; x++)
+        {
+            // Outside of the vignette the aberration is at its maximum, inside it depends on the distance to the center.
+            const float distanceX = std::abs(0.5f - (x + 0.5f) / width);
+            const float ratio     = distanceX > vignetteX && distanceY > vignetteY ? 1 : (distanceX / vignetteX + distanceY / vignetteY) / 2;
+
+            const uint8_t* color       = glow.GetPixel(x, y);
+            const uint8_t  newColor[4] = { glow.GetPixel(WrapCoordinate(x + redOffset,  width), y)[0], color[1],
+                                           glow.GetPixel(WrapCoordinate(x + blueOffset, width), y)[2], 255 };
+            uint8_t* out = result.GetPixel(x, y);
+
+#ifdef POST_PROCESS_X86
+            if (usedBackend != PostProcessBackend::SCALAR)
+            {
+                // The 4 channels are mixed at once, with the same operations as the scalar version.
+                uint32_t packedNew, packedColor;
+                std::memcpy(&packedNew, newColor, 4);
+                std::memcpy(&packedColor, color, 4);
+                const __m128i zero  = _mm_setzero_si128();
+                const __m128  vNew   = _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128((int)packedNew),   zero), zero));
+                const __m128  vColor = _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128((int)packedColor), zero), zero));
+                __m128 mixed = _mm_add_ps(_mm_mul_ps(vNew, _mm_set1_ps(ratio)), _mm_mul_ps(vColor, _mm_set1_ps(1 - ratio)));
+                mixed = _mm_add_ps(_mm_min_ps(_mm_max_ps(mixed, _mm_setzero_ps()), _mm_set1_ps(255)), _mm_set1_ps(0.5f));
+                const __m128i bytes = _mm_cvttps_epi32(mixed);
+                const uint32_t packedOut = (uint32_t)_mm_cvtsi128_si32(_mm_packus_epi16(_mm_packs_epi32(bytes, zero), zero));
+                std::memcpy(out, &packedOut, 4);
+            }
+            else
+#endif
+            {
+                for (int c = 0; c < 4; c++)
+                {
+                    const float mixed = newColor[c] * ratio + color[c] * (1 - ratio);
+                    out[c] = (uint8_t)(std::min(std::max(mixed, 0.f), 255.f) + 0.5f);
+                }
+            }
+
+            const uint8_t* pixel = source.GetPixel(x, y);
+            if (IsLit(pixel)) {
+                for (int c = 0; c < 3; c++)
+                    out[c] = BlendChannel(pixel[c], out[c], pixel[3]);
+            }
+            out[3] = 255;
+        }
+    }
+}
+
+void PostProcess::Apply(const FrameImage& source, FrameImage& result, Physics::JobSystem& jobs)
+{
+    const PostProcessBackend usedBackend = IsPostProcessBackendSupported(backend) ? backend : GetBestPostProcessBackend();
+
+    blurImages[0].Resize(source.width, source.height);
+    if (blurImages[1].width != source.width || blurImages[1].height != source.height)
+        blurImages[1].Resize(source.width, source.height);
+    if (result.width != source.width || result.height != source.height)
+        result.Resize(source.width, source.height);
+
+    const auto forEachTile = [&](const auto& function)
+    {
+        jobs.ParallelFor((size_t)source.height, TILE_ROWS, [&](const size_t&, const size_t& begin, const size_t& end) {
+            function((int)begin, (int)end);
+        });
+    };
+
+    // Stamp the lit pixels over the glow, then blur it horizontally and vertically.
+    // Vertical blurring reads the rows of other tiles, so each pass waits for the previous one.
+    const int passCount = std::max(blurPasses, 1);
+    for (int pass = 0; pass < passCount; pass++)
+    {
+        forEachTile([&](const int& begin, const int& end) {
+            MaskRows(source, blurImages[0], begin, end);
+            BlurRows(blurImages[0], blurImages[1], false, usedBackend, begin, end);
+        });
+        forEachTile([&](const int& begin, const int& end) { BlurRows(blurImages[1], blurImages[0], true, usedBackend, begin, end); });
+    }
+    forEachTile([&](const int& begin, const int& end) { AberrationRows(source, blurImages[0], result, usedBackend, begin, end); });
+}
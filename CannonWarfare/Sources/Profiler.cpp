@@ -0,0 +1,197 @@
+#include "Profiler.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+using namespace std::chrono;
+
+
+// Zones ended by one thread. Only that thread writes, any thread can read.
+struct ProfileThreadBuffer
+{
+    uint32_t              id;
+    std::string           name;            // Guarded by the registry's mutex.
+    bool                  inUse = true;    // Guarded by the registry's mutex.
+    uint32_t              depth = 0;       // Only used by the thread that writes.
+    std::atomic<uint64_t> writeCount = 0;  // Number of zones ever written, the next one goes to writeCount % capacity.
+    ProfileZone           zones[PROFILER_ZONE_CAPACITY];
+};
+
+// Buffers are kept when their thread stops, and given to the next thread that starts.
+static std::mutex registryMutex;
+static std::vector<std::unique_ptr<ProfileThreadBuffer>> threadBuffers;
+
+static const steady_clock::time_point startTime = steady_clock::now();
+
+// Frame starts, only used by the thread that draws.
+static constexpr size_t FRAME_MARK_CAPACITY = 256;
+static uint64_t frameMarks[FRAME_MARK_CAPACITY];
+static size_t   frameMarkCount = 0;
+
+// Claims a buffer for the current thread the first time it is used, and frees it when the thread stops.
+struct ProfileThreadHandle
+{
+    ProfileThreadBuffer* buffer = nullptr;
+
+    ProfileThreadBuffer& Get()
+    {
+        if (buffer)
+            return *buffer;
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (const std::unique_ptr<ProfileThreadBuffer>& threadBuffer : threadBuffers) {
+            if (!threadBuffer->inUse) {
+                buffer = threadBuffer.get();
+                break;
+            }
+        }
+        if (!buffer) {
+            threadBuffers.push_back(std::make_unique<ProfileThreadBuffer>());
+            buffer = threadBuffers.back().get();
+            buffer->id = (uint32_t)threadBuffers.size() - 1;
+        }
+        buffer->inUse = true;
+        buffer->name  = "Thread " + std::to_string(buffer->id);
+        buffer->depth = 0;
+        return *buffer;
+    }
+
+    ~ProfileThreadHandle()
+    {
+        if (!buffer)
+            return;
+        std::lock_guard<std::mutex> lock(registryMutex);
+        buffer->inUse = false;
+    }
+};
+static thread_local ProfileThreadHandle currentThread;
+
+
+uint64_t Profiler::GetTime()
+{
+    return (uint64_t)duration_cast<nanoseconds>(steady_clock::now() - startTime).count();
+}
+
+void Profiler::SetThreadName(const std::string& name)
+{
+    ProfileThreadBuffer& buffer = currentThread.Get();
+    std::lock_guard<std::mutex> lock(registryMutex);
+    buffer.name = name;
+}
+
+void Profiler::RecordZone(const char* name, const uint64_t& start, const uint64_t& end, const uint32_t& depth)
+{
+    // The zone is written before the count that makes it visible.
+    ProfileThreadBuffer& buffer = currentThread.Get();
+    const uint64_t index = buffer.writeCount.load(std::memory_order_relaxed);
+    buffer.zones[index % PROFILER_ZONE_CAPACITY] = { name, start, end, depth };
+    buffer.writeCount.store(index + 1, std::memory_order_release);
+}
+
+void Profiler::MarkFrame()
+{
+    frameMarks[frameMarkCount++ % FRAME_MARK_CAPACITY] = GetTime();
+}
+
+bool Profiler::GetLastFrame(uint64_t& start, uint64_t& end)
+{
+    if (frameMarkCount < 2)
+        return false;
+    start = frameMarks[(frameMarkCount - 2) % FRAME_MARK_CAPACITY];
+    end   = frameMarks[(frameMarkCount - 1) % FRAME_MARK_CAPACITY];
+    return true;
+}
+
+std::vector<ProfileThread> Profiler::Collect(const uint64_t& start, const uint64_t& end)
+{
+    std::vector<ProfileThread> threads;
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (const std::unique_ptr<ProfileThreadBuffer>& buffer : threadBuffers)
+    {
+        ProfileThread thread;
+        thread.id   = buffer->id;
+        thread.name = buffer->name;
+
+        // Copy the zones still in the buffer, then drop the ones the thread may have overwritten meanwhile.
+        const uint64_t writeCount = buffer->writeCount.load(std::memory_order_acquire);
+        const uint64_t first      = writeCount > PROFILER_ZONE_CAPACITY ? writeCount - PROFILER_ZONE_CAPACITY : 0;
+        std::vector<ProfileZone> copied;
+        copied.reserve((size_t)(writeCount - first));
+        for (uint64_t i = first; i < writeCount; i++)
+            copied.push_back(buffer->zones[i % PROFILER_ZONE_CAPACITY]);
+        // The thread may also be in the middle of writing the zone after the last one it counted, so that slot can be torn too.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t lastWriteCount = buffer->writeCount.load(std::memory_order_relaxed);
+        const uint64_t firstValid     = lastWriteCount + 1 > PROFILER_ZONE_CAPACITY ? lastWriteCount + 1 - PROFILER_ZONE_CAPACITY : 0;
+
+        for (uint64_t i = std::max(first, firstValid); i < writeCount; i++)
+        {
+            const ProfileZone& zone = copied[(size_t)(i - first)];
+            if (zone.end > start && zone.start < end)
+                thread.zones.push_back(zone);
+        }
+        if (!thread.zones.empty())
+            threads.push_back(std::move(thread));
+    }
+    return threads;
+}
+
+// Zone and thread names only need their quotes and backslashes escaped.
+static void WriteJsonString(FILE* file, const std::string& text)
+{
+    std::fputc('"', file);
+    for (const char c : text)
+    {
+        if (c == '"' || c == '\\')
+            std::fputc('\\', file);
+        std::fputc(c, file);
+    }
+    std::fputc('"', file);
+}
+
+bool Profiler::WriteChromeTrace(const std::string& path)
+{
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (!file)
+        return false;
+
+    // Complete events ("X") in microseconds, with a name for each thread and an instant event at each frame start.
+    const std::vector<ProfileThread> threads = Collect();
+    std::fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    bool first = true;
+    const auto separate = [&]() { std::fprintf(file, first ? "" : ",\n"); first = false; };
+    for (const ProfileThread& thread : threads)
+    {
+        separate();
+        std::fprintf(file, "{\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"name\":\"thread_name\",\"args\":{\"name\":", thread.id);
+        WriteJsonString(file, thread.name);
+        std::fprintf(file, "}}");
+        for (const ProfileZone& zone : thread.zones)
+        {
+            separate();
+            std::fprintf(file, "{\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"name\":", thread.id, zone.start / 1e3, (zone.end - zone.start) / 1e3);
+            WriteJsonString(file, zone.name);
+            std::fprintf(file, "}");
+        }
+    }
+    const size_t frameMarkFirst = frameMarkCount > FRAME_MARK_CAPACITY ? frameMarkCount - FRAME_MARK_CAPACITY : 0;
+    for (size_t i = frameMarkFirst; i < frameMarkCount; i++)
+    {
+        separate();
+        std::fprintf(file, "{\"ph\":\"i\",\"s\":\"g\",\"pid\":0,\"tid\":0,\"ts\":%.3f,\"name\":\"Frame\"}", frameMarks[i % FRAME_MARK_CAPACITY] / 1e3);
+    }
+    std::fprintf(file, "\n]}\n");
+    return std::fclose(file) == 0;
+}
+
+ProfileScope::ProfileScope(const char* _name)
+    : name(_name), start(Profiler::GetTime()), depth(currentThread.Get().depth++)
+{
+}
+
+ProfileScope::~ProfileScope()
+{
+    currentThread.Get().depth--;
+    Profiler::RecordZone(name, start, Profiler::GetTime(), depth);
+}
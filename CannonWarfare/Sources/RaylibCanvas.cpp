@@ -0,0 +1,150 @@
+#include "RaylibCanvas.h"
+#include "RaylibConversions.h"
+#include "rlgl.h"
+#include <algorithm>
+#include <cstring>
+
+
+static Color ToRayColor(const CanvasColor& color)
+{
+	return { color.r, color.g, color.b, color.a };
+}
+
+void RaylibCanvas::DrawLine(const Maths::Vector2& start, const Maths::Vector2& end, const float& thickness, const CanvasColor& color)
+{
+	::DrawLineEx(ToRayVector2(start), ToRayVector2(end), thickness, ToRayColor(color));
+}
+
+void RaylibCanvas::DrawBezierQuad(const Maths::Vector2& start, const Maths::Vector2& end, const Maths::Vector2& control, const float& thickness, const CanvasColor& color)
+{
+	::DrawLineBezierQuad(ToRayVector2(start), ToRayVector2(end), ToRayVector2(control), thickness, ToRayColor(color));
+}
+
+void RaylibCanvas::DrawBezierCubic(const Maths::Vector2& start, const Maths::Vector2& end, const Maths::Vector2& startControl, const Maths::Vector2& endControl, const float& thickness, const CanvasColor& color)
+{
+	::DrawLineBezierCubic(ToRayVector2(start), ToRayVector2(end), ToRayVector2(startControl), ToRayVector2(endControl), thickness, ToRayColor(color));
+}
+
+void RaylibCanvas::DrawTriangle(const Maths::Vector2& a, const Maths::Vector2& b, const Maths::Vector2& c, const CanvasColor& color)
+{
+	::DrawTriangle(ToRayVector2(a), ToRayVector2(b), ToRayVector2(c), ToRayColor(color));
+}
+
+void RaylibCanvas::DrawRectangle(const Maths::Vector2& position, const Maths::Vector2& size, const CanvasColor& color)
+{
+	::DrawRectangleV(ToRayVector2(position), ToRayVector2(size), ToRayColor(color));
+}
+
+void RaylibCanvas::DrawCircle(const Maths::Vector2& center, const float& radius, const CanvasColor& color)
+{
+	::DrawCircleV(ToRayVector2(center), radius, ToRayColor(color));
+}
+
+void RaylibCanvas::DrawCircleLines(const Maths::Vector2& center, const float& radius, const CanvasColor& color)
+{
+	::DrawCircleLines((int)center.x, (int)center.y, radius, ToRayColor(color));
+}
+
+void RaylibCanvas::DrawCircleSector(const Maths::Vector2& center, const float& radius, const float& startAngle, const float& endAngle, const int& segments, const CanvasColor& color)
+{
+	::DrawCircleSector(ToRayVector2(center), radius, startAngle, endAngle, segments, ToRayColor(color));
+}
+
+void RaylibCanvas::DrawCircleSectorLines(const Maths::Vector2& center, const float& radius, const float& startAngle, const float& endAngle, const int& segments, const CanvasColor& color)
+{
+	::DrawCircleSectorLines(ToRayVector2(center), radius, startAngle, endAngle, segments, ToRayColor(color));
+}
+
+void RaylibCanvas::DrawPoly(const Maths::Vector2& center, const int& sides, const float& radius, const float& rotation, const CanvasColor& color)
+{
+	::DrawPoly(ToRayVector2(center), sides, radius, rotation, ToRayColor(color));
+}
+
+void RaylibCanvas::DrawText(const char* text, const Maths::Vector2& position, const int& fontSize, const CanvasColor& color)
+{
+	::DrawText(text, (int)position.x, (int)position.y, fontSize, ToRayColor(color));
+}
+
+int RaylibCanvas::MeasureText(const char* text, const int& fontSize) const
+{
+	return ::MeasureText(text, fontSize);
+}
+
+const GlyphRun& RaylibCanvas::GetGlyphRun(const char* text, const int& fontSize)
+{
+	uint32_t hash = 2166136261u ^ (uint32_t)fontSize;
+	for (const char* c = text; *c; c++)
+		hash = (hash ^ (uint8_t)*c) * 16777619u;
+	GlyphRun& run = glyphRuns[hash % GLYPH_RUN_CACHE_SIZE];
+	if (run.fontSize == fontSize && std::strcmp(run.text, text) == 0) {
+		glyphRunHits++;
+		return run;
+	}
+	glyphRunMisses++;
+
+	// Same sizes as DrawText and DrawTextEx: the default font is at least 10 pixels high, with a pixel of spacing per 10 pixels.
+	const Font  font    = GetFontDefault();
+	const int   size    = std::max(fontSize, 10);
+	const float scale   = (float)size / font.baseSize;
+	const float spacing = (float)(size / 10);
+	const float padding = (float)font.glyphPadding;
+	const float atlasWidth  = (float)font.texture.width;
+	const float atlasHeight = (float)font.texture.height;
+
+	std::strncpy(run.text, text, LABEL_CAPACITY - 1);
+	run.text[LABEL_CAPACITY - 1] = '\0';
+	run.fontSize   = fontSize;
+	run.glyphCount = 0;
+	float offsetX  = 0;
+	for (const char* c = run.text; *c; c++)
+	{
+		const int        index = GetGlyphIndex(font, (uint8_t)*c);
+		const Rectangle& rec   = font.recs[index];
+		const GlyphInfo& glyph = font.glyphs[index];
+		if (*c != ' ' && *c != '\t')
+		{
+			run.glyphs[run.glyphCount++] = {
+				offsetX + (glyph.offsetX - padding) * scale, (glyph.offsetY - padding) * scale,
+				(rec.width + 2 * padding) * scale, (rec.height + 2 * padding) * scale,
+				(rec.x - padding) / atlasWidth, (rec.y - padding) / atlasHeight,
+				(rec.x + rec.width + padding) / atlasWidth, (rec.y + rec.height + padding) / atlasHeight,
+			};
+		}
+		offsetX += (glyph.advanceX == 0 ? rec.width : glyph.advanceX) * scale + spacing;
+	}
+	return run;
+}
+
+void RaylibCanvas::DrawLabels(const CanvasLabel* labels, const size_t& count)
+{
+	rlSetTexture(GetFontDefault().texture.id);
+	rlBegin(RL_QUADS);
+	rlNormal3f(0, 0, 1);
+	for (size_t i = 0; i < count; i++)
+	{
+		const CanvasLabel& label = labels[i];
+		const GlyphRun&    run   = GetGlyphRun(label.text, label.fontSize);
+
+		// Positions are rounded down like DrawText's.
+		const float x = (float)(int)label.position.x;
+		const float y = (float)(int)label.position.y;
+		rlColor4ub(label.color.r, label.color.g, label.color.b, label.color.a);
+		for (int j = 0; j < run.glyphCount; j++)
+		{
+			// Raylib draws its batch when it is full, which must happen between quads.
+			rlCheckRenderBatchLimit(4);
+			const GlyphQuad& quad = run.glyphs[j];
+			rlTexCoord2f(quad.u0, quad.v0); rlVertex2f(x + quad.x,              y + quad.y);
+			rlTexCoord2f(quad.u0, quad.v1); rlVertex2f(x + quad.x,              y + quad.y + quad.height);
+			rlTexCoord2f(quad.u1, quad.v1); rlVertex2f(x + quad.x + quad.width, y + quad.y + quad.height);
+			rlTexCoord2f(quad.u1, quad.v0); rlVertex2f(x + quad.x + quad.width, y + quad.y);
+		}
+	}
+	rlEnd();
+	rlSetTexture(0);
+}
+
+void RaylibCanvas::DrawParticles(const ParticleGeometry& geometry)
+{
+	particleRenderer.Draw(geometry);
+}
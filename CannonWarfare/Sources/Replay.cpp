@@ -0,0 +1,259 @@
+#include "Replay.h"
+#include <cstring>
+
+
+enum class CommandValueSize { NONE, BYTE, FLOAT };
+
+static CommandValueSize GetCommandValueSize(const SceneCommandType& type)
+{
+    switch (type)
+    {
+    case SceneCommandType::SHOOT:
+    case SceneCommandType::CLEAR_PROJECTILES:
+        return CommandValueSize::NONE;
+    case SceneCommandType::SET_DRAG_PREDICTION_MODE:
+    case SceneCommandType::SET_AUTOMATIC_ROTATION:
+    case SceneCommandType::SET_APPLY_RECOIL:
+    case SceneCommandType::SET_APPLY_DRAG:
+    case SceneCommandType::SET_APPLY_COLLISIONS:
+    case SceneCommandType::SET_USE_SPATIAL_GRID:
+    case SceneCommandType::SET_SHOW_TRAJECTORY:
+    case SceneCommandType::SET_SHOW_MEASUREMENTS:
+    case SceneCommandType::SET_SHOW_PROJECTILE_TRAJECTORIES:
+        return CommandValueSize::BYTE;
+    default:
+        return CommandValueSize::FLOAT;
+    }
+}
+
+// Little-endian encoding, whatever the platform's order is.
+static void AppendU64(std::vector<uint8_t>& bytes, const uint64_t& value, const int& size = 8)
+{
+    for (int i = 0; i < size; i++)
+        bytes.push_back((uint8_t)(value >> (8 * i)));
+}
+
+static void AppendFloat(std::vector<uint8_t>& bytes, const float& value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    AppendU64(bytes, bits, 4);
+}
+
+static void AppendVarint(std::vector<uint8_t>& bytes, uint64_t value)
+{
+    do {
+        const uint8_t low = value & 0x7F;
+        value >>= 7;
+        bytes.push_back(value ? low | 0x80 : low);
+    } while (value);
+}
+
+// Reads values from a buffer, and fails instead of reading past its end.
+struct ByteReader
+{
+    const std::vector<uint8_t>& bytes;
+    size_t position = 0;
+
+    bool ReadU64(uint64_t& value, const int& size = 8)
+    {
+        if (position + size > bytes.size())
+            return false;
+        value = 0;
+        for (int i = 0; i < size; i++)
+            value |= (uint64_t)bytes[position++] << (8 * i);
+        return true;
+    }
+
+    bool ReadFloat(float& value)
+    {
+        uint64_t bits;
+        if (!ReadU64(bits, 4))
+            return false;
+        const uint32_t bits32 = (uint32_t)bits;
+        std::memcpy(&value, &bits32, sizeof(value));
+        return true;
+    }
+
+    bool ReadVarint(uint64_t& value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 64 && position < bytes.size(); shift += 7)
+        {
+            const uint8_t byte = bytes[position++];
+            value |= (uint64_t)(byte & 0x7F) << shift;
+            if (!(byte & 0x80))
+                return true;
+        }
+        return false;
+    }
+};
+
+
+bool ReplayRecorder::Open(const std::string& path, const ReplayHeader& header)
+{
+    Close();
+    file = std::fopen(path.c_str(), "wb");
+    if (!file)
+        return false;
+
+    std::vector<uint8_t> bytes = { 'C', 'W', 'R', 'P' };
+    AppendU64  (bytes, REPLAY_VERSION, 4);
+    AppendU64  (bytes, header.seed);
+    AppendFloat(bytes, header.screenSize.x);
+    AppendFloat(bytes, header.screenSize.y);
+    AppendFloat(bytes, header.stepRate);
+    std::fwrite(bytes.data(), 1, bytes.size(), file);
+    lastStep   = 0;
+    entryCount = 0;
+    return true;
+}
+
+void ReplayRecorder::Close()
+{
+    if (file)
+        std::fclose(file);
+    file = nullptr;
+}
+
+void ReplayRecorder::Write(const ReplayEntry& entry)
+{
+    if (!file)
+        return;
+
+    bytes.clear();
+    AppendVarint(bytes, entry.step - lastStep);
+    bytes.push_back((uint8_t)entry.type);
+    switch (entry.type)
+    {
+    case ReplayEntryType::COMMAND:
+        bytes.push_back((uint8_t)entry.command.type);
+        switch (GetCommandValueSize(entry.command.type))
+        {
+        case CommandValueSize::NONE:  break;
+        case CommandValueSize::BYTE:  bytes.push_back((uint8_t)entry.command.value); break;
+        case CommandValueSize::FLOAT: AppendFloat(bytes, entry.command.value);       break;
+        }
+        break;
+    case ReplayEntryType::STEP_RATE:  AppendFloat(bytes, entry.stepRate); break;
+    case ReplayEntryType::CHECKPOINT: AppendU64  (bytes, entry.checksum); break;
+    }
+    std::fwrite(bytes.data(), 1, bytes.size(), file);
+    lastStep = entry.step;
+    entryCount++;
+}
+
+void ReplayRecorder::RecordCommand(const uint64_t& step, const SceneCommand& command)
+{
+    ReplayEntry entry;
+    entry.step    = step;
+    entry.type    = ReplayEntryType::COMMAND;
+    entry.command = command;
+    Write(entry);
+}
+
+void ReplayRecorder::RecordStepRate(const uint64_t& step, const float& stepRate)
+{
+    ReplayEntry entry;
+    entry.step     = step;
+    entry.type     = ReplayEntryType::STEP_RATE;
+    entry.stepRate = stepRate;
+    Write(entry);
+}
+
+void ReplayRecorder::RecordCheckpoint(const uint64_t& step, const uint64_t& checksum)
+{
+    ReplayEntry entry;
+    entry.step     = step;
+    entry.type     = ReplayEntryType::CHECKPOINT;
+    entry.checksum = checksum;
+    Write(entry);
+    if (file)
+        std::fflush(file);
+}
+
+bool Replay::Load(const std::string& path)
+{
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file)
+        return false;
+    std::vector<uint8_t> bytes;
+    uint8_t chunk[65536];
+    size_t  readSize;
+    while ((readSize = std::fread(chunk, 1, sizeof(chunk), file)) > 0)
+        bytes.insert(bytes.end(), chunk, chunk + readSize);
+    std::fclose(file);
+
+    ByteReader reader = { bytes };
+    uint64_t version;
+    if (bytes.size() < 4 || std::memcmp(bytes.data(), "CWRP", 4) != 0)
+        return false;
+    reader.position = 4;
+    if (!reader.ReadU64(version, 4) || version != REPLAY_VERSION
+     || !reader.ReadU64(header.seed) || !reader.ReadFloat(header.screenSize.x) || !reader.ReadFloat(header.screenSize.y) || !reader.ReadFloat(header.stepRate))
+        return false;
+
+    entries.clear();
+    uint64_t step = 0;
+    while (reader.position < bytes.size())
+    {
+        ReplayEntry entry;
+        uint64_t delta, type, value;
+        if (!reader.ReadVarint(delta) || !reader.ReadU64(type, 1) || type > (uint64_t)ReplayEntryType::CHECKPOINT)
+            break;
+        entry.step = step += delta;
+        entry.type = (ReplayEntryType)type;
+
+        bool complete = false;
+        switch (entry.type)
+        {
+        case ReplayEntryType::COMMAND:
+            if (!reader.ReadU64(type, 1) || type >= SCENE_COMMAND_TYPE_COUNT)
+                break;
+            entry.command.type = (SceneCommandType)type;
+            switch (GetCommandValueSize(entry.command.type))
+            {
+            case CommandValueSize::NONE:  complete = true; break;
+            case CommandValueSize::BYTE:  complete = reader.ReadU64(value, 1); entry.command.value = (float)value; break;
+            case CommandValueSize::FLOAT: complete = reader.ReadFloat(entry.command.value); break;
+            }
+            break;
+        case ReplayEntryType::STEP_RATE:  complete = reader.ReadFloat(entry.stepRate); break;
+        case ReplayEntryType::CHECKPOINT: complete = reader.ReadU64(entry.checksum);   break;
+        }
+        if (!complete)
+            break;
+        entries.push_back(entry);
+    }
+    return true;
+}
+
+void ReplayPlayer::ApplyEntries(Scene& scene)
+{
+    for (; nextEntry < replay.entries.size() && replay.entries[nextEntry].step <= step; nextEntry++)
+    {
+        const ReplayEntry& entry = replay.entries[nextEntry];
+        switch (entry.type)
+        {
+        case ReplayEntryType::COMMAND:
+            scene.Execute(entry.command);
+            commandCount++;
+            break;
+        case ReplayEntryType::STEP_RATE:
+            stepRate = entry.stepRate;
+            break;
+        case ReplayEntryType::CHECKPOINT:
+            checkpointCount++;
+            if (scene.GetChecksum() != entry.checksum && mismatchCount++ == 0)
+                firstMismatchStep = step;
+            break;
+        }
+    }
+}
+
+void ReplayPlayer::Step(Scene& scene, Physics::JobSystem& jobs)
+{
+    ApplyEntries(scene);
+    scene.Update(1 / stepRate, jobs);
+    step++;
+}
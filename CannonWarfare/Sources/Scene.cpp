@@ -0,0 +1,147 @@
+#include "Scene.h"
+#include "MathConstants.h"
+using namespace Maths;
+
+
+Scene::Scene(const uint64_t& _seed)
+    : seed(_seed), particleManager(_seed), cannon(particleManager, groundHeight)
+{
+}
+
+void Scene::Init(const Maths::Vector2& _screenSize)
+{
+    screenSize = _screenSize;
+
+    // Initialize the stars.
+    // They use the last stream of the seed, the particle manager uses the first ones.
+    Random starRng(seed, UINT64_MAX);
+    stars.clear();
+    stars.reserve(STAR_COUNT);
+    for (size_t i = 0; i < STAR_COUNT; ++i)
+        stars.emplace_back(screenSize, starRng);
+
+    // Set the ground height.
+    groundHeight = screenSize.y - 100;
+
+    // Set the cannon's default position, rotation and shooting velocity.
+    cannon.SetPosition ({ 90, screenSize.y - 150 });
+    cannon.SetAnchorPos({ 90, screenSize.y - 150 });
+    cannon.SetRotation(-PI / 5);
+}
+
+void Scene::Update(const float& deltaTime, Physics::JobSystem& jobs)
+{
+    jobs.ParallelFor(stars.size(), 64, [&](const size_t&, const size_t& begin, const size_t& end)
+    {
+        for (size_t i = begin; i < end; i++)
+            stars[i].Update(deltaTime);
+    });
+    cannon.Update(deltaTime, jobs);
+    particleManager.Update(deltaTime, jobs);
+}
+
+void Scene::BuildDrawLists(const float& alpha, Physics::JobSystem& jobs)
+{
+    starDrawPositions.resize(stars.size());
+    for (size_t i = 0; i < stars.size(); i++)
+        starDrawPositions[i] = stars[i].GetDrawPosition(alpha);
+    particleManager.BuildDrawList(alpha, jobs);
+}
+
+void Scene::DrawBackground(Canvas& canvas) const
+{
+    for (size_t i = 0; i < starDrawPositions.size(); i++) stars[i].Draw(canvas, starDrawPositions[i]); // Draw stars.
+    canvas.DrawParticles(particleManager.GetDrawGeometry());
+}
+
+void Scene::DrawForeground(Canvas& canvas, const float& alpha)
+{
+    frameArena.Reset();
+    cannon.DrawTrajectories(canvas);
+    cannon.Draw(canvas, frameArena, alpha);
+    canvas.DrawRectangle({ 0, groundHeight }, { screenSize.x, screenSize.y - groundHeight }, CANVAS_BLACK); // Draw ground.
+    cannon.DrawMeasurements(canvas, frameArena);
+    canvas.DrawLine({ 0, groundHeight }, { screenSize.x, groundHeight }, 1, CANVAS_WHITE);                  // Draw ground top.
+}
+
+void Scene::Execute(const SceneCommand& command)
+{
+    const bool enabled = command.value != 0;
+    switch (command.type)
+    {
+    case SceneCommandType::SHOOT:                 cannon.Shoot();                            break;
+    case SceneCommandType::CLEAR_PROJECTILES:     cannon.ClearProjectiles();                 break;
+    case SceneCommandType::SET_ROTATION:          cannon.SetRotation(command.value);         break;
+    case SceneCommandType::SET_POWDER_CHARGE:     cannon.SetPowderCharge(command.value);     break;
+    case SceneCommandType::SET_BARREL_LENGTH:     cannon.SetBarrelLength(command.value);     break;
+    case SceneCommandType::SET_PROJECTILE_RADIUS: cannon.SetProjectileRadius(command.value); break;
+    case SceneCommandType::SET_PROJECTILE_MASS:   cannon.SetProjectileMass(command.value);   break;
+    case SceneCommandType::SET_HEIGHT:
+        cannon.SetAnchorPos({ cannon.GetAnchorPos().x, screenSize.y - 150 - command.value });
+        cannon.SetPosition (cannon.GetAnchorPos());
+        break;
+    case SceneCommandType::SET_DRAG_PREDICTION_MODE:
+        cannon.SetDragPredictionMode((Physics::DragPredictionMode)(int)command.value);
+        break;
+    case SceneCommandType::SET_AUTOMATIC_ROTATION: cannon.automaticRotation = enabled; break;
+    case SceneCommandType::SET_APPLY_RECOIL:       cannon.applyRecoil       = enabled; break;
+    case SceneCommandType::SET_APPLY_DRAG:
+        cannon.applyDrag       = enabled;
+        cannon.applyCollisions = false;
+        break;
+    case SceneCommandType::SET_APPLY_COLLISIONS:
+        cannon.applyCollisions = enabled;
+        cannon.applyDrag       = false;
+        break;
+    case SceneCommandType::SET_USE_SPATIAL_GRID:             cannon.useSpatialGrid             = enabled; break;
+    case SceneCommandType::SET_SHOW_TRAJECTORY:              cannon.showTrajectory             = enabled; break;
+    case SceneCommandType::SET_SHOW_MEASUREMENTS:            cannon.showMeasurements           = enabled; break;
+    case SceneCommandType::SET_SHOW_PROJECTILE_TRAJECTORIES: cannon.showProjectileTrajectories = enabled; break;
+    }
+}
+
+// FNV-1a of the bytes of the given values.
+static void HashBytes(uint64_t& hash, const void* data, const size_t& size)
+{
+    const uint8_t* bytes = (const uint8_t*)data;
+    for (size_t i = 0; i < size; i++)
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+}
+
+template<typename T>
+static void HashVector(uint64_t& hash, const std::vector<T>& values)
+{
+    if (!values.empty())
+        HashBytes(hash, values.data(), values.size() * sizeof(T));
+}
+
+uint64_t Scene::GetChecksum() const
+{
+    uint64_t hash = 14695981039346656037ull;
+
+    // Cannon.
+    const float cannonValues[] = {
+        cannon.GetPosition().x, cannon.GetPosition().y, cannon.GetAnchorPos().x, cannon.GetAnchorPos().y, cannon.GetRotation(),
+        cannon.GetPowderCharge(), cannon.GetBarrelLength(), cannon.GetProjectileRadius(), cannon.GetProjectileMass(),
+    };
+    const bool cannonFlags[] = { cannon.automaticRotation, cannon.applyRecoil, cannon.applyDrag, cannon.applyCollisions, cannon.useSpatialGrid };
+    HashBytes(hash, cannonValues, sizeof(cannonValues));
+    HashBytes(hash, cannonFlags,  sizeof(cannonFlags));
+
+    // Cannonballs.
+    const Physics::ProjectilePool& projectiles = cannon.GetProjectiles();
+    const uint64_t projectileCount = projectiles.Size();
+    HashBytes (hash, &projectileCount, sizeof(projectileCount));
+    HashVector(hash, projectiles.posX);
+    HashVector(hash, projectiles.posY);
+    HashVector(hash, projectiles.velX);
+    HashVector(hash, projectiles.velY);
+    HashVector(hash, projectiles.airTime);
+    HashVector(hash, projectiles.destroyTimer);
+    HashVector(hash, projectiles.flags);
+
+    // Particles are only counted, their positions depend on the integrator backend.
+    const uint64_t particleCounts[] = { particleManager.GetParticleCount(), particleManager.GetSpawnerCount() };
+    HashBytes(hash, particleCounts, sizeof(particleCounts));
+    return hash;
+}
@@ -0,0 +1,285 @@
+#include "SoftwareCanvas.h"
+#include "ParticleGeometry.h"
+#include "Arithmetic.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+using namespace Maths;
+
+
+// Same as raylib's.
+constexpr int BEZIER_LINE_DIVISIONS = 24;
+constexpr int CIRCLE_SEGMENTS       = 36;
+
+// Glyphs of the built-in font: 7 rows of 5 pixels, drawn in a cell of 10 pixels high like raylib's default font.
+struct Glyph
+{
+	char    character;
+	uint8_t rows[7];
+};
+constexpr int GLYPH_WIDTH     = 5;
+constexpr int GLYPH_HEIGHT    = 7;
+constexpr int GLYPH_BASE_SIZE = 10;
+static constexpr Glyph GLYPHS[] = {
+	{ '0', { 0b01110, 0b10001, 0b10011, 0b10101, 0b11001, 0b10001, 0b01110 } },
+	{ '1', { 0b00100, 0b01100, 0b00100, 0b00100, 0b00100, 0b00100, 0b01110 } },
+	{ '2', { 0b01110, 0b10001, 0b00001, 0b00010, 0b00100, 0b01000, 0b11111 } },
+	{ '3', { 0b11111, 0b00010, 0b00100, 0b00010, 0b00001, 0b10001, 0b01110 } },
+	{ '4', { 0b00010, 0b00110, 0b01010, 0b10010, 0b11111, 0b00010, 0b00010 } },
+	{ '5', { 0b11111, 0b10000, 0b11110, 0b00001, 0b00001, 0b10001, 0b01110 } },
+	{ '6', { 0b00110, 0b01000, 0b10000, 0b11110, 0b10001, 0b10001, 0b01110 } },
+	{ '7', { 0b11111, 0b00001, 0b00010, 0b00100, 0b01000, 0b01000, 0b01000 } },
+	{ '8', { 0b01110, 0b10001, 0b10001, 0b01110, 0b10001, 0b10001, 0b01110 } },
+	{ '9', { 0b01110, 0b10001, 0b10001, 0b01111, 0b00001, 0b00010, 0b01100 } },
+	{ '.', { 0b00000, 0b00000, 0b00000, 0b00000, 0b00000, 0b01100, 0b01100 } },
+	{ '-', { 0b00000, 0b00000, 0b00000, 0b11111, 0b00000, 0b00000, 0b00000 } },
+	{ 's', { 0b00000, 0b00000, 0b01110, 0b10000, 0b01110, 0b00001, 0b11110 } },
+	{ 'p', { 0b00000, 0b00000, 0b11110, 0b10001, 0b11110, 0b10000, 0b10000 } },
+	{ 'x', { 0b00000, 0b00000, 0b10001, 0b01010, 0b00100, 0b01010, 0b10001 } },
+};
+
+static const Glyph* FindGlyph(const char& character)
+{
+	for (const Glyph& glyph : GLYPHS)
+		if (glyph.character == character)
+			return &glyph;
+	return nullptr;
+}
+
+// Point on a circle, with raylib 4.2's angles (in degrees, 0 is down and they go counter-clockwise on screen).
+static Maths::Vector2 GetCirclePoint(const Maths::Vector2& center, const float& radius, const float& angle)
+{
+	return { center.x + sinf(degToRad(angle)) * radius, center.y + cosf(degToRad(angle)) * radius };
+}
+
+// Edge of a triangle. Its function is positive on the inside, and computed from the same endpoint whatever the direction of the edge,
+// so that the two triangles sharing it get exactly opposite values and only one of them covers the pixels exactly on it.
+struct Edge
+{
+	float x0, y0, dx, dy, sign;
+	bool  ownsZero;
+
+	Edge(const Maths::Vector2& from, const Maths::Vector2& to)
+	{
+		const bool swapped = to.y < from.y || (to.y == from.y && to.x < from.x);
+		const Maths::Vector2& start = swapped ? to   : from;
+		const Maths::Vector2& end   = swapped ? from : to;
+		x0 = start.x; y0 = start.y;
+		dx = end.x - start.x;
+		dy = end.y - start.y;
+		sign     = swapped ? -1.f : 1.f;
+		ownsZero = !swapped;
+	}
+
+	bool Covers(const float& x, const float& y) const
+	{
+		const float value = sign * (dx * (y - y0) - dy * (x - x0));
+		return value > 0 || (value == 0 && ownsZero);
+	}
+};
+
+
+void SoftwareCanvas::BlendPixel(uint8_t* pixel, const CanvasColor& color) const
+{
+	// Same as raylib's default blend mode, which also blends the alpha channel.
+	const int alpha = color.a, inverse = 255 - color.a;
+	pixel[0] = (uint8_t)((color.r * alpha + pixel[0] * inverse + 127) / 255);
+	pixel[1] = (uint8_t)((color.g * alpha + pixel[1] * inverse + 127) / 255);
+	pixel[2] = (uint8_t)((color.b * alpha + pixel[2] * inverse + 127) / 255);
+	pixel[3] = (uint8_t)((color.a * alpha + pixel[3] * inverse + 127) / 255);
+}
+
+void SoftwareCanvas::FillTriangle(Maths::Vector2 a, Maths::Vector2 b, Maths::Vector2 c, const CanvasColor& color)
+{
+	if (color.a == 0)
+		return;
+
+	// Make the triangle counter-clockwise so that the edge functions are positive inside (both windings are drawn).
+	const float area = Maths::Vector2(a, b).Cross(Maths::Vector2(a, c));
+	if (area == 0)
+		return;
+	if (area < 0)
+		std::swap(b, c);
+	const Edge edges[3] = { Edge(a, b), Edge(b, c), Edge(c, a) };
+
+	// Go through the pixels whose centers are in the bounding box.
+	const int xBegin = std::max(0,            (int)ceilf (std::min({ a.x, b.x, c.x }) - 0.5f));
+	const int xEnd   = std::min(frame.width,  (int)floorf(std::max({ a.x, b.x, c.x }) - 0.5f) + 1);
+	const int yBegin = std::max(0,            (int)ceilf (std::min({ a.y, b.y, c.y }) - 0.5f));
+	const int yEnd   = std::min(frame.height, (int)floorf(std::max({ a.y, b.y, c.y }) - 0.5f) + 1);
+	for (int y = yBegin; y < yEnd; y++)
+	{
+		const float centerY = y + 0.5f;
+		uint8_t* row = frame.GetRow(y);
+		for (int x = xBegin; x < xEnd; x++)
+		{
+			const float centerX = x + 0.5f;
+			if (edges[0].Covers(centerX, centerY) && edges[1].Covers(centerX, centerY) && edges[2].Covers(centerX, centerY))
+				BlendPixel(row + x * 4, color);
+		}
+	}
+}
+
+void SoftwareCanvas::FillRectangle(const float& x, const float& y, const float& width, const float& height, const CanvasColor& color)
+{
+	if (color.a == 0)
+		return;
+
+	const int xBegin = std::max(0,            (int)ceilf(x - 0.5f));
+	const int xEnd   = std::min(frame.width,  (int)ceilf(x + width - 0.5f));
+	const int yBegin = std::max(0,            (int)ceilf(y - 0.5f));
+	const int yEnd   = std::min(frame.height, (int)ceilf(y + height - 0.5f));
+	for (int row = yBegin; row < yEnd; row++)
+	{
+		uint8_t* pixels = frame.GetRow(row);
+		for (int column = xBegin; column < xEnd; column++)
+			BlendPixel(pixels + column * 4, color);
+	}
+}
+
+void SoftwareCanvas::Clear(const CanvasColor& color)
+{
+	for (size_t i = 0; i < frame.pixels.size(); i += 4)
+	{
+		frame.pixels[i + 0] = color.r;
+		frame.pixels[i + 1] = color.g;
+		frame.pixels[i + 2] = color.b;
+		frame.pixels[i + 3] = color.a;
+	}
+}
+
+void SoftwareCanvas::DrawLine(const Maths::Vector2& start, const Maths::Vector2& end, const float& thickness, const CanvasColor& color)
+{
+	// Quad around the line without caps, like raylib's DrawLineEx.
+	const Maths::Vector2 delta(start, end);
+	const float length = delta.GetLength();
+	if (length <= 0)
+		return;
+	const Maths::Vector2 halfWidth = Maths::Vector2(-delta.y, delta.x) * (thickness / (2 * length));
+	FillTriangle(start - halfWidth, start + halfWidth, end + halfWidth, color);
+	FillTriangle(start - halfWidth, end   + halfWidth, end - halfWidth, color);
+}
+
+void SoftwareCanvas::DrawBezierQuad(const Maths::Vector2& start, const Maths::Vector2& end, const Maths::Vector2& control, const float& thickness, const CanvasColor& color)
+{
+	Maths::Vector2 previous = start;
+	for (int i = 1; i <= BEZIER_LINE_DIVISIONS; i++)
+	{
+		const float t = (float)i / BEZIER_LINE_DIVISIONS;
+		const Maths::Vector2 current = start * ((1 - t) * (1 - t)) + control * (2 * (1 - t) * t) + end * (t * t);
+		DrawLine(previous, current, thickness, color);
+		previous = current;
+	}
+}
+
+void SoftwareCanvas::DrawBezierCubic(const Maths::Vector2& start, const Maths::Vector2& end, const Maths::Vector2& startControl, const Maths::Vector2& endControl, const float& thickness, const CanvasColor& color)
+{
+	Maths::Vector2 previous = start;
+	for (int i = 1; i <= BEZIER_LINE_DIVISIONS; i++)
+	{
+		const float t = (float)i / BEZIER_LINE_DIVISIONS, u = 1 - t;
+		const Maths::Vector2 current = start * (u * u * u) + startControl * (3 * u * u * t) + endControl * (3 * u * t * t) + end * (t * t * t);
+		DrawLine(previous, current, thickness, color);
+		previous = current;
+	}
+}
+
+void SoftwareCanvas::DrawTriangle(const Maths::Vector2& a, const Maths::Vector2& b, const Maths::Vector2& c, const CanvasColor& color)
+{
+	FillTriangle(a, b, c, color);
+}
+
+void SoftwareCanvas::DrawRectangle(const Maths::Vector2& position, const Maths::Vector2& size, const CanvasColor& color)
+{
+	FillRectangle(position.x, position.y, size.x, size.y, color);
+}
+
+void SoftwareCanvas::DrawCircle(const Maths::Vector2& center, const float& radius, const CanvasColor& color)
+{
+	DrawCircleSector(center, radius, 0, 360, CIRCLE_SEGMENTS, color);
+}
+
+void SoftwareCanvas::DrawCircleLines(const Maths::Vector2& center, const float& radius, const CanvasColor& color)
+{
+	DrawCircleSectorLines(center, radius, 0, 360, CIRCLE_SEGMENTS, color);
+}
+
+void SoftwareCanvas::DrawCircleSector(const Maths::Vector2& center, const float& radius, const float& startAngle, const float& endAngle, const int& segments, const CanvasColor& color)
+{
+	const float start = std::min(startAngle, endAngle), end = std::max(startAngle, endAngle);
+	const int   count = std::max(segments, (int)ceilf((end - start) / 90));
+	const float step  = (end - start) / count;
+	for (int i = 0; i < count; i++)
+		FillTriangle(center, GetCirclePoint(center, radius, start + step * i), GetCirclePoint(center, radius, start + step * (i + 1)), color);
+}
+
+void SoftwareCanvas::DrawCircleSectorLines(const Maths::Vector2& center, const float& radius, const float& startAngle, const float& endAngle, const int& segments, const CanvasColor& color)
+{
+	const float start = std::min(startAngle, endAngle), end = std::max(startAngle, endAngle);
+	const int   count = std::max(segments, (int)ceilf((end - start) / 90));
+	const float step  = (end - start) / count;
+	for (int i = 0; i < count; i++)
+		DrawLine(GetCirclePoint(center, radius, start + step * i), GetCirclePoint(center, radius, start + step * (i + 1)), 1, color);
+
+	// Lines from the center to both ends, unless it is a whole circle.
+	if ((int)(end - start) % 360 != 0)
+	{
+		DrawLine(center, GetCirclePoint(center, radius, start), 1, color);
+		DrawLine(center, GetCirclePoint(center, radius, end),   1, color);
+	}
+}
+
+void SoftwareCanvas::DrawPoly(const Maths::Vector2& center, const int& sides, const float& radius, const float& rotation, const CanvasColor& color)
+{
+	// Corners start from the bottom and are rotated around the center like in raylib.
+	const int   count = std::max(sides, 3);
+	const float cosRotation = cosf(degToRad(rotation)), sinRotation = sinf(degToRad(rotation));
+	const auto corner = [&](const int& i)
+	{
+		const Maths::Vector2 point = GetCirclePoint({ 0, 0 }, radius, 360.f * i / count);
+		return center + Maths::Vector2(point.x * cosRotation - point.y * sinRotation, point.x * sinRotation + point.y * cosRotation);
+	};
+	for (int i = 0; i < count; i++)
+		FillTriangle(center, corner(i), corner(i + 1), color);
+}
+
+void SoftwareCanvas::DrawText(const char* text, const Maths::Vector2& position, const int& fontSize, const CanvasColor& color)
+{
+	const int   size    = std::max(fontSize, GLYPH_BASE_SIZE);
+	const float scale   = (float)size / GLYPH_BASE_SIZE;
+	const int   spacing = size / GLYPH_BASE_SIZE;
+
+	// Positions are rounded down like raylib's DrawText.
+	float x = (float)(int)position.x;
+	const float y = (float)(int)position.y + scale; // The glyphs start on the second row of the cell.
+	for (const char* character = text; *character; character++)
+	{
+		if (const Glyph* glyph = FindGlyph(*character))
+		{
+			for (int row = 0; row < GLYPH_HEIGHT; row++)
+				for (int column = 0; column < GLYPH_WIDTH; column++)
+					if (glyph->rows[row] & (1 << (GLYPH_WIDTH - 1 - column)))
+						FillRectangle(x + column * scale, y + row * scale, scale, scale, color);
+		}
+		x += GLYPH_WIDTH * scale + spacing;
+	}
+}
+
+int SoftwareCanvas::MeasureText(const char* text, const int& fontSize) const
+{
+	const int    size   = std::max(fontSize, GLYPH_BASE_SIZE);
+	const size_t length = strlen(text);
+	if (length == 0)
+		return 0;
+	return (int)(length * GLYPH_WIDTH * size / GLYPH_BASE_SIZE + (length - 1) * (size / GLYPH_BASE_SIZE));
+}
+
+void SoftwareCanvas::DrawParticles(const ParticleGeometry& geometry)
+{
+	const std::vector<ParticleVertex>& vertices = geometry.GetVertices();
+	for (size_t i = 0; i + 2 < vertices.size(); i += 3)
+	{
+		const ParticleVertex& a = vertices[i], & b = vertices[i + 1], & c = vertices[i + 2];
+		FillTriangle({ a.x, a.y }, { b.x, b.y }, { c.x, c.y }, { a.r, a.g, a.b, a.a });
+	}
+}
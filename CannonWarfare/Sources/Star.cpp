@@ -2,18 +2,19 @@
 #include "Arithmetic.h"
 using namespace Maths;
 
-Star::Star(const Maths::Vector2& _screenSize)
+Star::Star(const Maths::Vector2& _screenSize, Maths::Random& rng)
     : screenSize(_screenSize)
 {
     // Get a random position and radius for the star.
-    position = { (float)(rand() % (int)screenSize.x), (float)(rand() % (int)screenSize.y) };
-    radius   = rand() % 5 - 1; if (radius <= 0) radius = 1;
+    position = { (float)rng.RangeInt(0, (int)screenSize.x), (float)rng.RangeInt(0, (int)screenSize.y) };
+    radius   = rng.RangeInt(-1, 4); if (radius <= 0) radius = 1;
     velocity = { -20.f * radius, 0 };
+    prevPosition = position;
 
     // Get random red green and blue values.
-    float R = (rand() % 120 + 135) / 255.0f;
-    float G = (rand() % 120 + 135) / 255.0f;
-    float B = (rand() % 120 + 135) / 255.0f;
+    float R = rng.Range(135, 255) / 255.0f;
+    float G = rng.Range(135, 255) / 255.0f;
+    float B = rng.Range(135, 255) / 255.0f;
 
     // Make the color as white as possible.
     const float minVal = min(1-R, min(1-G, 1-B));
@@ -22,20 +23,28 @@ Star::Star(const Maths::Vector2& _screenSize)
     B += minVal;
 
     // Set the star's color.
-    color = { (unsigned char)(R * 255), (unsigned char)(G * 255), (unsigned char)(B * 255), 255 };
+    color = { (uint8_t)(R * 255), (uint8_t)(G * 255), (uint8_t)(B * 255), 255 };
 }
 
 void Star::Update(const float& deltaTime)
 {
     // Move the star according to its velocity.
-    position += velocity * deltaTime;
+    prevPosition = position;
+    position    += velocity * deltaTime;
 
-    // Screen wrapping.
-    if (position.x < 0.f)
-        position.x += screenSize.x;
+    // Screen wrapping (don't interpolate across the screen).
+    if (position.x < 0.f) {
+        position.x  += screenSize.x;
+        prevPosition = position;
+    }
 }
 
-void Star::Draw() const
+void Star::Draw(Canvas& canvas, const Maths::Vector2& drawPosition) const
 {
-    DrawCircle((int)position.x, (int)position.y, (float)radius, color);
+    canvas.DrawCircle(drawPosition, (float)radius, color);
+}
+
+Maths::Vector2 Star::GetDrawPosition(const float& alpha) const
+{
+    return prevPosition + (position - prevPosition) * alpha;
 }
@@ -1,46 +1,44 @@
 #include "App.h"
 #include <raylib.h>
-#include <chrono>
-#include <thread>
+#include "Random.h"
 #include <cstdlib>
+#include <cstring>
 #ifdef PLATFORM_WEB
     #include <emscripten/emscripten.h>
 #endif
-using namespace std::chrono;
 constexpr int targetFPS = 60;
 
 // Web update function.
 void UpdateAndDrawFrame()
 {
-    static App app({ 1728, 972 }, targetFPS);
+    static App app({ 1728, 972 }, targetFPS, Maths::MakeRandomSeed());
 
     // Main loop.
-    app.Update(1.f / GetFPS());
-    app.Draw();
+    app.Frame();
 }
 
 
-int main(void)
+int main(int argc, char** argv)
 {
     #ifdef PLATFORM_WEB
         emscripten_set_main_loop(UpdateAndDrawFrame, targetFPS, 1);
     #else
-        // Initialize variables.
-        std::srand(time(NULL));
-        App app({ -1, -1 }, targetFPS);
-        time_point<system_clock> loopTime = system_clock::now();
-
-        // Main loop.
-        while (!WindowShouldClose())
+        // Use the seed given with --seed to replay a run, or a new one.
+        // With --record, the session is recorded to a replay that the headless driver can play back.
+        uint64_t    replaySeed = Maths::MakeRandomSeed();
+        std::string recordPath;
+        for (int i = 1; i + 1 < argc; i++)
         {
-            if (GetFPS() > 0)
-                app.Update(1.f / GetFPS());
-            app.Draw();
-
-            // Limit loop duration to target delta time.
-            loopTime += milliseconds((int)(app.GetTargetDeltaTime() * 1000));
-            std::this_thread::sleep_until(loopTime);
+            if (strcmp(argv[i], "--seed") == 0)
+                replaySeed = std::strtoull(argv[i + 1], nullptr, 10);
+            else if (strcmp(argv[i], "--record") == 0)
+                recordPath = argv[i + 1];
         }
+        App app({ -1, -1 }, targetFPS, replaySeed, recordPath);
+
+        // Main loop (raylib waits at the end of each frame to keep the target FPS).
+        while (!WindowShouldClose())
+            app.Frame();
     #endif
     
     return 0;